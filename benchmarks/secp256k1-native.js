@@ -0,0 +1,236 @@
+const { execFileSync } = require('child_process')
+const path = require('path')
+const benchmark = require('benchmark')
+const fcrypto = require('../')
+const util = require('./util')
+
+// Native functions (src/fcrypto/bench.c, `make bench-native-build`) vs same
+// work through addon and WebAssembly, difference is cost of JavaScript layer:
+// argument checks, allocation of outputs, N-API / WebAssembly calls and
+// copies to WebAssembly memory. Can be changed with environment variables:
+// NATIVE=../build/bench/fcrypto-bench NAMES=ecdsa_verify,ecdh TIME=1000
+const native = process.env.NATIVE || '../build/bench/fcrypto-bench'
+const names = (process.env.NAMES || '').split(',').filter((x) => x)
+const time = parseInt(process.env.TIME || 1000, 10)
+
+const prng = util.createPRNG()
+function createFixtures (secp256k1) {
+  const fixtures = []
+  while (fixtures.length < 256) {
+    const seckey = prng.randomBytes(32)
+    if (!secp256k1.privateKeyVerify(seckey)) continue
+
+    const tweak = prng.randomBytes(32)
+    const msg32 = prng.randomBytes(32)
+    const msg = prng.randomBytes(256)
+    const pubkey = secp256k1.publicKeyCreate(seckey, true, Buffer.alloc)
+    const sig = secp256k1.ecdsaSign(msg32, seckey, Buffer.alloc)
+    const der = secp256k1.signatureExport(sig.signature, Buffer.alloc)
+    const msgsig = secp256k1.ecdsaSignMessage(msg, seckey, 'sha256')
+    const xonly = secp256k1.xOnlyPublicKeyCreate(seckey, Buffer.alloc)
+    const schnorrSig = secp256k1.schnorrSign(msg32, seckey, null, Buffer.alloc)
+
+    fixtures.push({
+      seckey,
+      tweak,
+      msg32,
+      msg,
+      pubkey,
+      sig,
+      der,
+      msgsig: msgsig.signature,
+      xonly,
+      schnorrSig,
+    })
+  }
+
+  return fixtures
+}
+
+// Records of bulk calls, same as in src/fcrypto/bench.c
+function createBulk (fixtures, size) {
+  const items = Array.from({ length: size }, (_, i) => fixtures[i % 256])
+  const concat = (fn) => Buffer.concat([].concat(...items.map(fn)))
+  return {
+    size,
+    seckeys: concat((f) => [f.seckey]),
+    sign: concat((f) => [f.msg32, f.seckey]),
+    verify: concat((f) => [f.sig.signature, f.msg32, f.pubkey]),
+    recover: concat((f) => [
+      f.sig.signature,
+      Buffer.from([f.sig.recid]),
+      f.msg32,
+    ]),
+    ecdh: concat((f) => [f.pubkey, f.seckey]),
+    pubkeys: concat((f) => [f.pubkey]),
+    msgs: items.map((f) => f.msg),
+    verifyMessage: concat((f) => [f.msgsig, f.pubkey]),
+    sigs: items.map((f) => f.schnorrSig),
+    msgs32: items.map((f) => f.msg32),
+    xonly: items.map((f) => f.xonly),
+  }
+}
+
+// Same work as functions of src/fcrypto/bench.c, keyed by native name.
+// Every function return closure for one call with fixture.
+const suites = {
+  context_randomize: (s) => (f) => s.contextRandomize(f.tweak),
+  seckey_verify: (s) => (f) => s.privateKeyVerify(f.seckey),
+  seckey_negate: (s) => (f) => s.privateKeyNegate(Buffer.from(f.seckey)),
+  seckey_tweak_add: (s) => (f) =>
+    s.privateKeyTweakAdd(Buffer.from(f.seckey), f.tweak),
+  seckey_tweak_mul: (s) => (f) =>
+    s.privateKeyTweakMul(Buffer.from(f.seckey), f.tweak),
+  pubkey_create: (s) => (f) => s.publicKeyCreate(f.seckey),
+  pubkey_convert: (s) => (f) => s.publicKeyConvert(f.pubkey, false),
+  pubkey_negate: (s) => (f) => s.publicKeyNegate(f.pubkey),
+  pubkey_combine: (s, fixtures) => {
+    let i = 0
+    return (f) => s.publicKeyCombine([f.pubkey, fixtures[++i % 256].pubkey])
+  },
+  pubkey_linear_combination: (s, fixtures) => {
+    const pubkeys = fixtures.slice(0, 16).map((f) => f.pubkey)
+    const scalars = fixtures.slice(0, 16).map((f) => f.tweak)
+    return (f) => s.publicKeyLinearCombination(pubkeys, scalars, f.tweak)
+  },
+  pubkey_tweak_add: (s) => (f) => s.publicKeyTweakAdd(f.pubkey, f.tweak),
+  pubkey_tweak_mul: (s) => (f) => s.publicKeyTweakMul(f.pubkey, f.tweak),
+  signature_normalize: (s) => (f) =>
+    s.signatureNormalize(Buffer.from(f.sig.signature)),
+  signature_export: (s) => (f) => s.signatureExport(f.sig.signature),
+  signature_import: (s) => (f) => s.signatureImport(f.der),
+  ecdsa_sign: (s) => (f) => s.ecdsaSign(f.msg32, f.seckey),
+  ecdsa_verify: (s) => (f) =>
+    s.ecdsaVerify(f.sig.signature, f.msg32, f.pubkey),
+  ecdsa_verify_parsed: (s, fixtures) => {
+    const parsed = new Map()
+    for (const f of fixtures) parsed.set(f, s.publicKeyParse(f.pubkey))
+    return (f) => s.ecdsaVerify(f.sig.signature, f.msg32, parsed.get(f))
+  },
+  ecdsa_sign_message: (s) => (f) => s.ecdsaSignMessage(f.msg, f.seckey),
+  ecdsa_verify_message: (s) => (f) =>
+    s.ecdsaVerifyMessage(f.msgsig, f.msg, f.pubkey),
+  verifier_init: (s) => (f) =>
+    s.ecdsaVerifierDestroy(s.ecdsaVerifierCreate(f.pubkey)),
+  ecdsa_verify_prepared: (s, fixtures) => {
+    const hot = fixtures.slice(0, 16)
+    const verifiers = hot.map((f) => s.ecdsaVerifierCreate(f.pubkey))
+    let i = 0
+    return () => {
+      const j = i++ % 16
+      s.ecdsaVerify(hot[j].sig.signature, hot[j].msg32, verifiers[j])
+    }
+  },
+  ecdsa_verify_batch: (s, fixtures) => {
+    const items = fixtures.slice(0, 64)
+    const sigs = items.map((f) => f.sig)
+    const msgs = items.map((f) => f.msg32)
+    const pubkeys = items.map((f) => f.pubkey)
+    return () => s.ecdsaVerifyBatch(sigs, msgs, pubkeys)
+  },
+  ecdsa_recover: (s) => (f) =>
+    s.ecdsaRecover(f.sig.signature, f.sig.recid, f.msg32),
+  ecdsa_recover_address: (s) => (f) =>
+    s.ecdsaRecoverAddress(f.sig.signature, f.sig.recid, f.msg32),
+  xonly_pubkey_create: (s) => (f) => s.xOnlyPublicKeyCreate(f.seckey),
+  xonly_pubkey_convert: (s) => (f) => s.xOnlyPublicKeyConvert(f.pubkey),
+  schnorr_sign: (s) => (f) => s.schnorrSign(f.msg32, f.seckey),
+  schnorr_verify: (s) => (f) =>
+    s.schnorrVerify(f.schnorrSig, f.msg32, f.xonly),
+  schnorr_verify_batch: (s, fixtures, bulk) => () =>
+    s.schnorrVerifyBatch(bulk.sigs, bulk.msgs32, bulk.xonly, 64),
+  ecdh: (s, fixtures) => {
+    let i = 0
+    return (f) => s.ecdh(f.pubkey, fixtures[++i % 256].seckey)
+  },
+  ecdh_mode: (s, fixtures) => {
+    let i = 0
+    return (f) => s.ecdh(f.pubkey, fixtures[++i % 256].seckey, undefined, 'x')
+  },
+  seckey_verify_many: (s, fixtures, bulk) => () =>
+    s.privateKeyVerifyMany(bulk.seckeys, bulk.size),
+  pubkey_create_many: (s, fixtures, bulk) => () =>
+    s.publicKeyCreateMany(bulk.seckeys, bulk.size),
+  pubkey_create_range: (s, fixtures, bulk) => (f) =>
+    s.publicKeyCreateRange(f.seckey, bulk.size),
+  ecdsa_sign_many: (s, fixtures, bulk) => () =>
+    s.ecdsaSignMany(bulk.sign, bulk.size),
+  ecdsa_verify_many: (s, fixtures, bulk) => () =>
+    s.ecdsaVerifyMany(bulk.verify, bulk.size),
+  ecdsa_sign_message_many: (s, fixtures, bulk) => () =>
+    s.ecdsaSignMessageMany(bulk.msgs, bulk.seckeys),
+  ecdsa_verify_message_many: (s, fixtures, bulk) => () =>
+    s.ecdsaVerifyMessageMany(bulk.msgs, bulk.verifyMessage),
+  ecdsa_recover_many: (s, fixtures, bulk) => () =>
+    s.ecdsaRecoverMany(bulk.recover, bulk.size),
+  ecdsa_recover_address_many: (s, fixtures, bulk) => () =>
+    s.ecdsaRecoverAddressMany(bulk.recover, bulk.size),
+  ecdh_many: (s, fixtures, bulk) => () => s.ecdhMany(bulk.ecdh, bulk.size),
+  ecdh_pubkeys_many: (s, fixtures, bulk) => (f) =>
+    s.ecdhPublicKeysMany(f.seckey, bulk.pubkeys, bulk.size),
+}
+
+// Nanoseconds per item, fixtures iterated same as in native benchmark
+function measure (fn, fixtures, items) {
+  let i = 0
+  const bench = benchmark(() => fn(fixtures[i++ % 256]), {
+    maxTime: time / 1e3,
+  })
+  bench.run()
+  if (bench.error) throw bench.error
+  return 1e9 / bench.hz / items
+}
+
+function format (ns) {
+  const digits = ns < 100 ? 2 : 0
+  return ns.toLocaleString('en-US', {
+    minimumFractionDigits: digits,
+    maximumFractionDigits: digits,
+  })
+}
+
+async function runBenchmark () {
+  const args = ['--json', `--time=${time}`, ...names]
+  const file = path.resolve(__dirname, native)
+  let results
+  try {
+    results = JSON.parse(execFileSync(file, args).toString())
+  } catch (err) {
+    console.error(`Can not run ${file}, build it with: make bench-native-build`)
+    throw err
+  }
+
+  const impls = {}
+  for (const name of ['addon', 'wasm']) {
+    const { secp256k1 } = await fcrypto.load(name, { secp256k1: true })
+    impls[`fcrypto/${name}`] = secp256k1
+  }
+
+  const fixtures = createFixtures(impls['fcrypto/addon'])
+  for (const result of results) {
+    const suite = suites[result.name]
+    if (suite === undefined) continue
+
+    const unit = result.items > 1 ? 'item' : 'op'
+    const bulk = createBulk(fixtures, result.items)
+    console.log(`Benchmarking: fcrypto_secp256k1_${result.name} (ns/${unit})`)
+    console.log('--------------------------------------------------')
+    console.log(`fcrypto/native x ${format(result.ns)}`)
+    for (const [name, secp256k1] of Object.entries(impls)) {
+      const fn = suite(secp256k1, fixtures, bulk)
+      const ns = measure(fn, fixtures, result.items)
+      const diff = ns - result.ns
+      const sign = diff >= 0 ? '+' : '-'
+      const ratio = (ns / result.ns).toFixed(2)
+      console.log(
+        `${name} x ${format(ns)} (${sign}${format(Math.abs(diff))}, ${ratio}x)`
+      )
+    }
+    console.log('==================================================')
+  }
+}
+
+runBenchmark().catch((err) => {
+  console.error(err.stack || err)
+  process.exit(1)
+})
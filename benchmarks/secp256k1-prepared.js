@@ -0,0 +1,96 @@
+const fcrypto = require('../')
+const util = require('./util')
+
+// Verification against few hot public keys: serialized key (parsed on every
+// call), parsed key (`publicKeyParse`) and prepared verifier
+// (`ecdsaVerifierCreate`). Number of keys can be changed with environment:
+// KEYS=16 node secp256k1-prepared.js
+const keysCount = parseInt(process.env.KEYS || 4, 10)
+const sigsPerKey = 256
+
+const prng = util.createPRNG()
+function createFixtures (secp256k1) {
+  const fixtures = []
+  while (fixtures.length < keysCount * sigsPerKey) {
+    const seckey = prng.randomBytes(32)
+    if (!secp256k1.privateKeyVerify(seckey)) continue
+
+    const pubkey = secp256k1.publicKeyCreate(seckey, true, Buffer.alloc)
+    for (let i = 0; i < sigsPerKey; ++i) {
+      const msg32 = prng.randomBytes(32)
+      const { signature } = secp256k1.ecdsaSign(msg32, seckey, Buffer.alloc)
+      fixtures.push({ pubkey, msg32, signature })
+    }
+  }
+
+  // Mix keys, like in real stream of transactions
+  const items = []
+  for (let i = 0; i < sigsPerKey; ++i) {
+    for (let j = 0; j < keysCount; ++j) {
+      items.push(fixtures[j * sigsPerKey + i])
+    }
+  }
+  return items
+}
+
+async function runBenchmark () {
+  const impls = {}
+  for (const name of ['addon', 'wasm']) {
+    const { secp256k1 } = await fcrypto.load(name, { secp256k1: true })
+    impls[`fcrypto/${name}`] = secp256k1
+  }
+
+  const fixtures = createFixtures(impls['fcrypto/addon'])
+  console.log(`Keys: ${keysCount}, signatures: ${fixtures.length}`)
+
+  const benches = []
+  for (const [name, secp256k1] of Object.entries(impls)) {
+    const keys = new Map()
+    for (const { pubkey } of fixtures) {
+      const key = pubkey.toString('hex')
+      if (keys.has(key)) continue
+
+      const ts = util.diffTime()
+      const verifier = secp256k1.ecdsaVerifierCreate(pubkey)
+      const time = util.diffTime(ts).toFixed(2)
+      console.log(`${name}: verifier for ${key} created in ${time}ms`)
+
+      keys.set(key, {
+        parsed: secp256k1.publicKeyParse(pubkey),
+        verifier,
+      })
+    }
+
+    const modes = {
+      serialized: ({ pubkey }) => pubkey,
+      parsed: ({ pubkey }) => keys.get(pubkey.toString('hex')).parsed,
+      prepared: ({ pubkey }) => keys.get(pubkey.toString('hex')).verifier,
+    }
+    for (const [mode, getKey] of Object.entries(modes)) {
+      const items = fixtures.map((fixture) => [
+        fixture.signature,
+        fixture.msg32,
+        getKey(fixture),
+      ])
+
+      benches.push({
+        name: `${name} (${mode})`,
+        fn: () => {
+          for (const [sig, msg32, key] of items) {
+            if (!secp256k1.ecdsaVerify(sig, msg32, key)) {
+              throw new Error('Invalid signature')
+            }
+          }
+        },
+      })
+    }
+  }
+
+  const name = 'secp256k1.ecdsaVerify with hot keys'
+  util.runSuite(name, benches, { batchSize: fixtures.length })
+}
+
+runBenchmark().catch((err) => {
+  console.error(err.stack || err)
+  process.exit(1)
+})
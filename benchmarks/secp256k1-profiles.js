@@ -0,0 +1,75 @@
+const fcrypto = require('../')
+const util = require('./util')
+
+// Sign / verify throughput and memory for build profile of precomputed tables
+// (see `secp256k1_profile` in Makefile). Only current build is measured, for
+// matrix build and run it for every profile:
+// for p in default sign-heavy verify-heavy small; do
+//   (cd .. && make build secp256k1_profile=$p) && node secp256k1-profiles.js
+// done
+const prng = util.createPRNG()
+function createFixtures (secp256k1) {
+  const fixtures = []
+  while (fixtures.length < 1000) {
+    const seckey = prng.randomBytes(32)
+    if (!secp256k1.privateKeyVerify(seckey)) continue
+
+    const pubkey = secp256k1.publicKeyCreate(seckey, true, Buffer.alloc)
+    const msg32 = prng.randomBytes(32)
+    const { signature } = secp256k1.ecdsaSign(msg32, seckey, Buffer.alloc)
+    fixtures.push({ seckey, pubkey, msg32, signature })
+  }
+
+  return fixtures
+}
+
+function formatKiB (bytes) {
+  return `${Math.round(bytes / 1024).toLocaleString('en-US')}KiB`
+}
+
+async function runBenchmark () {
+  const impls = {}
+  for (const name of ['addon', 'wasm']) {
+    const rss = process.memoryUsage().rss
+    const ts = util.diffTime()
+    const { secp256k1 } = await fcrypto.load(name, { secp256k1: true })
+    const time = util.diffTimePretty(ts)
+    const memory = formatKiB(process.memoryUsage().rss - rss)
+
+    const info = secp256k1.buildInfo()
+    const params = Object.entries(info).map(([key, value]) => {
+      return `${key}: ${key === 'contextSize' ? formatKiB(value) : value}`
+    })
+    console.log(`fcrypto/${name}: ${params.join(', ')}`)
+    console.log(`fcrypto/${name}: load + init in ${time}, rss +${memory}`)
+
+    impls[`fcrypto/${name}`] = secp256k1
+  }
+
+  const fixtures = createFixtures(impls['fcrypto/addon'])
+  const suites = {
+    ecdsaSign: (secp256k1, { msg32, seckey }) => {
+      secp256k1.ecdsaSign(msg32, seckey)
+    },
+    ecdsaVerify: (secp256k1, { signature, msg32, pubkey }) => {
+      secp256k1.ecdsaVerify(signature, msg32, pubkey)
+    },
+  }
+
+  for (const [suiteName, fn] of Object.entries(suites)) {
+    const benches = Object.entries(impls).map(([name, secp256k1]) => ({
+      name,
+      fn: () => {
+        for (const fixture of fixtures) fn(secp256k1, fixture)
+      },
+    }))
+
+    const name = `secp256k1.${suiteName}`
+    util.runSuite(name, benches, { batchSize: fixtures.length })
+  }
+}
+
+runBenchmark().catch((err) => {
+  console.error(err.stack || err)
+  process.exit(1)
+})
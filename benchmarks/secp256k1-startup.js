@@ -0,0 +1,75 @@
+const fcrypto = require('../')
+const wasm = require('../lib/wasm')
+const wasmBin = require('../lib/wasm/wasm-bin')
+const util = require('./util')
+
+// Time and RSS of secp256k1 initialization: first instance build context with
+// precomputed tables, next instances only clone it. Number of instances can
+// be changed with environment variable:
+// INSTANCES=16 node secp256k1-startup.js
+const instances = parseInt(process.env.INSTANCES || 8, 10)
+
+function formatKiB (bytes) {
+  return `${Math.round(bytes / 1024).toLocaleString('en-US')}KiB`
+}
+
+async function measure (type) {
+  const rss = process.memoryUsage().rss
+  const results = []
+  for (let i = 0; i < instances; ++i) {
+    // Every `load` create new objects, so every init create new instance
+    const { secp256k1 } = await fcrypto.load(type)
+
+    const ts = util.diffTime()
+    secp256k1.init()
+    results.push({ secp256k1, time: util.diffTime(ts) })
+  }
+
+  const [first, ...rest] = results.map(({ time }) => time)
+  const avg = rest.reduce((a, b) => a + b, 0) / Math.max(rest.length, 1)
+  console.log(`fcrypto/${type}`)
+  console.log(`  first init: ${first.toFixed(3)}ms`)
+  console.log(`  next inits: ${avg.toFixed(3)}ms (average of ${rest.length})`)
+  console.log(`  rss: +${formatKiB(process.memoryUsage().rss - rss)}`)
+
+  return results
+}
+
+// Compilation of WebAssembly file: from buffer (file read before compile),
+// streaming (compile while file is read) and cached module from loader, which
+// only instantiated by next instances (workers)
+async function measureCompile () {
+  const { variant } = await wasm.compile()
+  const name = variant === 'simd' ? 'fcrypto-simd' : 'fcrypto'
+
+  let ts = util.diffTime()
+  await WebAssembly.compile(await wasmBin(name))
+  console.log(`wasm/${variant} compile (buffer): ${util.diffTimePretty(ts)}`)
+
+  ts = util.diffTime()
+  await wasmBin.compile(name)
+  console.log(`wasm/${variant} compile (streaming): ${util.diffTimePretty(ts)}`)
+
+  ts = util.diffTime()
+  const { wasmModule } = await wasm.compile()
+  await wasm.instantiate(wasmModule, variant)
+  console.log(`wasm/${variant} cached module: ${util.diffTimePretty(ts)}`)
+}
+
+async function runBenchmark () {
+  console.log(`Instances: ${instances}`)
+  console.log(`Process rss: ${formatKiB(process.memoryUsage().rss)}`)
+  await measureCompile()
+
+  // Keep instances alive until end, otherwise GC can free context
+  const alive = []
+  for (const type of ['addon', 'wasm']) alive.push(await measure(type))
+
+  console.log(`Process rss: ${formatKiB(process.memoryUsage().rss)}`)
+  return alive
+}
+
+runBenchmark().catch((err) => {
+  console.error(err.stack || err)
+  process.exit(1)
+})
@@ -0,0 +1,130 @@
+const fcrypto = require('../')
+const util = require('./util')
+
+// Streaming verification (ecdsaVerifyStream): records arrive at fixed rate
+// (or as fast as possible), throughput and latency (from write to result) are
+// measured for every batch size / deadline pair. Baseline is ecdsaVerify
+// called for every record from stream handler. Can be changed with environment
+// variables:
+// RECORDS=20000 RATE=0 SETTINGS=64:5,256:10,1024:20 node secp256k1-stream.js
+// RATE is records per second (0 is unlimited).
+const count = parseInt(process.env.RECORDS || 20000, 10)
+const rate = parseInt(process.env.RATE || 0, 10)
+const settings = (process.env.SETTINGS || '1:0,16:1,64:5,256:10,1024:20')
+  .split(',')
+  .filter((x) => x)
+  .map((x) => x.split(':').map(Number))
+  .map(([batchSize, deadline]) => ({ batchSize, deadline }))
+
+const prng = util.createPRNG()
+function createFixtures (secp256k1) {
+  const records = []
+  while (records.length < 1000) {
+    const seckey = prng.randomBytes(32)
+    if (!secp256k1.privateKeyVerify(seckey)) continue
+
+    const msg32 = prng.randomBytes(32)
+    const { signature } = secp256k1.ecdsaSign(msg32, seckey, Buffer.alloc)
+    const pubkey = secp256k1.publicKeyCreate(seckey, true, Buffer.alloc)
+    records.push({ signature, msg32, pubkey })
+  }
+
+  return records
+}
+
+function percentile (sorted, p) {
+  return sorted[Math.min(sorted.length - 1, Math.floor(sorted.length * p))]
+}
+
+function report (name, latencies, time) {
+  const sorted = Float64Array.from(latencies).sort()
+  const hz = Math.round((count * 1e3) / time).toLocaleString('en-US')
+  const p50 = percentile(sorted, 0.5).toFixed(3)
+  const p99 = percentile(sorted, 0.99).toFixed(3)
+  console.log(`${name} x ${hz} records/sec, p50 ${p50}ms, p99 ${p99}ms`)
+}
+
+// Records written with respect to backpressure, start time of record taken
+// before write, so time in writable buffer is part of latency
+async function measure (createStream, fixtures) {
+  const starts = new Float64Array(count)
+  const latencies = new Float64Array(count)
+  const ts = util.diffTime()
+  const stream = createStream()
+
+  let received = 0
+  const finished = new Promise((resolve, reject) => {
+    stream.on('data', ({ record }) => {
+      latencies[record.index] = util.diffTime(ts) - starts[record.index]
+      received += 1
+    })
+    stream.on('end', resolve)
+    stream.on('error', reject)
+  })
+
+  for (let i = 0; i < count; ++i) {
+    if (rate > 0) {
+      const wait = (i * 1e3) / rate - util.diffTime(ts)
+      if (wait > 1) await new Promise((resolve) => setTimeout(resolve, wait))
+    }
+
+    const record = Object.assign({ index: i }, fixtures[i % fixtures.length])
+    starts[i] = util.diffTime(ts)
+    if (!stream.write(record)) {
+      await new Promise((resolve) => stream.once('drain', resolve))
+    }
+  }
+  stream.end()
+  await finished
+
+  if (received !== count) throw new Error('Not all records verified')
+  return { latencies, time: util.diffTime(ts) }
+}
+
+// Baseline: ecdsaVerify in handler of every record
+function createBaseline (secp256k1) {
+  const { Transform } = require('stream')
+  return () =>
+    new Transform({
+      objectMode: true,
+      transform (record, encoding, callback) {
+        const { signature, msg32, pubkey } = record
+        const valid = secp256k1.ecdsaVerify(signature, msg32, pubkey)
+        callback(null, { record, valid })
+      },
+    })
+}
+
+async function runBenchmark () {
+  const impls = {}
+  for (const name of ['addon', 'wasm']) {
+    const { secp256k1 } = await fcrypto.load(name, { secp256k1: true })
+    impls[`fcrypto/${name}`] = secp256k1
+  }
+
+  const fixtures = createFixtures(impls['fcrypto/addon'])
+  const rateText = rate > 0 ? `${rate} records/sec` : 'unlimited rate'
+  console.log(`Records: ${count}, ${rateText}`)
+
+  for (const [name, secp256k1] of Object.entries(impls)) {
+    console.log(`Benchmarking: ${name}.ecdsaVerifyStream`)
+    console.log('--------------------------------------------------')
+
+    const baseline = await measure(createBaseline(secp256k1), fixtures)
+    report('ecdsaVerify per record', baseline.latencies, baseline.time)
+
+    for (const options of settings) {
+      const { batchSize, deadline } = options
+      const createStream = () => secp256k1.ecdsaVerifyStream(options)
+      const { latencies, time } = await measure(createStream, fixtures)
+      report(`batch ${batchSize}, deadline ${deadline}ms`, latencies, time)
+    }
+
+    console.log('==================================================')
+  }
+}
+
+runBenchmark().catch((err) => {
+  console.error(err.stack || err)
+  process.exit(1)
+})
@@ -0,0 +1,109 @@
+const os = require('os')
+const fcrypto = require('../')
+const util = require('./util')
+
+// Scaling of bulk functions over threads: native pool in addon and
+// worker_threads in WebAssembly (only verify and recover).
+// Batch size and list of threads can be changed with environment variables:
+// BATCH_SIZE=4096 THREADS=1,2,4,8,16 node secp256k1-threads.js
+const batchSize = parseInt(process.env.BATCH_SIZE || 4096, 10)
+const threadsList = (process.env.THREADS || '1,2,4,8,12,16')
+  .split(',')
+  .filter((x) => x)
+  .map(Number)
+
+const prng = util.createPRNG()
+function createFixtures (secp256k1) {
+  const seckeys = []
+  while (seckeys.length < batchSize) {
+    const seckey = prng.randomBytes(32)
+    if (secp256k1.privateKeyVerify(seckey)) seckeys.push(seckey)
+  }
+
+  const pubkeys = seckeys.map((seckey) => secp256k1.publicKeyCreate(seckey))
+  const msgs32 = seckeys.map(() => prng.randomBytes(32))
+  const sigs = seckeys.map((seckey, i) => secp256k1.ecdsaSign(msgs32[i], seckey))
+
+  const verify = []
+  const recover = []
+  const ecdh = []
+  for (let i = 0; i < batchSize; ++i) {
+    const { signature, recid } = sigs[i]
+    verify.push(signature, msgs32[i], pubkeys[i])
+    recover.push(signature, Buffer.from([recid]), msgs32[i])
+    ecdh.push(pubkeys[(i + 1) % batchSize], seckeys[i])
+  }
+
+  return {
+    seckeys: Buffer.concat(seckeys),
+    verify: Buffer.concat(verify),
+    recover: Buffer.concat(recover),
+    ecdh: Buffer.concat(ecdh),
+  }
+}
+
+async function runBenchmark () {
+  const impls = {}
+  for (const name of ['addon', 'wasm']) {
+    const { secp256k1 } = await fcrypto.load(name, { secp256k1: true })
+    impls[`fcrypto/${name}`] = secp256k1
+  }
+
+  const ts = util.diffTime()
+  const fixtures = createFixtures(impls['fcrypto/addon'])
+  console.log(`Create ${batchSize} fixtures in ${util.diffTimePretty(ts)}`)
+  console.log(`CPU cores: ${os.cpus().length}`)
+
+  const output = new Uint8Array(batchSize * 33)
+  const suites = {
+    publicKeyCreateMany: (secp256k1, threads) => {
+      secp256k1.publicKeyCreateMany(
+        fixtures.seckeys,
+        batchSize,
+        true,
+        output,
+        threads
+      )
+    },
+    ecdsaVerifyMany: (secp256k1, threads) => {
+      secp256k1.ecdsaVerifyMany(fixtures.verify, batchSize, true, threads)
+    },
+    ecdsaRecoverMany: (secp256k1, threads) => {
+      secp256k1.ecdsaRecoverMany(
+        fixtures.recover,
+        batchSize,
+        true,
+        output,
+        threads
+      )
+    },
+    ecdhMany: (secp256k1, threads) => {
+      secp256k1.ecdhMany(fixtures.ecdh, batchSize, true, output, threads)
+    },
+  }
+  // WebAssembly ignore threads for functions with secret keys
+  const wasmSuites = ['ecdsaVerifyMany', 'ecdsaRecoverMany']
+
+  for (const [suiteName, fn] of Object.entries(suites)) {
+    const benches = []
+    for (const [name, secp256k1] of Object.entries(impls)) {
+      const isWasm = name === 'fcrypto/wasm'
+      for (const threads of threadsList) {
+        if (isWasm && threads > 1 && !wasmSuites.includes(suiteName)) break
+
+        benches.push({
+          name: `${name} (threads: ${threads})`,
+          fn: () => fn(secp256k1, threads),
+        })
+      }
+    }
+
+    const name = `secp256k1.${suiteName} (batch size: ${batchSize})`
+    util.runSuite(name, benches, { batchSize })
+  }
+}
+
+runBenchmark().catch((err) => {
+  console.error(err.stack || err)
+  process.exit(1)
+})
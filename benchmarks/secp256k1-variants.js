@@ -0,0 +1,80 @@
+const fcrypto = require('../')
+const util = require('./util')
+
+// Sign / verify throughput of addon variants for CPU features (see
+// `addon_variant` in binding.gyp). Variant selected by loader from
+// FCRYPTO_ADDON_VARIANT, variants which are not built or not supported by CPU
+// are skipped.
+const prng = util.createPRNG()
+function createFixtures (secp256k1) {
+  const fixtures = []
+  while (fixtures.length < 1000) {
+    const seckey = prng.randomBytes(32)
+    if (!secp256k1.privateKeyVerify(seckey)) continue
+
+    const pubkey = secp256k1.publicKeyCreate(seckey, true, Buffer.alloc)
+    const msg32 = prng.randomBytes(32)
+    const sig = secp256k1.ecdsaSign(msg32, seckey, Buffer.alloc)
+    fixtures.push({ seckey, pubkey, msg32, sig })
+  }
+
+  return fixtures
+}
+
+async function runBenchmark () {
+  const impls = {}
+  for (const variant of ['baseline', 'bmi2', 'avx2']) {
+    process.env.FCRYPTO_ADDON_VARIANT = variant
+    const { secp256k1 } = await fcrypto.load('addon', { secp256k1: true })
+
+    const loaded = secp256k1.buildInfo().variant
+    if (loaded !== variant) {
+      console.log(`fcrypto/addon-${variant}: not available, skipped`)
+      continue
+    }
+
+    impls[`fcrypto/addon-${variant}`] = secp256k1
+  }
+  delete process.env.FCRYPTO_ADDON_VARIANT
+
+  const fixtures = createFixtures(impls['fcrypto/addon-baseline'])
+  const suites = {
+    publicKeyCreate: (secp256k1, { seckey }) => {
+      secp256k1.publicKeyCreate(seckey)
+    },
+    ecdsaSign: (secp256k1, { msg32, seckey }) => {
+      secp256k1.ecdsaSign(msg32, seckey)
+    },
+    ecdsaVerify: (secp256k1, { sig, msg32, pubkey }) => {
+      secp256k1.ecdsaVerify(sig.signature, msg32, pubkey)
+    },
+  }
+
+  for (const [suiteName, fn] of Object.entries(suites)) {
+    const benches = Object.entries(impls).map(([name, secp256k1]) => ({
+      name,
+      fn: () => {
+        for (const fixture of fixtures) fn(secp256k1, fixture)
+      },
+    }))
+
+    const name = `secp256k1.${suiteName}`
+    util.runSuite(name, benches, { batchSize: fixtures.length })
+  }
+
+  // batch path: one multi-scalar multiplication for all items
+  const sigs = fixtures.map(({ sig }) => sig)
+  const msgs = fixtures.map(({ msg32 }) => msg32)
+  const pubkeys = fixtures.map(({ pubkey }) => pubkey)
+  const benches = Object.entries(impls).map(([name, secp256k1]) => ({
+    name,
+    fn: () => secp256k1.ecdsaVerifyBatch(sigs, msgs, pubkeys),
+  }))
+  const name = 'secp256k1.ecdsaVerifyBatch'
+  util.runSuite(name, benches, { batchSize: fixtures.length })
+}
+
+runBenchmark().catch((err) => {
+  console.error(err.stack || err)
+  process.exit(1)
+})
@@ -1,3 +1,4 @@
+const { createHash, createHmac } = require('crypto')
 const fcrypto = require('../')
 const util = require('./util')
 
@@ -13,8 +14,10 @@ function createFixtures (secp256k1) {
     const pubkey = secp256k1.publicKeyCreate(seckey, true, Buffer.alloc)
     const msg32 = prng.randomBytes(32)
     const sig = secp256k1.ecdsaSign(msg32, seckey, Buffer.alloc)
+    const xonly = secp256k1.xOnlyPublicKeyCreate(seckey, Buffer.alloc)
+    const schnorrSig = secp256k1.schnorrSign(msg32, seckey, null, Buffer.alloc)
 
-    fixtures.push({ seckey, pubkey, msg32, sig })
+    fixtures.push({ seckey, pubkey, msg32, sig, xonly, schnorrSig })
   }
 
   return fixtures
@@ -106,6 +109,388 @@ async function runBenchmark () {
   runSuite('ecdh', (secp256k1, fixture) => {
     secp256k1.ecdh(fixture.pubkey, fixture.seckey)
   })
+
+  // batch verification vs loop with ecdsaVerify, only for fcrypto
+  for (const size of [1, 16, 256, 4096]) {
+    const items = Array.from({ length: size }, (_, i) => fixtures[i % 1000])
+    const sigs = items.map((fixture) => fixture.sig)
+    const msgs = items.map((fixture) => fixture.msg32)
+    const pubkeys = items.map((fixture) => fixture.pubkey)
+
+    const benches = []
+    for (const [name, secp256k1] of Object.entries(impls)) {
+      if (!secp256k1 || !name.startsWith('fcrypto/')) continue
+
+      benches.push({
+        name: `${name} (batch)`,
+        fn: () => secp256k1.ecdsaVerifyBatch(sigs, msgs, pubkeys),
+      })
+      benches.push({
+        name: `${name} (loop)`,
+        fn: () => {
+          for (let i = 0; i < size; ++i) {
+            secp256k1.ecdsaVerify(sigs[i].signature, msgs[i], pubkeys[i])
+          }
+        },
+      })
+    }
+
+    const suiteName = `secp256k1.ecdsaVerifyBatch (batch size: ${size})`
+    util.runSuite(suiteName, benches, { batchSize: size })
+  }
+
+  // Schnorr (BIP340) vs ECDSA, only for fcrypto
+  const fcryptoImpls = Object.entries(impls).filter(([name, secp256k1]) => {
+    return secp256k1 && name.startsWith('fcrypto/')
+  })
+  const schnorrSuites = {
+    sign: {
+      ecdsa: (secp256k1, fixture) => {
+        secp256k1.ecdsaSign(fixture.msg32, fixture.seckey)
+      },
+      schnorr: (secp256k1, fixture) => {
+        secp256k1.schnorrSign(fixture.msg32, fixture.seckey)
+      },
+    },
+    verify: {
+      ecdsa: (secp256k1, { sig, msg32, pubkey }) => {
+        secp256k1.ecdsaVerify(sig.signature, msg32, pubkey)
+      },
+      schnorr: (secp256k1, { schnorrSig, msg32, xonly }) => {
+        secp256k1.schnorrVerify(schnorrSig, msg32, xonly)
+      },
+    },
+  }
+  for (const [suiteName, fns] of Object.entries(schnorrSuites)) {
+    const benches = []
+    for (const [name, secp256k1] of fcryptoImpls) {
+      for (const [type, testFn] of Object.entries(fns)) {
+        const fn = fixturesWrapper((fixture) => testFn(secp256k1, fixture))
+        const options = benchmarkOptions
+        benches.push({ name: `${name} (${type})`, fn, options })
+      }
+    }
+
+    util.runSuite(`secp256k1.schnorr ${suiteName} vs ecdsa`, benches)
+  }
+
+  // Schnorr batch verification: groups of 64 and one group vs ECDSA batch and
+  // loop with schnorrVerify
+  for (const size of [1, 16, 256, 4096]) {
+    const items = Array.from({ length: size }, (_, i) => fixtures[i % 1000])
+    const sigs = items.map((fixture) => fixture.schnorrSig)
+    const msgs = items.map((fixture) => fixture.msg32)
+    const pubkeys = items.map((fixture) => fixture.xonly)
+    const ecdsaSigs = items.map((fixture) => fixture.sig)
+    const ecdsaPubkeys = items.map((fixture) => fixture.pubkey)
+
+    const benches = []
+    for (const [name, secp256k1] of fcryptoImpls) {
+      benches.push({
+        name: `${name} (batch, groups of 64)`,
+        fn: () => secp256k1.schnorrVerifyBatch(sigs, msgs, pubkeys, 64),
+      })
+      benches.push({
+        name: `${name} (batch, one group)`,
+        fn: () => secp256k1.schnorrVerifyBatch(sigs, msgs, pubkeys, 0),
+      })
+      benches.push({
+        name: `${name} (loop)`,
+        fn: () => {
+          for (let i = 0; i < size; ++i) {
+            secp256k1.schnorrVerify(sigs[i], msgs[i], pubkeys[i])
+          }
+        },
+      })
+      benches.push({
+        name: `${name} (ecdsa batch)`,
+        fn: () => secp256k1.ecdsaVerifyBatch(ecdsaSigs, msgs, ecdsaPubkeys),
+      })
+    }
+
+    const suiteName = `secp256k1.schnorrVerifyBatch (batch size: ${size})`
+    util.runSuite(suiteName, benches, { batchSize: size })
+  }
+
+  // bulk key generation: loop with publicKeyCreate, publicKeyCreateMany
+  // (shared inversion) and publicKeyCreateRange (additions of G), only for
+  // fcrypto
+  {
+    const size = 1024
+    const seckeys = Buffer.concat(
+      Array.from({ length: size }, (_, i) => fixtures[i % 1000].seckey)
+    )
+    const start = fixtures[0].seckey
+
+    const benches = []
+    for (const [name, secp256k1] of Object.entries(impls)) {
+      if (!secp256k1 || !name.startsWith('fcrypto/')) continue
+
+      benches.push({
+        name: `${name} (loop)`,
+        fn: () => {
+          for (let i = 0; i < size; ++i) {
+            secp256k1.publicKeyCreate(seckeys.subarray(i * 32, (i + 1) * 32))
+          }
+        },
+      })
+      benches.push({
+        name: `${name} (many)`,
+        fn: () => secp256k1.publicKeyCreateMany(seckeys, size),
+      })
+      benches.push({
+        name: `${name} (range)`,
+        fn: () => secp256k1.publicKeyCreateRange(start, size),
+      })
+    }
+
+    const suiteName = `secp256k1.publicKeyCreate (keys: ${size})`
+    util.runSuite(suiteName, benches, { batchSize: size })
+  }
+
+  // BIP32 public children of account xpub: loop with HMAC in JS and
+  // publicKeyTweakAdd (parse and serialize on every child) and
+  // bip32DeriveRange, only for fcrypto
+  {
+    const size = 1024
+    const chain = prng.randomBytes(32)
+    const parent = fixtures[0].pubkey
+    const xpub = Buffer.concat([chain, parent])
+
+    const benches = []
+    for (const [name, secp256k1] of Object.entries(impls)) {
+      if (!secp256k1 || !name.startsWith('fcrypto/')) continue
+
+      benches.push({
+        name: `${name} (loop)`,
+        fn: () => {
+          const data = Buffer.alloc(37)
+          parent.copy(data)
+          for (let i = 0; i < size; ++i) {
+            data.writeUInt32BE(i, 33)
+            const I = createHmac('sha512', chain).update(data).digest()
+            secp256k1.publicKeyTweakAdd(parent, I.subarray(0, 32))
+          }
+        },
+      })
+      benches.push({
+        name: `${name} (range)`,
+        fn: () => secp256k1.bip32DeriveRange(xpub, 0, size),
+      })
+    }
+
+    const suiteName = `secp256k1.bip32DeriveRange (children: ${size})`
+    util.runSuite(suiteName, benches, { batchSize: size })
+  }
+
+  // address of signer: ecdsaRecover with hash160 in JS, ecdsaRecoverAddress
+  // (hashes in native code, key is not serialized to JS) and
+  // ecdsaRecoverAddressMany, only for fcrypto
+  {
+    const size = 1024
+    const items = Array.from({ length: size }, (_, i) => fixtures[i % 1000])
+    const inputs = Buffer.concat(
+      [].concat(
+        ...items.map(({ sig, msg32 }) => [
+          sig.signature,
+          Buffer.from([sig.recid]),
+          msg32,
+        ])
+      )
+    )
+
+    const benches = []
+    for (const [name, secp256k1] of Object.entries(impls)) {
+      if (!secp256k1 || !name.startsWith('fcrypto/')) continue
+
+      benches.push({
+        name: `${name} (recover + js hash)`,
+        fn: () => {
+          for (const { sig, msg32 } of items) {
+            const { signature, recid } = sig
+            const pubkey = secp256k1.ecdsaRecover(signature, recid, msg32)
+            const sha256 = createHash('sha256').update(pubkey).digest()
+            createHash('ripemd160').update(sha256).digest()
+          }
+        },
+      })
+      benches.push({
+        name: `${name} (fused)`,
+        fn: () => {
+          for (const { sig, msg32 } of items) {
+            secp256k1.ecdsaRecoverAddress(
+              sig.signature,
+              sig.recid,
+              msg32,
+              'hash160'
+            )
+          }
+        },
+      })
+      benches.push({
+        name: `${name} (many)`,
+        fn: () => secp256k1.ecdsaRecoverAddressMany(inputs, size, 'hash160'),
+      })
+    }
+
+    const suiteName = `secp256k1.ecdsaRecoverAddress (signatures: ${size})`
+    util.runSuite(suiteName, benches, { batchSize: size })
+  }
+
+  // raw messages: sha256 in Node.js + ecdsaVerify, ecdsaVerifyMessage (hash in
+  // native code) and ecdsaVerifyMessageMany, only for fcrypto
+  {
+    const size = 1024
+    const seckey = fixtures[0].seckey
+    const pubkey = fixtures[0].pubkey
+    const messages = Array.from({ length: size }, () => prng.randomBytes(256))
+
+    const benches = []
+    for (const [name, secp256k1] of Object.entries(impls)) {
+      if (!secp256k1 || !name.startsWith('fcrypto/')) continue
+
+      const sigs = messages.map((msg) => {
+        return secp256k1.ecdsaSignMessage(msg, seckey).signature
+      })
+      const inputs = Buffer.concat(
+        [].concat(...sigs.map((sig) => [sig, pubkey]))
+      )
+
+      benches.push({
+        name: `${name} (js hash)`,
+        fn: () => {
+          for (let i = 0; i < size; ++i) {
+            const msg32 = createHash('sha256').update(messages[i]).digest()
+            secp256k1.ecdsaVerify(sigs[i], msg32, pubkey)
+          }
+        },
+      })
+      benches.push({
+        name: `${name} (message)`,
+        fn: () => {
+          for (let i = 0; i < size; ++i) {
+            secp256k1.ecdsaVerifyMessage(sigs[i], messages[i], pubkey)
+          }
+        },
+      })
+      benches.push({
+        name: `${name} (many)`,
+        fn: () => secp256k1.ecdsaVerifyMessageMany(messages, inputs),
+      })
+    }
+
+    const suiteName = `secp256k1.ecdsaVerifyMessage (messages: ${size})`
+    util.runSuite(suiteName, benches, { batchSize: size })
+  }
+
+  // handshakes of server: one private key and many public keys, loop with
+  // ecdh and ecdhPublicKeysMany (shared inversion), only for fcrypto
+  {
+    const size = 1024
+    const seckey = fixtures[0].seckey
+    const pubkeys = Array.from({ length: size }, (_, i) => {
+      return fixtures[i % 1000].pubkey
+    })
+    const inputs = Buffer.concat(pubkeys)
+
+    const benches = []
+    for (const [name, secp256k1] of Object.entries(impls)) {
+      if (!secp256k1 || !name.startsWith('fcrypto/')) continue
+
+      benches.push({
+        name: `${name} (loop)`,
+        fn: () => {
+          for (const pubkey of pubkeys) secp256k1.ecdh(pubkey, seckey)
+        },
+      })
+      benches.push({
+        name: `${name} (many)`,
+        fn: () => secp256k1.ecdhPublicKeysMany(seckey, inputs, size),
+      })
+    }
+
+    const suiteName = `secp256k1.ecdhPublicKeysMany (keys: ${size})`
+    util.runSuite(suiteName, benches, { batchSize: size })
+  }
+
+  // combine, temporary arrays allocated from instance arena, only for fcrypto
+  for (const size of [2, 16, 256]) {
+    const pubkeys = fixtures.slice(0, size).map((fixture) => fixture.pubkey)
+
+    const benches = []
+    for (const [name, secp256k1] of Object.entries(impls)) {
+      if (!secp256k1 || !name.startsWith('fcrypto/')) continue
+
+      benches.push({ name, fn: () => secp256k1.publicKeyCombine(pubkeys) })
+    }
+
+    util.runSuite(`secp256k1.publicKeyCombine (keys: ${size})`, benches)
+  }
+
+  // linear combination: one multi-scalar multiplication vs tweakMul for every
+  // key and combine, only for fcrypto
+  for (const size of [2, 16, 128, 1024]) {
+    const pubkeys = []
+    const scalars = []
+    for (let i = 0; i < size; ++i) {
+      pubkeys.push(fixtures[i % fixtures.length].pubkey)
+      scalars.push(fixtures[(i + 1) % fixtures.length].seckey)
+    }
+
+    const benches = []
+    for (const [name, secp256k1] of Object.entries(impls)) {
+      if (!secp256k1 || !name.startsWith('fcrypto/')) continue
+
+      benches.push({
+        name,
+        fn: () => secp256k1.publicKeyLinearCombination(pubkeys, scalars),
+      })
+      benches.push({
+        name: `${name} (naive)`,
+        fn: () => {
+          const terms = pubkeys.map((pubkey, i) => {
+            return secp256k1.publicKeyTweakMul(pubkey, scalars[i])
+          })
+          return secp256k1.publicKeyCombine(terms)
+        },
+      })
+    }
+
+    const suiteName = `secp256k1.publicKeyLinearCombination (keys: ${size})`
+    util.runSuite(suiteName, benches)
+  }
+
+  // concurrency mode for async methods, for example: CONCURRENCY=1,4,16
+  const concurrencies = (process.env.CONCURRENCY || '').split(',')
+  for (const concurrency of concurrencies.filter((x) => x).map(Number)) {
+    const runConcurrent = async (suiteName, testFn) => {
+      const benches = []
+      for (const [name, secp256k1] of Object.entries(impls)) {
+        if (!secp256k1 || !name.startsWith('fcrypto/')) continue
+
+        const fn = (i) => testFn(secp256k1, fixtures[i % fixtures.length])
+        benches.push({ name, fn })
+      }
+
+      const name = `secp256k1.${suiteName}`
+      await util.runConcurrent(name, benches, { concurrency })
+    }
+
+    await runConcurrent('ecdsaSignAsync', (secp256k1, fixture) => {
+      return secp256k1.ecdsaSignAsync(fixture.msg32, fixture.seckey)
+    })
+    await runConcurrent('ecdsaVerifyAsync', (secp256k1, fixture) => {
+      const { signature } = fixture.sig
+      return secp256k1.ecdsaVerifyAsync(signature, fixture.msg32, fixture.pubkey)
+    })
+    await runConcurrent('ecdsaRecoverAsync', (secp256k1, fixture) => {
+      const { signature, recid } = fixture.sig
+      return secp256k1.ecdsaRecoverAsync(signature, recid, fixture.msg32)
+    })
+    await runConcurrent('ecdhAsync', (secp256k1, fixture) => {
+      return secp256k1.ecdhAsync(fixture.pubkey, fixture.seckey)
+    })
+  }
 }
 
 runBenchmark().catch((err) => {
@@ -21,14 +21,24 @@ function diffTimePretty (time) {
   return prettyMs(diffTime(time))
 }
 
-function runSuite (name, benches) {
+// For batch functions one call process `batchSize` items, so we print items/sec
+function formatCycle (bench, batchSize) {
+  if (batchSize === undefined) return String(bench)
+
+  const hz = Math.round(bench.hz * batchSize).toLocaleString('en-US')
+  const rme = bench.stats.rme.toFixed(2)
+  const runs = bench.stats.sample.length
+  return `${bench.name} x ${hz} items/sec ±${rme}% (${runs} runs sampled)`
+}
+
+function runSuite (name, benches, { batchSize } = {}) {
   const suite = new benchmark.Suite(name, {
     onStart () {
       console.log(`Benchmarking: ${name}`)
       console.log('--------------------------------------------------')
     },
     onCycle (event) {
-      console.log(String(event.target))
+      console.log(formatCycle(event.target, batchSize))
     },
     onError (event) {
       console.error(event.target.error)
@@ -45,9 +55,30 @@ function runSuite (name, benches) {
   suite.run()
 }
 
+// Keep `concurrency` async calls in flight during `duration` ms
+async function runConcurrent (name, benches, { concurrency, duration = 3000 }) {
+  console.log(`Benchmarking: ${name} (in flight: ${concurrency})`)
+  console.log('--------------------------------------------------')
+
+  for (const { name, fn } of benches) {
+    let ops = 0
+    const ts = diffTime()
+    const worker = async () => {
+      while (diffTime(ts) < duration) await fn(ops++)
+    }
+    await Promise.all(Array.from({ length: concurrency }, worker))
+
+    const hz = Math.round((ops * 1e3) / diffTime(ts)).toLocaleString('en-US')
+    console.log(`${name} x ${hz} ops/sec`)
+  }
+
+  console.log('==================================================')
+}
+
 module.exports = {
   createPRNG,
   diffTime,
   diffTimePretty,
   runSuite,
+  runConcurrent,
 }
@@ -1,4 +1,18 @@
 {
+  'variables': {
+    # Size of precomputed tables in libsecp256k1, see `conditions` of
+    # secp256k1 target. Can be changed on configure step:
+    # node-gyp configure -- -Dsecp256k1_profile=sign-heavy
+    'secp256k1_profile%': 'default',
+    # Instruction set of field and scalar arithmetic, only for x64 (not
+    # Windows). Every variant is separate addon (addon-<variant>.node, except
+    # baseline), loader select best supported by CPU (see lib/addon):
+    #   baseline: x86_64 assembly for any x64 CPU
+    #   bmi2:     C with __int128 compiled for MULX / ADCX / ADOX
+    #   avx2:     same as bmi2, plus loops auto-vectorized with AVX2
+    # node-gyp configure -- -Daddon_variant=bmi2
+    'addon_variant%': 'baseline',
+  },
   'target_default': {
     'cflags': [
       '-Wall',
@@ -9,10 +23,13 @@
     {
       'target_name': 'secp256k1',
       'type': 'static_library',
+      # Library compiled through our file with extensions, because they need
+      # access to internal functions. See src/fcrypto/secp256k1_ext.c
       'sources': [
-        'src/secp256k1/src/secp256k1.c',
+        'src/fcrypto/secp256k1_ext.c',
       ],
       'include_dirs': [
+        'src',
         'src/secp256k1',
         'src/secp256k1/src',
       ],
@@ -31,9 +48,8 @@
         # 'DETERMINISTIC=1',
         #
         # For all available definitions, see src/basic-config.h
-        # Current default values for desktop (544002c at 24.11.2019)
-        'ECMULT_GEN_PREC_BITS=4',
-        'ECMULT_WINDOW_SIZE=15',
+        # ECMULT_GEN_PREC_BITS and ECMULT_WINDOW_SIZE defined by profile
+        #
         # Activate modules
         'ENABLE_MODULE_ECDH=1',
         'ENABLE_MODULE_RECOVERY=1',
@@ -45,13 +61,59 @@
         'USE_SCALAR_INV_BUILTIN=1',
       ],
       'conditions': [
+        # Generator table for signing (ECMULT_GEN_PREC_BITS, 2/4/8) takes
+        # (256 / bits) * 2^bits * 64 bytes, table for verification
+        # (ECMULT_WINDOW_SIZE) 2^(size - 2) * 64 * 2 bytes (with endomorphism)
+        # Current default values for desktop (544002c at 24.11.2019)
+        ['secp256k1_profile=="default"', {
+          'defines': [
+            'ECMULT_GEN_PREC_BITS=4',  # 64KiB
+            'ECMULT_WINDOW_SIZE=15',  # 1MiB
+          ],
+        }],
+        ['secp256k1_profile=="sign-heavy"', {
+          'defines': [
+            'ECMULT_GEN_PREC_BITS=8',  # 512KiB
+            'ECMULT_WINDOW_SIZE=15',  # 1MiB
+          ],
+        }],
+        ['secp256k1_profile=="verify-heavy"', {
+          'defines': [
+            'ECMULT_GEN_PREC_BITS=4',  # 64KiB
+            'ECMULT_WINDOW_SIZE=17',  # 4MiB
+          ],
+        }],
+        ['secp256k1_profile=="small"', {
+          'defines': [
+            'ECMULT_GEN_PREC_BITS=2',  # 32KiB
+            'ECMULT_WINDOW_SIZE=8',  # 8KiB
+          ],
+        }],
         ['target_arch=="x64" and OS!="win"', {
           'defines': [
             'HAVE___INT128=1',
-            'USE_ASM_X86_64=1',
             'USE_FIELD_5X52=1',
             'USE_SCALAR_4X64=1',
-          ]
+          ],
+          'conditions': [
+            ['addon_variant=="baseline"', {
+              'defines': [
+                'USE_ASM_X86_64=1',
+              ],
+            }],
+            ['addon_variant=="bmi2"', {
+              'cflags': ['-mbmi2', '-madx'],
+              'xcode_settings': {
+                'OTHER_CFLAGS': ['-mbmi2', '-madx'],
+              },
+            }],
+            ['addon_variant=="avx2"', {
+              'cflags': ['-mbmi2', '-madx', '-mavx2'],
+              'xcode_settings': {
+                'OTHER_CFLAGS': ['-mbmi2', '-madx', '-mavx2'],
+              },
+            }],
+          ],
         }, {
           'defines': [
             'USE_FIELD_10X26=1',
@@ -63,6 +125,9 @@
       'target_name': 'fcrypto',
       'type': 'static_library',
       'sources': [
+        'src/fcrypto/arena.c',
+        'src/fcrypto/bip32.c',
+        'src/fcrypto/hash.c',
         'src/fcrypto/secp256k1.c',
       ],
       'include_dirs': [
@@ -76,9 +141,18 @@
       'dependencies': [
         'fcrypto',
       ],
+      'conditions': [
+        ['addon_variant!="baseline"', {
+          'product_name': 'addon-<(addon_variant)',
+        }],
+      ],
       'sources': [
+        'src/addon/cpu.cc',
+        'src/addon/executor.cc',
         'src/addon/main.cc',
         'src/addon/secp256k1.cc',
+        'src/addon/secp256k1_async.cc',
+        'src/addon/stats.cc',
       ],
       'include_dirs': [
         # On Windows: Cannot open include file: 'napi.h': No such file or directory
@@ -94,6 +168,7 @@
       ],
       'defines': [
         'NAPI_VERSION=3',
+        'ADDON_VARIANT=<(addon_variant)',
       ],
       'xcode_settings': {
         'GCC_ENABLE_CPP_EXCEPTIONS': 'YES',
@@ -1,12 +1,37 @@
 const path = require('path')
 
-module.exports = async () => {
+function requireAddon (suffix) {
   try {
-    const location = path.join('..', '..', 'build', 'Release', 'addon.node')
-    return require(location)
+    const name = `addon${suffix}.node`
+    return require(path.join('..', '..', 'build', 'Release', name))
   } catch (err) {
-    const name = `fcrypto-${process.platform}-${process.arch}.node`
-    const location = path.join('..', '..', name)
-    return require(location)
+    const name = `fcrypto-${process.platform}-${process.arch}${suffix}.node`
+    return require(path.join('..', '..', name))
+  }
+}
+
+// Variants with CPU features (see `addon_variant` in binding.gyp) are
+// optional files, best one which is supported by CPU is used. Baseline addon
+// is always loaded first, because it checks features. Variant can be forced
+// with FCRYPTO_ADDON_VARIANT (falls back to baseline if it is not supported).
+const variants = {
+  avx2: ({ bmi2, adx, avx2 }) => bmi2 && adx && avx2,
+  bmi2: ({ bmi2, adx }) => bmi2 && adx,
+}
+
+module.exports = async () => {
+  const addon = requireAddon('')
+  const features = addon.cpuFeatures()
+
+  const forced = process.env.FCRYPTO_ADDON_VARIANT
+  const names = forced === undefined ? Object.keys(variants) : [forced]
+  for (const name of names) {
+    if (!variants[name] || !variants[name](features)) continue
+
+    try {
+      return requireAddon(`-${name}`)
+    } catch (err) {}
   }
+
+  return addon
 }
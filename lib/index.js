@@ -18,7 +18,9 @@ async function load (type, options = {}) {
   }
 
   if (options.secp256k1) {
-    obj.secp256k1.init()
+    obj.secp256k1.init(
+      options.secp256k1 === true ? undefined : options.secp256k1
+    )
   }
 
   if (!loaded) {
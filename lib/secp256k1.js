@@ -1,4 +1,5 @@
 const assert = require('./assert')
+const { ECDSAVerifyStream, verifyIterable } = require('./verify-stream')
 
 function getAssertedOutput (output = (len) => new Uint8Array(len), length) {
   if (typeof output === 'function') output = output(length)
@@ -6,6 +7,96 @@ function getAssertedOutput (output = (len) => new Uint8Array(len), length) {
   return output
 }
 
+function isRecid (recid) {
+  return (
+    Object.prototype.toString.call(recid).slice(8, -1) === 'Number' &&
+    recid >= 0 &&
+    recid <= 3
+  )
+}
+
+function isCount (count) {
+  return Number.isSafeInteger(count) && count >= 0
+}
+
+function isThreads (threads) {
+  return Number.isSafeInteger(threads) && threads >= 1
+}
+
+function isUint32 (value) {
+  return Number.isSafeInteger(value) && value >= 0 && value <= 0xffffffff
+}
+
+// BIP32 path: string like `m/44'/0'/0'/0` (hardened with `'` or `h`) or
+// array of indices. Passed to implementation as bytes of Uint32Array.
+const kHardened = 0x80000000
+function getPath (path) {
+  if (typeof path === 'string') {
+    const items = path.split('/')
+    assert(items[0] === 'm', 'Expected path to start with m')
+    path = items.slice(1).map((item) => {
+      const match = /^(\d+)(['hH]?)$/.exec(item)
+      assert(match !== null, `Expected path index, got "${item}"`)
+      const index = parseInt(match[1], 10)
+      assert(index < kHardened, `Expected path index below 2^31, got ${index}`)
+      return match[2] === '' ? index : index + kHardened
+    })
+  }
+
+  assert(
+    Array.isArray(path) && path.every(isUint32),
+    'Expected path to be string or Array of uint32'
+  )
+  return new Uint8Array(Uint32Array.from(path).buffer)
+}
+
+// Named option passed to implementation as number
+function getOption (name, options, value) {
+  assert(
+    Object.prototype.hasOwnProperty.call(options, value),
+    `Expected ${name} to be one of: ${Object.keys(options)}`
+  )
+  return options[value]
+}
+
+// Address of recovered public key: keccak256 of uncompressed key without
+// prefix (Ethereum) or hash160 (RIPEMD-160 of SHA-256) of serialized key
+const kAddressTypes = { keccak256: 0, hash160: 1, hash160Uncompressed: 2 }
+
+// Digest of raw message for sign / verify, sha256d is sha256(sha256(msg))
+const kMessageHashes = { sha256: 0, sha256d: 1, keccak256: 2 }
+
+// ECDH output: hash of compressed shared point or raw point. Mode also can
+// be custom KDF in JS: function of x and y, applied to raw point.
+const kECDHModes = {
+  sha256: 0,
+  keccak256: 1,
+  x: 2,
+  compressed: 3,
+  uncompressed: 4,
+}
+const kECDHOutputLengths = [32, 32, 32, 33, 65]
+
+// Messages of bulk functions packed to one array, message i is
+// msgs[offsets[i]..offsets[i + 1]). Offsets passed as bytes of Uint32Array.
+function getMessages (messages) {
+  assert(
+    Array.isArray(messages) && messages.every((x) => x instanceof Uint8Array),
+    'Expected messages to be an Array of Uint8Array'
+  )
+
+  const offsets = new Uint32Array(messages.length + 1)
+  for (let i = 0; i < messages.length; ++i) {
+    const offset = offsets[i] + messages[i].length
+    assert(offset <= 0xffffffff, 'Expected total length of messages below 4GiB')
+    offsets[i + 1] = offset
+  }
+
+  const msgs = new Uint8Array(offsets[messages.length])
+  for (let i = 0; i < messages.length; ++i) msgs.set(messages[i], offsets[i])
+  return { msgs, offsets: new Uint8Array(offsets.buffer) }
+}
+
 const errors = {
   ALREADY_INITIALIZED: 'Secp256k1 already initialized',
   SHOULD_BE_INITIALIZED: 'Secp256k1 should be initialized first',
@@ -18,19 +109,204 @@ const errors = {
   PUBKEY_PARSE: 'Public Key could not be parsed',
   PUBKEY_SERIALIZE: 'Public Key serialization error',
   PUBKEY_COMBINE: 'The sum of the public keys is not valid',
+  PUBKEY_LINEAR_COMBINATION:
+    'One of the scalars was out of range or the combination is not valid',
   SIG_PARSE: 'signature could not be parsed',
   SIGN: 'The nonce generation function failed, or the private key was invalid',
   RECOVER: 'Public key could not be recover',
   ECDH: 'Scalar was invalid (zero or overflow)',
+  MALLOC: 'Memory allocation error',
+  VERIFIER_DESTROYED: 'Verifier already destroyed',
+  STAGING_FREED: 'Staging already freed',
+  BIP32_SEED: 'Master key is invalid, other seed should be used',
+  EXTENDED_KEY_INVALID: 'Extended key is invalid',
+  BIP32_PRIVATE_REQUIRED:
+    'Private extended key required for hardened index or private output',
+  BIP32_DERIVE: 'Derived key is invalid, next index should be used',
+}
+
+// Parsed public key, created by `publicKeyParse`, can be passed instead of
+// serialized key. Handle is implementation object (addon or wasm).
+const kHandle = Symbol('handle')
+class PublicKey {
+  constructor (handle) {
+    this[kHandle] = handle
+  }
+}
+
+// Prepared verifier, created by `ecdsaVerifierCreate`, can be passed to
+// `ecdsaVerify` instead of public key.
+class ECDSAVerifier {
+  constructor (handle) {
+    this[kHandle] = handle
+  }
+}
+
+// Memory for staged functions (`*Staged`), which receive offsets in staging
+// instead of arrays. In WebAssembly it's area in module heap, so data written
+// to `view` is used by functions and results are written by them without
+// copies. Addon work with Uint8Array directly, so there staging is plain
+// Uint8Array. Secret data is not wiped automatically, call `wipe` when it's
+// not needed anymore.
+const kPtr = Symbol('ptr')
+const kFree = Symbol('free')
+class Staging {
+  constructor (view, ptr, free) {
+    this.view = view
+    this[kPtr] = ptr
+    this[kFree] = free
+  }
+
+  get length () {
+    assert(this.view !== null, errors.STAGING_FREED)
+    return this.view.length
+  }
+
+  subarray (offset, length) {
+    assert(this.view !== null, errors.STAGING_FREED)
+    return this.view.subarray(offset, offset + length)
+  }
+
+  wipe (offset = 0, length = this.length - offset) {
+    assert(this.view !== null, errors.STAGING_FREED)
+    this.view.fill(0, offset, offset + length)
+  }
+
+  free () {
+    this.wipe()
+    if (this[kFree] !== null) this[kFree]()
+    this.view = null
+  }
+}
+
+// Pointer for WebAssembly or subarray for addon
+function getStaged (staging, name, offset, length) {
+  assert(
+    isCount(offset) && offset + length <= staging.length,
+    `Expected ${name} offset to be in staging bounds`
+  )
+
+  return staging[kPtr] === null
+    ? staging.view.subarray(offset, offset + length)
+    : staging[kPtr] + offset
+}
+
+// LRU cache of parsed public keys by serialized bytes. Map keep insertion
+// order, so on hit we move key to the end and on overflow remove first key.
+class PublicKeyCache {
+  constructor (capacity, parse) {
+    this.capacity = capacity
+    this.parse = parse
+    this.map = new Map()
+    this.hits = 0
+    this.misses = 0
+  }
+
+  get (pubkey) {
+    const key = String.fromCharCode.apply(null, pubkey)
+    let handle = this.map.get(key)
+    if (handle !== undefined) {
+      this.hits += 1
+      this.map.delete(key)
+      this.map.set(key, handle)
+      return handle
+    }
+
+    this.misses += 1
+    handle = this.parse(pubkey)
+    // Not cached, parse error will be reported by called function
+    if (handle === null) return pubkey
+
+    if (this.map.size >= this.capacity) {
+      this.map.delete(this.map.keys().next().value)
+    }
+    this.map.set(key, handle)
+    return handle
+  }
+
+  stats () {
+    return {
+      size: this.map.size,
+      capacity: this.capacity,
+      hits: this.hits,
+      misses: this.misses,
+    }
+  }
 }
 
 module.exports = (Secp256k1) => {
   let instance = null
+  let cache = null
+
+  function parsePubkey (pubkey) {
+    const obj = { handle: null }
+    switch (instance.publicKeyParse(obj, pubkey)) {
+      case 0:
+        return obj.handle
+      case 1:
+        return null
+    }
+  }
+
+  // Public key for implementation: handle or serialized key
+  function getPubkey (pubkey) {
+    if (pubkey instanceof PublicKey) return pubkey[kHandle]
+
+    assert.isUint8Array('public key', pubkey, [33, 65])
+    return cache === null ? pubkey : cache.get(pubkey)
+  }
+
+  function assertStaging (staging) {
+    assert(staging instanceof Staging, 'Expected staging to be Staging')
+    assert(staging.view !== null, errors.STAGING_FREED)
+  }
+
+  const secp256k1 = {
+    PublicKey,
+    ECDSAVerifier,
+    Staging,
 
-  return {
-    init () {
+    init ({ publicKeyCacheSize = 0, stats = false } = {}) {
       assert(instance === null, errors.ALREADY_INITIALIZED)
+      assert(
+        isCount(publicKeyCacheSize),
+        'Expected publicKeyCacheSize to be a non-negative integer'
+      )
+      assert(typeof stats === 'boolean', 'Expected stats to be a boolean')
+
       instance = new Secp256k1()
+      if (publicKeyCacheSize > 0) {
+        cache = new PublicKeyCache(publicKeyCacheSize, parsePubkey)
+      }
+      if (stats) instance.statsEnable(true)
+    },
+
+    buildInfo () {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+
+      return instance.buildInfo()
+    },
+
+    // Counters of native calls (addon / WebAssembly methods, which return
+    // codes), disabled by default. Snapshot keyed by method name, see
+    // docs/API.md for format of latency histogram.
+    statsEnable (enabled = true) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert(typeof enabled === 'boolean', 'Expected enabled to be a boolean')
+
+      instance.statsEnable(enabled)
+    },
+
+    statsReset () {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+
+      instance.statsReset()
+    },
+
+    statsSnapshot () {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+
+      return instance.statsSnapshot()
     },
 
     contextRandomize (seed) {
@@ -107,9 +383,24 @@ module.exports = (Secp256k1) => {
       }
     },
 
-    publicKeyConvert (pubkey, compressed = true, output) {
+    publicKeyParse (pubkey) {
       assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
       assert.isUint8Array('public key', pubkey, [33, 65])
+
+      const handle = parsePubkey(pubkey)
+      if (handle === null) throw new Error(errors.PUBKEY_PARSE)
+      return new PublicKey(handle)
+    },
+
+    publicKeyCacheStats () {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+
+      return cache === null ? null : cache.stats()
+    },
+
+    publicKeyConvert (pubkey, compressed = true, output) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      pubkey = getPubkey(pubkey)
       output = getAssertedOutput(output, compressed ? 33 : 65)
 
       switch (instance.publicKeyConvert(output, pubkey)) {
@@ -124,7 +415,7 @@ module.exports = (Secp256k1) => {
 
     publicKeyNegate (pubkey, compressed = true, output) {
       assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
-      assert.isUint8Array('public key', pubkey, [33, 65])
+      pubkey = getPubkey(pubkey)
       output = getAssertedOutput(output, compressed ? 33 : 65)
 
       switch (instance.publicKeyNegate(output, pubkey)) {
@@ -142,9 +433,7 @@ module.exports = (Secp256k1) => {
     publicKeyCombine (pubkeys, compressed = true, output) {
       assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
       assert(Array.isArray(pubkeys), `Expected public keys to be an Array`)
-      for (const pubkey of pubkeys) {
-        assert.isUint8Array('public key', pubkey, [33, 65])
-      }
+      pubkeys = pubkeys.map(getPubkey)
       output = getAssertedOutput(output, compressed ? 33 : 65)
 
       switch (instance.publicKeyCombine(output, pubkeys)) {
@@ -156,12 +445,55 @@ module.exports = (Secp256k1) => {
           throw new Error(errors.PUBKEY_COMBINE)
         case 3:
           throw new Error(errors.PUBKEY_SERIALIZE)
+        case 4:
+          throw new Error(errors.MALLOC)
+      }
+    },
+
+    // gScalar * G + sum(scalars[i] * pubkeys[i]) with one multi-scalar
+    // multiplication, scalars are not secret (variable time)
+    publicKeyLinearCombination (
+      pubkeys,
+      scalars,
+      gScalar = null,
+      compressed = true,
+      output
+    ) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert(Array.isArray(pubkeys), `Expected public keys to be an Array`)
+      assert(Array.isArray(scalars), `Expected scalars to be an Array`)
+      assert(
+        pubkeys.length === scalars.length,
+        `Expected same number of public keys and scalars`
+      )
+      pubkeys = pubkeys.map(getPubkey)
+      const packed = new Uint8Array(32 * scalars.length)
+      for (let i = 0; i < scalars.length; ++i) {
+        assert.isUint8Array('scalar', scalars[i], 32)
+        packed.set(scalars[i], 32 * i)
+      }
+      if (gScalar !== null) assert.isUint8Array('gScalar', gScalar, 32)
+      output = getAssertedOutput(output, compressed ? 33 : 65)
+
+      switch (
+        instance.publicKeyLinearCombination(output, pubkeys, packed, gScalar)
+      ) {
+        case 0:
+          return output
+        case 1:
+          throw new Error(errors.PUBKEY_PARSE)
+        case 2:
+          throw new Error(errors.PUBKEY_LINEAR_COMBINATION)
+        case 3:
+          throw new Error(errors.PUBKEY_SERIALIZE)
+        case 4:
+          throw new Error(errors.MALLOC)
       }
     },
 
     publicKeyTweakAdd (pubkey, tweak, compressed = true, output) {
       assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
-      assert.isUint8Array('public key', pubkey, [33, 65])
+      pubkey = getPubkey(pubkey)
       assert.isUint8Array('tweak', tweak, 32)
       output = getAssertedOutput(output, compressed ? 33 : 65)
 
@@ -177,11 +509,11 @@ module.exports = (Secp256k1) => {
 
     publicKeyTweakMul (pubkey, tweak, compressed = true, output) {
       assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
-      assert.isUint8Array('public key', pubkey, [33, 65])
+      pubkey = getPubkey(pubkey)
       assert.isUint8Array('tweak', tweak, 32)
       output = getAssertedOutput(output, compressed ? 33 : 65)
 
-      switch (instance.publicKeyTweakAdd(output, pubkey, tweak)) {
+      switch (instance.publicKeyTweakMul(output, pubkey, tweak)) {
         case 0:
           return output
         case 1:
@@ -255,9 +587,16 @@ module.exports = (Secp256k1) => {
       assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
       assert.isUint8Array('signature', sig, 64)
       assert.isUint8Array('message', msg32, 32)
-      assert.isUint8Array('public key', pubkey, [33, 65])
 
-      switch (instance.ecdsaVerify(sig, msg32, pubkey)) {
+      let ret
+      if (pubkey instanceof ECDSAVerifier) {
+        assert(pubkey[kHandle] !== null, errors.VERIFIER_DESTROYED)
+        ret = instance.ecdsaVerifyPrepared(sig, msg32, pubkey[kHandle])
+      } else {
+        ret = instance.ecdsaVerify(sig, msg32, getPubkey(pubkey))
+      }
+
+      switch (ret) {
         case 0:
           return true
         case 3:
@@ -269,13 +608,135 @@ module.exports = (Secp256k1) => {
       }
     },
 
+    ecdsaSignMessage (msg, seckey, hash = 'sha256', output) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert.isUint8Array('message', msg)
+      assert.isUint8Array('private key', seckey, 32)
+      hash = getOption('hash', kMessageHashes, hash)
+      output = getAssertedOutput(output, 64)
+
+      const obj = { signature: output, recid: null }
+      switch (instance.ecdsaSignMessage(obj, msg, seckey, hash)) {
+        case 0:
+          return obj
+        case 1:
+          throw new Error(errors.SIGN)
+        case 2:
+        case 3:
+          throw new Error(errors.IMPOSSIBLE_CASE)
+      }
+    },
+
+    ecdsaVerifyMessage (sig, msg, pubkey, hash = 'sha256') {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert.isUint8Array('signature', sig, 64)
+      assert.isUint8Array('message', msg)
+      pubkey = getPubkey(pubkey)
+      hash = getOption('hash', kMessageHashes, hash)
+
+      switch (instance.ecdsaVerifyMessage(sig, msg, pubkey, hash)) {
+        case 0:
+          return true
+        case 3:
+          return false
+        case 1:
+          throw new Error(errors.SIG_PARSE)
+        case 2:
+          throw new Error(errors.PUBKEY_PARSE)
+        case 4:
+          throw new Error(errors.IMPOSSIBLE_CASE)
+      }
+    },
+
+    ecdsaVerifierCreate (pubkey) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      pubkey = getPubkey(pubkey)
+
+      const obj = { handle: null }
+      switch (instance.ecdsaVerifierCreate(obj, pubkey)) {
+        case 0:
+          return new ECDSAVerifier(obj.handle)
+        case 1:
+          throw new Error(errors.PUBKEY_PARSE)
+        case 2:
+          throw new Error(errors.MALLOC)
+      }
+    },
+
+    ecdsaVerifierDestroy (verifier) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert(
+        verifier instanceof ECDSAVerifier,
+        'Expected verifier to be ECDSAVerifier'
+      )
+      assert(verifier[kHandle] !== null, errors.VERIFIER_DESTROYED)
+
+      instance.ecdsaVerifierDestroy(verifier[kHandle])
+      verifier[kHandle] = null
+    },
+
+    ecdsaVerifyBatch (sigs, msgs32, pubkeys) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert(Array.isArray(sigs), 'Expected signatures to be an Array')
+      assert(Array.isArray(msgs32), 'Expected messages to be an Array')
+      assert(Array.isArray(pubkeys), 'Expected public keys to be an Array')
+      assert(
+        sigs.length === msgs32.length && sigs.length === pubkeys.length,
+        'Expected signatures, messages and public keys with same length'
+      )
+
+      const n = sigs.length
+      const signatures = new Array(n)
+      const recids = new Array(n)
+      const keys = new Array(n)
+      for (let i = 0; i < n; ++i) {
+        assert(
+          sigs[i] instanceof Object,
+          'Expected signature to be an Object with signature and recid'
+        )
+        assert.isUint8Array('signature', sigs[i].signature, 64)
+        assert(
+          isRecid(sigs[i].recid),
+          'Expected recovery id to be a Number within interval [0, 3]'
+        )
+        assert.isUint8Array('message', msgs32[i], 32)
+        keys[i] = getPubkey(pubkeys[i])
+
+        signatures[i] = sigs[i].signature
+        recids[i] = sigs[i].recid
+      }
+
+      const results = new Uint8Array(n)
+      if (n > 0) {
+        const args = [results, signatures, recids, msgs32, keys]
+        switch (instance.ecdsaVerifyBatch(...args)) {
+          case 0:
+            return new Array(n).fill(true)
+          case 2:
+            throw new Error(errors.MALLOC)
+        }
+      }
+
+      // Same behavior as ecdsaVerify on each item
+      return Array.from(results, (code) => {
+        switch (code) {
+          case 0:
+            return true
+          case 3:
+            return false
+          case 1:
+            throw new Error(errors.SIG_PARSE)
+          case 2:
+            throw new Error(errors.PUBKEY_PARSE)
+        }
+      })
+    },
+
     ecdsaRecover (sig, recid, msg32, compressed = true, output) {
       assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
       assert.isUint8Array('signature', sig, 64)
       assert(
-        Object.prototype.toString.call(recid).slice(8, -1) === 'Number' &&
-          recid >= 0 &&
-          recid <= 3,
+        isRecid(recid),
         'Expected recovery id to be a Number within interval [0, 3]'
       )
       assert.isUint8Array('message', msg32, 32)
@@ -293,13 +754,688 @@ module.exports = (Secp256k1) => {
       }
     },
 
-    ecdh (pubkey, seckey, output) {
+    ecdsaRecoverAddress (sig, recid, msg32, type = 'keccak256', output) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert.isUint8Array('signature', sig, 64)
+      assert(
+        isRecid(recid),
+        'Expected recovery id to be a Number within interval [0, 3]'
+      )
+      assert.isUint8Array('message', msg32, 32)
+      type = getOption('address type', kAddressTypes, type)
+      output = getAssertedOutput(output, 20)
+
+      switch (instance.ecdsaRecoverAddress(output, sig, recid, msg32, type)) {
+        case 0:
+          return output
+        case 1:
+          throw new Error(errors.SIG_PARSE)
+        case 2:
+          throw new Error(errors.RECOVER)
+        case 3:
+          throw new Error(errors.IMPOSSIBLE_CASE)
+      }
+    },
+
+    xOnlyPublicKeyCreate (seckey, output) {
       assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
-      assert.isUint8Array('public key', pubkey, [33, 65])
       assert.isUint8Array('private key', seckey, 32)
       output = getAssertedOutput(output, 32)
 
-      switch (instance.ecdh(output, pubkey, seckey)) {
+      switch (instance.xOnlyPublicKeyCreate(output, seckey)) {
+        case 0:
+          return output
+        case 1:
+          throw new Error(errors.SECKEY_INVALID)
+      }
+    },
+
+    xOnlyPublicKeyConvert (pubkey, output) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      pubkey = getPubkey(pubkey)
+      output = getAssertedOutput(output, 32)
+
+      switch (instance.xOnlyPublicKeyConvert(output, pubkey)) {
+        case 0:
+          return output
+        case 1:
+          throw new Error(errors.PUBKEY_PARSE)
+      }
+    },
+
+    // BIP340, auxRand is 32 bytes of fresh randomness (recommended) or null
+    schnorrSign (msg32, seckey, auxRand = null, output) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert.isUint8Array('message', msg32, 32)
+      assert.isUint8Array('private key', seckey, 32)
+      if (auxRand !== null) assert.isUint8Array('auxRand', auxRand, 32)
+      output = getAssertedOutput(output, 64)
+
+      switch (instance.schnorrSign(output, msg32, seckey, auxRand)) {
+        case 0:
+          return output
+        case 1:
+          throw new Error(errors.SECKEY_INVALID)
+      }
+    },
+
+    schnorrVerify (sig, msg32, pubkey) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert.isUint8Array('signature', sig, 64)
+      assert.isUint8Array('message', msg32, 32)
+      assert.isUint8Array('public key', pubkey, 32)
+
+      switch (instance.schnorrVerify(sig, msg32, pubkey)) {
+        case 0:
+          return true
+        case 2:
+          return false
+        case 1:
+          throw new Error(errors.PUBKEY_PARSE)
+      }
+    },
+
+    // Groups of batchSize signatures checked together (0 for one group), an
+    // incorrect signature cost re-verification of its group only
+    schnorrVerifyBatch (sigs, msgs32, pubkeys, batchSize = 64) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert(Array.isArray(sigs), 'Expected signatures to be an Array')
+      assert(Array.isArray(msgs32), 'Expected messages to be an Array')
+      assert(Array.isArray(pubkeys), 'Expected public keys to be an Array')
+      assert(
+        sigs.length === msgs32.length && sigs.length === pubkeys.length,
+        'Expected signatures, messages and public keys with same length'
+      )
+      assert(
+        isCount(batchSize),
+        'Expected batch size to be a non-negative integer'
+      )
+
+      const n = sigs.length
+      const inputs = new Uint8Array(128 * n)
+      for (let i = 0; i < n; ++i) {
+        assert.isUint8Array('signature', sigs[i], 64)
+        assert.isUint8Array('message', msgs32[i], 32)
+        assert.isUint8Array('public key', pubkeys[i], 32)
+        inputs.set(sigs[i], 128 * i)
+        inputs.set(msgs32[i], 128 * i + 64)
+        inputs.set(pubkeys[i], 128 * i + 96)
+      }
+
+      const results = new Uint8Array(n)
+      if (n > 0) {
+        switch (instance.schnorrVerifyBatch(results, inputs, batchSize)) {
+          case 0:
+            return new Array(n).fill(true)
+          case 2:
+            throw new Error(errors.MALLOC)
+        }
+      }
+
+      // Same behavior as schnorrVerify on each item
+      return Array.from(results, (code) => {
+        switch (code) {
+          case 0:
+            return true
+          case 2:
+            return false
+          case 1:
+            throw new Error(errors.PUBKEY_PARSE)
+        }
+      })
+    },
+
+    ecdh (pubkey, seckey, output, mode = 'sha256') {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      pubkey = getPubkey(pubkey)
+      assert.isUint8Array('private key', seckey, 32)
+      const kdf = typeof mode === 'function' ? mode : null
+      if (kdf === null) {
+        mode = getOption('ECDH mode', kECDHModes, mode)
+      } else {
+        mode = kECDHModes.uncompressed
+      }
+      const secret =
+        kdf === null
+          ? getAssertedOutput(output, kECDHOutputLengths[mode])
+          : new Uint8Array(65)
+
+      switch (instance.ecdh(secret, pubkey, seckey, mode)) {
+        case 0:
+          break
+        case 1:
+          throw new Error(errors.PUBKEY_PARSE)
+        case 2:
+          throw new Error(errors.ECDH)
+        case 3:
+          throw new Error(errors.IMPOSSIBLE_CASE)
+      }
+      if (kdf === null) return secret
+
+      try {
+        const data = kdf(secret.subarray(1, 33), secret.subarray(33, 65))
+        assert.isUint8Array('KDF output', data)
+        output = getAssertedOutput(output, data.length)
+        output.set(data, 0)
+        return output
+      } finally {
+        secret.fill(0)
+      }
+    },
+
+    // Staged versions work with offsets in staging, see Staging above
+    stagingCreate (size) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert(
+        isCount(size) && size > 0,
+        'Expected size to be a positive integer'
+      )
+
+      if (typeof instance.stagingAlloc !== 'function') {
+        return new Staging(new Uint8Array(size), null, null)
+      }
+
+      const ptr = instance.stagingAlloc(size)
+      if (ptr === 0) throw new Error(errors.MALLOC)
+
+      const view = instance.stagingView(ptr, size)
+      return new Staging(view, ptr, () => instance.stagingFree(ptr))
+    },
+
+    publicKeyCreateStaged (
+      staging,
+      outputOffset,
+      seckeyOffset,
+      compressed = true
+    ) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assertStaging(staging)
+      const outputlen = compressed ? 33 : 65
+      const output = getStaged(staging, 'output', outputOffset, outputlen)
+      const seckey = getStaged(staging, 'private key', seckeyOffset, 32)
+
+      const ret =
+        staging[kPtr] === null
+          ? instance.publicKeyCreate(output, seckey)
+          : instance.publicKeyCreateStaged(output, outputlen, seckey)
+      switch (ret) {
+        case 0:
+          return
+        case 1:
+          throw new Error(errors.SECKEY_INVALID)
+        case 2:
+          throw new Error(errors.PUBKEY_SERIALIZE)
+      }
+    },
+
+    ecdsaSignStaged (staging, sigOffset, msg32Offset, seckeyOffset) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assertStaging(staging)
+      const sig = getStaged(staging, 'signature', sigOffset, 64)
+      const msg32 = getStaged(staging, 'message', msg32Offset, 32)
+      const seckey = getStaged(staging, 'private key', seckeyOffset, 32)
+
+      const obj = { signature: sig, recid: null }
+      const ret =
+        staging[kPtr] === null
+          ? instance.ecdsaSign(obj, msg32, seckey)
+          : instance.ecdsaSignStaged(obj, sig, msg32, seckey)
+      switch (ret) {
+        case 0:
+          return obj.recid
+        case 1:
+          throw new Error(errors.SIGN)
+        case 2:
+          throw new Error(errors.IMPOSSIBLE_CASE)
+      }
+    },
+
+    ecdsaVerifyStaged (
+      staging,
+      sigOffset,
+      msg32Offset,
+      pubkeyOffset,
+      pubkeylen = 33
+    ) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assertStaging(staging)
+      assert(
+        pubkeylen === 33 || pubkeylen === 65,
+        'Expected public key length to be 33 or 65'
+      )
+      const sig = getStaged(staging, 'signature', sigOffset, 64)
+      const msg32 = getStaged(staging, 'message', msg32Offset, 32)
+      const pubkey = getStaged(staging, 'public key', pubkeyOffset, pubkeylen)
+
+      const ret =
+        staging[kPtr] === null
+          ? instance.ecdsaVerify(sig, msg32, pubkey)
+          : instance.ecdsaVerifyStaged(sig, msg32, pubkey, pubkeylen)
+      switch (ret) {
+        case 0:
+          return true
+        case 3:
+          return false
+        case 1:
+          throw new Error(errors.SIG_PARSE)
+        case 2:
+          throw new Error(errors.PUBKEY_PARSE)
+      }
+    },
+
+    ecdsaRecoverStaged (
+      staging,
+      outputOffset,
+      sigOffset,
+      recid,
+      msg32Offset,
+      compressed = true
+    ) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assertStaging(staging)
+      assert(
+        isRecid(recid),
+        'Expected recovery id to be a Number within interval [0, 3]'
+      )
+      const outputlen = compressed ? 33 : 65
+      const output = getStaged(staging, 'output', outputOffset, outputlen)
+      const sig = getStaged(staging, 'signature', sigOffset, 64)
+      const msg32 = getStaged(staging, 'message', msg32Offset, 32)
+
+      const ret =
+        staging[kPtr] === null
+          ? instance.ecdsaRecover(output, sig, recid, msg32)
+          : instance.ecdsaRecoverStaged(output, outputlen, sig, recid, msg32)
+      switch (ret) {
+        case 0:
+          return
+        case 1:
+          throw new Error(errors.SIG_PARSE)
+        case 2:
+          throw new Error(errors.RECOVER)
+        case 3:
+          throw new Error(errors.IMPOSSIBLE_CASE)
+      }
+    },
+
+    ecdhStaged (
+      staging,
+      outputOffset,
+      pubkeyOffset,
+      seckeyOffset,
+      pubkeylen = 33
+    ) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assertStaging(staging)
+      assert(
+        pubkeylen === 33 || pubkeylen === 65,
+        'Expected public key length to be 33 or 65'
+      )
+      const output = getStaged(staging, 'output', outputOffset, 32)
+      const pubkey = getStaged(staging, 'public key', pubkeyOffset, pubkeylen)
+      const seckey = getStaged(staging, 'private key', seckeyOffset, 32)
+
+      const ret =
+        staging[kPtr] === null
+          ? instance.ecdh(output, pubkey, seckey, kECDHModes.sha256)
+          : instance.ecdhStaged(output, pubkey, pubkeylen, seckey)
+      switch (ret) {
+        case 0:
+          return
+        case 1:
+          throw new Error(errors.PUBKEY_PARSE)
+        case 2:
+          throw new Error(errors.ECDH)
+      }
+    },
+
+    // Bulk versions work with packed records, status 0 means success,
+    // other values are error codes of single functions (see docs)
+    privateKeyVerifyMany (seckeys, count) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert(isCount(count), 'Expected count to be a non-negative integer')
+      assert.isUint8Array('private keys', seckeys, count * 32)
+
+      const statuses = new Uint8Array(count)
+      if (count > 0) instance.privateKeyVerifyMany(statuses, seckeys)
+      return statuses
+    },
+
+    publicKeyCreateMany (seckeys, count, compressed = true, output, threads = 1) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert(isCount(count), 'Expected count to be a non-negative integer')
+      assert(isThreads(threads), 'Expected threads to be a positive integer')
+      assert.isUint8Array('private keys', seckeys, count * 32)
+      output = getAssertedOutput(output, count * (compressed ? 33 : 65))
+
+      const statuses = new Uint8Array(count)
+      if (count > 0) {
+        instance.publicKeyCreateMany(output, statuses, seckeys, threads)
+      }
+      return { output, statuses }
+    },
+
+    publicKeyCreateRange (seckey, count, compressed = true, output) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert(isCount(count), 'Expected count to be a non-negative integer')
+      assert.isUint8Array('private key', seckey, 32)
+      output = getAssertedOutput(output, count * (compressed ? 33 : 65))
+
+      const statuses = new Uint8Array(count)
+      if (count > 0) {
+        switch (instance.publicKeyCreateRange(output, statuses, seckey)) {
+          case 2:
+            throw new Error(errors.SECKEY_INVALID)
+        }
+      }
+      return { output, statuses }
+    },
+
+    ecdsaSignMany (inputs, count, output) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert(isCount(count), 'Expected count to be a non-negative integer')
+      assert.isUint8Array('inputs', inputs, count * 64)
+      output = getAssertedOutput(output, count * 65)
+
+      const statuses = new Uint8Array(count)
+      if (count > 0) instance.ecdsaSignMany(output, statuses, inputs)
+      return { output, statuses }
+    },
+
+    ecdsaVerifyMany (inputs, count, compressed = true, threads = 1) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert(isCount(count), 'Expected count to be a non-negative integer')
+      assert(isThreads(threads), 'Expected threads to be a positive integer')
+      assert.isUint8Array('inputs', inputs, count * (compressed ? 129 : 161))
+
+      const statuses = new Uint8Array(count)
+      if (count > 0) instance.ecdsaVerifyMany(statuses, inputs, threads)
+      return statuses
+    },
+
+    ecdsaSignMessageMany (messages, seckeys, hash = 'sha256', output) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      const { msgs, offsets } = getMessages(messages)
+      const count = messages.length
+      assert.isUint8Array('private keys', seckeys, count * 32)
+      hash = getOption('hash', kMessageHashes, hash)
+      output = getAssertedOutput(output, count * 65)
+
+      const statuses = new Uint8Array(count)
+      if (count > 0) {
+        instance.ecdsaSignMessageMany(
+          output,
+          statuses,
+          seckeys,
+          msgs,
+          offsets,
+          hash
+        )
+      }
+      return { output, statuses }
+    },
+
+    ecdsaVerifyMessageMany (
+      messages,
+      inputs,
+      compressed = true,
+      hash = 'sha256',
+      threads = 1
+    ) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert(isThreads(threads), 'Expected threads to be a positive integer')
+      const { msgs, offsets } = getMessages(messages)
+      const count = messages.length
+      assert.isUint8Array('inputs', inputs, count * (compressed ? 97 : 129))
+      hash = getOption('hash', kMessageHashes, hash)
+
+      const statuses = new Uint8Array(count)
+      if (count > 0) {
+        instance.ecdsaVerifyMessageMany(
+          statuses,
+          inputs,
+          msgs,
+          offsets,
+          hash,
+          threads
+        )
+      }
+      return statuses
+    },
+
+    ecdsaRecoverMany (inputs, count, compressed = true, output, threads = 1) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert(isCount(count), 'Expected count to be a non-negative integer')
+      assert(isThreads(threads), 'Expected threads to be a positive integer')
+      assert.isUint8Array('inputs', inputs, count * 97)
+      output = getAssertedOutput(output, count * (compressed ? 33 : 65))
+
+      const statuses = new Uint8Array(count)
+      if (count > 0) {
+        instance.ecdsaRecoverMany(output, statuses, inputs, threads)
+      }
+      return { output, statuses }
+    },
+
+    ecdsaRecoverAddressMany (
+      inputs,
+      count,
+      type = 'keccak256',
+      output,
+      threads = 1
+    ) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert(isCount(count), 'Expected count to be a non-negative integer')
+      assert(isThreads(threads), 'Expected threads to be a positive integer')
+      assert.isUint8Array('inputs', inputs, count * 97)
+      type = getOption('address type', kAddressTypes, type)
+      output = getAssertedOutput(output, count * 20)
+
+      const statuses = new Uint8Array(count)
+      if (count > 0) {
+        instance.ecdsaRecoverAddressMany(
+          output,
+          statuses,
+          inputs,
+          type,
+          threads
+        )
+      }
+      return { output, statuses }
+    },
+
+    ecdhMany (inputs, count, compressed = true, output, threads = 1) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert(isCount(count), 'Expected count to be a non-negative integer')
+      assert(isThreads(threads), 'Expected threads to be a positive integer')
+      assert.isUint8Array('inputs', inputs, count * (compressed ? 65 : 97))
+      output = getAssertedOutput(output, count * 32)
+
+      const statuses = new Uint8Array(count)
+      if (count > 0) instance.ecdhMany(output, statuses, inputs, threads)
+      return { output, statuses }
+    },
+
+    ecdhPublicKeysMany (
+      seckey,
+      pubkeys,
+      count,
+      compressed = true,
+      mode = 'sha256',
+      output,
+      threads = 1
+    ) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert.isUint8Array('private key', seckey, 32)
+      assert(isCount(count), 'Expected count to be a non-negative integer')
+      assert(isThreads(threads), 'Expected threads to be a positive integer')
+      const pubkeylen = compressed ? 33 : 65
+      assert.isUint8Array('public keys', pubkeys, count * pubkeylen)
+      mode = getOption('ECDH mode', kECDHModes, mode)
+      output = getAssertedOutput(output, count * kECDHOutputLengths[mode])
+
+      const statuses = new Uint8Array(count)
+      if (count > 0) {
+        const ret = instance.ecdhPubkeysMany(
+          output,
+          statuses,
+          seckey,
+          pubkeys,
+          mode,
+          threads
+        )
+        switch (ret) {
+          case 2:
+            throw new Error(errors.ECDH)
+          case 3:
+            throw new Error(errors.IMPOSSIBLE_CASE)
+        }
+      }
+      return { output, statuses }
+    },
+
+    // BIP32, extended key is chain code || key (see docs)
+    bip32FromSeed (seed, output) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert.isUint8Array('seed', seed)
+      assert(
+        seed.length >= 16 && seed.length <= 64,
+        'Expected seed length to be within interval [16, 64]'
+      )
+      output = getAssertedOutput(output, 64)
+
+      switch (instance.bip32FromSeed(output, seed)) {
+        case 0:
+          return output
+        case 1:
+          throw new Error(errors.BIP32_SEED)
+      }
+    },
+
+    bip32Derive (
+      extendedKey,
+      path,
+      publicOutput = extendedKey.length === 65,
+      output
+    ) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert.isUint8Array('extended key', extendedKey, [64, 65])
+      path = getPath(path)
+      output = getAssertedOutput(output, publicOutput ? 65 : 64)
+
+      switch (instance.bip32Derive(output, extendedKey, path)) {
+        case 0:
+          return output
+        case 1:
+          throw new Error(errors.EXTENDED_KEY_INVALID)
+        case 2:
+          throw new Error(errors.BIP32_PRIVATE_REQUIRED)
+        case 3:
+          throw new Error(errors.BIP32_DERIVE)
+      }
+    },
+
+    bip32DeriveRange (
+      extendedKey,
+      index,
+      count,
+      publicOutput = extendedKey.length === 65,
+      output,
+      threads = 1
+    ) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert.isUint8Array('extended key', extendedKey, [64, 65])
+      assert(isUint32(index), 'Expected index to be uint32')
+      assert(isCount(count), 'Expected count to be a non-negative integer')
+      assert(
+        index + count <= 0x100000000,
+        'Expected index + count to be not greater than 2^32'
+      )
+      assert(isThreads(threads), 'Expected threads to be a positive integer')
+      output = getAssertedOutput(output, count * (publicOutput ? 65 : 64))
+
+      const statuses = new Uint8Array(count)
+      if (count > 0) {
+        const ret = instance.bip32DeriveRange(
+          output,
+          statuses,
+          extendedKey,
+          index,
+          threads
+        )
+        switch (ret) {
+          case 2:
+            throw new Error(errors.EXTENDED_KEY_INVALID)
+        }
+      }
+      return { output, statuses }
+    },
+
+    // Async versions, addon run them in threadpool
+    async ecdsaSignAsync (msg32, seckey, output) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert.isUint8Array('message', msg32, 32)
+      assert.isUint8Array('private key', seckey, 32)
+      output = getAssertedOutput(output, 64)
+
+      const obj = { signature: output, recid: null }
+      switch (await instance.ecdsaSignAsync(obj, msg32, seckey)) {
+        case 0:
+          return obj
+        case 1:
+          throw new Error(errors.SIGN)
+        case 2:
+          throw new Error(errors.IMPOSSIBLE_CASE)
+      }
+    },
+
+    async ecdsaVerifyAsync (sig, msg32, pubkey) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert.isUint8Array('signature', sig, 64)
+      assert.isUint8Array('message', msg32, 32)
+      pubkey = getPubkey(pubkey)
+
+      switch (await instance.ecdsaVerifyAsync(sig, msg32, pubkey)) {
+        case 0:
+          return true
+        case 3:
+          return false
+        case 1:
+          throw new Error(errors.SIG_PARSE)
+        case 2:
+          throw new Error(errors.PUBKEY_PARSE)
+      }
+    },
+
+    async ecdsaRecoverAsync (sig, recid, msg32, compressed = true, output) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert.isUint8Array('signature', sig, 64)
+      assert(
+        isRecid(recid),
+        'Expected recovery id to be a Number within interval [0, 3]'
+      )
+      assert.isUint8Array('message', msg32, 32)
+      output = getAssertedOutput(output, compressed ? 33 : 65)
+
+      switch (await instance.ecdsaRecoverAsync(output, sig, recid, msg32)) {
+        case 0:
+          return output
+        case 1:
+          throw new Error(errors.SIG_PARSE)
+        case 2:
+          throw new Error(errors.RECOVER)
+        case 3:
+          throw new Error(errors.IMPOSSIBLE_CASE)
+      }
+    },
+
+    async ecdhAsync (pubkey, seckey, output) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      pubkey = getPubkey(pubkey)
+      assert.isUint8Array('private key', seckey, 32)
+      output = getAssertedOutput(output, 32)
+
+      switch (await instance.ecdhAsync(output, pubkey, seckey)) {
         case 0:
           return output
         case 1:
@@ -308,5 +1444,33 @@ module.exports = (Secp256k1) => {
           throw new Error(errors.ECDH)
       }
     },
+
+    // Statuses same as in ecdsaVerifyMany. Addon verify records on libuv
+    // threadpool, WebAssembly on calling thread (or worker pool if threads > 1)
+    async ecdsaVerifyManyAsync (inputs, count, compressed = true, threads = 1) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      assert(isCount(count), 'Expected count to be a non-negative integer')
+      assert(isThreads(threads), 'Expected threads to be a positive integer')
+      assert.isUint8Array('inputs', inputs, count * (compressed ? 129 : 161))
+
+      const statuses = new Uint8Array(count)
+      if (count > 0) {
+        await instance.ecdsaVerifyManyAsync(statuses, inputs, threads)
+      }
+      return statuses
+    },
+
+    // Streaming verification, see ./verify-stream.js
+    ecdsaVerifyStream (options) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      return new ECDSAVerifyStream(secp256k1, options)
+    },
+
+    ecdsaVerifyIterable (source, options) {
+      assert(instance !== null, errors.SHOULD_BE_INITIALIZED)
+      return verifyIterable(secp256k1, source, options)
+    },
   }
+
+  return secp256k1
 }
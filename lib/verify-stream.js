@@ -0,0 +1,194 @@
+const { Transform } = require('stream')
+const assert = require('./assert')
+
+// Records ({ signature, msg32, pubkey }) accumulated to batch until batchSize
+// records or deadline (ms) from first record of batch, then batch verified
+// with ecdsaVerifyManyAsync (libuv threadpool for addon). Up to concurrency
+// batches verified at once, results pushed in order of records.
+// Backpressure: when concurrency batches are in flight and next batch is
+// full, transform callback waits for the oldest one, so writable side buffers
+// and write() returns false; readable side is not pulled by Transform until
+// consumer reads.
+class ECDSAVerifyStream extends Transform {
+  constructor (secp256k1, options = {}) {
+    const {
+      batchSize = 256,
+      deadline = 10,
+      concurrency = 2,
+      threads = 1,
+      highWaterMark = batchSize,
+    } = options
+    assert(
+      Number.isSafeInteger(batchSize) && batchSize > 0,
+      'Expected batchSize to be a positive integer'
+    )
+    assert(
+      typeof deadline === 'number' && deadline >= 0,
+      'Expected deadline to be a non-negative number'
+    )
+    assert(
+      Number.isSafeInteger(concurrency) && concurrency > 0,
+      'Expected concurrency to be a positive integer'
+    )
+
+    super({
+      readableObjectMode: true,
+      writableObjectMode: true,
+      readableHighWaterMark: highWaterMark,
+      writableHighWaterMark: highWaterMark,
+    })
+
+    this.secp256k1 = secp256k1
+    this.batchSize = batchSize
+    this.deadline = deadline
+    this.concurrency = concurrency
+    this.threads = threads
+
+    this.pending = []
+    this.timer = null
+    this.inflight = []
+    // Pending records should be dispatched, but concurrency batches are in
+    // flight: they are dispatched when the oldest batch settles
+    this.overdue = false
+  }
+
+  _transform (record, encoding, callback) {
+    try {
+      assert(record instanceof Object, 'Expected record to be an Object')
+      assert.isUint8Array('signature', record.signature, 64)
+      assert.isUint8Array('message', record.msg32, 32)
+      assert.isUint8Array('public key', record.pubkey, [33, 65])
+    } catch (err) {
+      return callback(err)
+    }
+
+    this.pending.push(record)
+    if (this.pending.length >= this.batchSize) {
+      this.dispatch()
+    } else if (this.timer === null && !this.overdue) {
+      this.timer = setTimeout(() => this.dispatch(), this.deadline)
+    }
+
+    if (this.inflight.length < this.concurrency) return callback()
+    if (this.pending.length < this.batchSize) return callback()
+    this.inflight[0].then(() => callback(), callback)
+  }
+
+  // Overdue records dispatched while waiting, so wait until nothing in flight
+  _flush (callback) {
+    this.dispatch()
+    const settled = () => {
+      if (this.inflight.length === 0) return callback()
+      this.inflight[this.inflight.length - 1].then(settled, callback)
+    }
+    settled()
+  }
+
+  _destroy (err, callback) {
+    if (this.timer !== null) clearTimeout(this.timer)
+    this.timer = null
+    this.pending = []
+    this.overdue = false
+    callback(err)
+  }
+
+  // Records with compressed and uncompressed keys verified by separate calls,
+  // because records in one call have same length
+  async verify (records) {
+    const results = new Array(records.length)
+    for (const pubkeylen of [33, 65]) {
+      const indexes = []
+      for (let i = 0; i < records.length; ++i) {
+        if (records[i].pubkey.length === pubkeylen) indexes.push(i)
+      }
+      if (indexes.length === 0) continue
+
+      const recordlen = 96 + pubkeylen
+      const inputs = new Uint8Array(indexes.length * recordlen)
+      for (let j = 0; j < indexes.length; ++j) {
+        const { signature, msg32, pubkey } = records[indexes[j]]
+        inputs.set(signature, j * recordlen)
+        inputs.set(msg32, j * recordlen + 64)
+        inputs.set(pubkey, j * recordlen + 96)
+      }
+
+      const statuses = await this.secp256k1.ecdsaVerifyManyAsync(
+        inputs,
+        indexes.length,
+        pubkeylen === 33,
+        this.threads
+      )
+      for (let j = 0; j < indexes.length; ++j) {
+        const record = records[indexes[j]]
+        results[indexes[j]] = { record, valid: statuses[j] === 0 }
+      }
+    }
+
+    return results
+  }
+
+  // Batch verification started right away (or when the oldest batch settles
+  // if concurrency batches are in flight), results pushed only after all
+  // previous batches, so order of records is kept
+  dispatch () {
+    if (this.timer !== null) clearTimeout(this.timer)
+    this.timer = null
+    if (this.pending.length === 0) return
+
+    if (this.inflight.length >= this.concurrency) {
+      this.overdue = true
+      return
+    }
+
+    const records = this.pending
+    this.pending = []
+    this.overdue = false
+
+    const previous = this.inflight[this.inflight.length - 1]
+    const verified = this.verify(records)
+    const done = Promise.all([verified, previous]).then(([results]) => {
+      this.inflight.shift()
+      if (this.destroyed) return
+      for (const result of results) this.push(result)
+      if (this.overdue) this.dispatch()
+    })
+    done.catch((err) => this.destroy(err))
+    this.inflight.push(done)
+  }
+}
+
+// Async iterator front-end: records taken from (async) iterable and written
+// with respect to backpressure, results yielded in order
+async function * verifyIterable (secp256k1, source, options) {
+  const stream = new ECDSAVerifyStream(secp256k1, options)
+
+  const feed = (async () => {
+    for await (const record of source) {
+      if (stream.destroyed) return
+      if (!stream.write(record)) {
+        await new Promise((resolve) => {
+          const done = () => {
+            stream.removeListener('drain', done)
+            stream.removeListener('close', done)
+            resolve()
+          }
+          stream.on('drain', done)
+          stream.on('close', done)
+        })
+      }
+    }
+    stream.end()
+  })().catch((err) => stream.destroy(err))
+
+  try {
+    yield * stream
+  } finally {
+    stream.destroy()
+    await feed
+  }
+}
+
+module.exports = {
+  ECDSAVerifyStream,
+  verifyIterable,
+}
@@ -1,9 +1,44 @@
 const secp256k1Wrapper = require('./secp256k1')
+const pool = require('./pool')
+const wasmBin = require('./wasm-bin')
 
-module.exports = async () => {
-  const code = await require('./wasm-bin')
-  const { heapu8, heap32, importObject, exportMap } = require('./wasm-glue')
-  const { instance } = await WebAssembly.instantiate(code, importObject)
+// Glue depends from compiled file (memory layout), so it's per variant
+function requireGlue (variant) {
+  return variant === 'simd'
+    ? require('./wasm-glue-simd')
+    : require('./wasm-glue')
+}
+
+// Compiled modules by file name: compilation is done once per process, every
+// instance (main thread and workers from ./pool.js) created from same module
+const modules = new Map()
+function compileCached (name) {
+  if (!modules.has(name)) {
+    const promise = wasmBin.compile(name)
+    promise.catch(() => modules.delete(name))
+    modules.set(name, promise)
+  }
+
+  return modules.get(name)
+}
+
+// SIMD variant used if engine can compile it (SIMD support and same opcodes
+// as in Emscripten which build it), can be disabled by FCRYPTO_WASM_SIMD=0
+async function compile () {
+  const env = typeof process === 'undefined' ? {} : process.env
+  if (env.FCRYPTO_WASM_SIMD !== '0') {
+    try {
+      const wasmModule = await compileCached('fcrypto-simd')
+      return { wasmModule, variant: 'simd' }
+    } catch (err) {}
+  }
+
+  return { wasmModule: await compileCached('fcrypto'), variant: 'base' }
+}
+
+async function instantiate (wasmModule, variant) {
+  const { heapu8, heap32, importObject, exportMap } = requireGlue(variant)
+  const instance = await WebAssembly.instantiate(wasmModule, importObject)
 
   const fns = {}
   for (const [fnFull, fnShort] of Object.entries(exportMap)) {
@@ -13,13 +48,39 @@ module.exports = async () => {
   // TODO:
   // Is it possible to work in big-endian? Need add check with throwing error?
 
-  const env = {
+  return {
     fns,
     heapu8,
     heap32,
   }
+}
+
+async function load () {
+  const { wasmModule, variant } = await compile()
+
+  const env = await instantiate(wasmModule, variant)
+  env.pool = pool.create(wasmModule, variant)
+  env.variant = variant
 
   return {
     Secp256k1: secp256k1Wrapper(env),
+    variant,
   }
 }
+
+// One instance of module for process (thread): memory and context with
+// precomputed tables are shared by every `load` call
+let loading = null
+module.exports = () => {
+  if (loading === null) {
+    loading = load().catch((err) => {
+      loading = null
+      throw err
+    })
+  }
+
+  return loading
+}
+
+module.exports.compile = compile
+module.exports.instantiate = instantiate
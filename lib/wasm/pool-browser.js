@@ -0,0 +1,5 @@
+// Blocking calling thread with Atomics.wait not allowed on main thread in
+// browsers, so bulk functions are always single-threaded there
+module.exports = {
+  create: () => null,
+}
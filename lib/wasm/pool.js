@@ -0,0 +1,135 @@
+const os = require('os')
+const path = require('path')
+
+// Take chunks of batch with atomic counter until nothing left, same function
+// used by calling thread and by workers. Control: [next item, done chunks,
+// failed flag].
+function processChunks (secp256k1, task) {
+  const { method, control, n, chunk } = task
+  const inputs = new Uint8Array(task.inputs)
+  const statuses = new Uint8Array(task.statuses)
+  const output = task.output === null ? null : new Uint8Array(task.output)
+  const recordlen = inputs.length / n
+  const outputlen = output === null ? 0 : output.length / n
+
+  for (;;) {
+    const begin = Atomics.add(control, 0, chunk)
+    if (begin >= n) return
+
+    const end = Math.min(begin + chunk, n)
+    try {
+      const args = [
+        statuses.subarray(begin, end),
+        inputs.subarray(begin * recordlen, end * recordlen),
+      ]
+      if (output !== null) {
+        args.unshift(output.subarray(begin * outputlen, end * outputlen))
+      }
+
+      secp256k1[method](...args, ...task.args)
+    } catch (err) {
+      Atomics.store(control, 2, 1)
+    }
+
+    Atomics.add(control, 1, 1)
+    Atomics.notify(control, 1)
+  }
+}
+
+function toShared (arr) {
+  const shared = new Uint8Array(new SharedArrayBuffer(arr.length))
+  shared.set(arr, 0)
+  return shared.buffer
+}
+
+// Every worker has own instance of compiled module (own memory and context),
+// input and output passed through SharedArrayBuffer. Calling thread blocked
+// with Atomics.wait, so bulk functions stay synchronous.
+class WorkerPool {
+  constructor (wasmModule, variant, workerThreads) {
+    this.wasmModule = wasmModule
+    this.variant = variant
+    this.workerThreads = workerThreads
+    this.workers = []
+    this.size = os.cpus().length
+  }
+
+  getWorkers (count) {
+    while (this.workers.length < count) {
+      const filename = path.join(__dirname, 'worker.js')
+      const workerData = {
+        wasmModule: this.wasmModule,
+        variant: this.variant,
+      }
+      const worker = new this.workerThreads.Worker(filename, { workerData })
+      worker.unref()
+      // Dead worker dropped from pool, chunks posted to it are processed by
+      // other participants, because chunks taken with atomic counter
+      const drop = () => {
+        const index = this.workers.indexOf(worker)
+        if (index !== -1) this.workers.splice(index, 1)
+      }
+      worker.on('error', drop)
+      worker.on('exit', drop)
+      this.workers.push(worker)
+    }
+
+    return this.workers.slice(0, count)
+  }
+
+  // `local` is instance on calling thread, `method` is bulk method without
+  // threads argument: (output?, statuses, inputs, ...args)
+  run (local, method, output, statuses, inputs, threads, args = []) {
+    const n = statuses.length
+    threads = Math.min(threads, this.size, n)
+
+    const chunk = Math.max(1, Math.ceil(n / (threads * 8)))
+    const chunks = Math.ceil(n / chunk)
+    const task = {
+      method,
+      args,
+      control: new Int32Array(new SharedArrayBuffer(12)),
+      n,
+      chunk,
+      inputs: toShared(inputs),
+      output: output === null ? null : new SharedArrayBuffer(output.length),
+      statuses: new SharedArrayBuffer(n),
+    }
+
+    for (const worker of this.getWorkers(threads - 1)) worker.postMessage(task)
+    processChunks(local, task)
+
+    const { control } = task
+    for (;;) {
+      const done = Atomics.load(control, 1)
+      if (done === chunks) break
+      Atomics.wait(control, 1, done)
+    }
+
+    if (Atomics.load(control, 2) !== 0) {
+      throw new Error('Bulk call failed in WebAssembly worker')
+    }
+
+    if (output !== null) output.set(new Uint8Array(task.output), 0)
+    statuses.set(new Uint8Array(task.statuses), 0)
+    return statuses.some((status) => status !== 0) ? 1 : 0
+  }
+}
+
+// Pool is not available without SharedArrayBuffer or worker_threads (Node.js
+// below 11.7 without flag), single-threaded code used in this case
+function create (wasmModule, variant) {
+  if (typeof SharedArrayBuffer === 'undefined') return null
+  if (typeof Atomics === 'undefined') return null
+
+  try {
+    return new WorkerPool(wasmModule, variant, require('worker_threads'))
+  } catch (err) {
+    return null
+  }
+}
+
+module.exports = {
+  create,
+  processChunks,
+}
@@ -1,7 +1,38 @@
-module.exports = ({ fns, heapu8, heap32 }) => {
+const Stats = require('./stats')
+
+module.exports = ({ fns, heapu8, heap32, pool = null, variant }) => {
+  // Parsed public keys (64 bytes) are available only through WeakMap, so
+  // handle can not be created from arbitrary bytes (not a point on curve)
+  const parsedPubkeys = new WeakMap()
+  function loadPubkey (pubkey) {
+    if (pubkey instanceof Uint8Array) return pubkey
+
+    const data = parsedPubkeys.get(pubkey)
+    if (data === undefined) throw new TypeError('Expected public key')
+    return data
+  }
+
+  // Prepared verifiers: handle => pointer to table in WASM heap. Memory is not
+  // freed by GC, only with ecdsaVerifierDestroy
+  const verifiers = new WeakMap()
+  function getVerifier (handle) {
+    const ptr = verifiers.get(handle)
+    if (ptr === undefined) throw new TypeError('Expected verifier')
+    if (ptr === 0) throw new Error('Verifier destroyed')
+    return ptr
+  }
+
+  // Context with precomputed tables created on first instance and shared by
+  // all instances of this module, every instance has own clone for
+  // randomization (without tables)
+  let sharedCtx = 0
+
   return class Secp256k1 {
     constructor () {
-      this.ctx = fns.fcrypto_secp256k1_context_create()
+      if (sharedCtx === 0) sharedCtx = fns.fcrypto_secp256k1_context_create()
+      if (sharedCtx === 0) throw new Error('Memory allocation error')
+      this.ctx = fns.fcrypto_secp256k1_context_clone(sharedCtx)
+      if (this.ctx === 0) throw new Error('Memory allocation error')
 
       // I did not find how memory allocated with malloc in WASM,
       // but it's looks like: Math.ceil((requested + 4) / 16) * 16.
@@ -17,6 +48,36 @@ module.exports = ({ fns, heapu8, heap32 }) => {
 
       // For removing sensetive data
       this.z32 = new Uint8Array(32)
+
+      // Temporary data of variable-size calls (combine, batches), shared
+      // with C functions. Reset at the end of every call.
+      this.arena = fns.fcrypto_arena_create(4096)
+      if (this.arena === 0) throw new Error('Memory allocation error')
+
+      // Disabled until statsEnable(true), see ./stats.js
+      this.stats = new Stats(this)
+    }
+
+    buildInfo () {
+      return {
+        ecmultGenPrecBits: fns.fcrypto_secp256k1_ecmult_gen_prec_bits(),
+        ecmultWindowSize: fns.fcrypto_secp256k1_ecmult_window_size(),
+        contextSize: fns.fcrypto_secp256k1_context_size(),
+        staticTables: fns.fcrypto_secp256k1_static_tables() === 1,
+        variant,
+      }
+    }
+
+    statsEnable (enabled) {
+      this.stats.enable(enabled)
+    }
+
+    statsReset () {
+      this.stats.reset()
+    }
+
+    statsSnapshot () {
+      return this.stats.snapshot()
     }
 
     contextRandomize (seed) {
@@ -118,7 +179,26 @@ module.exports = ({ fns, heapu8, heap32 }) => {
       }
     }
 
+    publicKeyParse (obj, pubkey) {
+      heapu8.set(pubkey, this.ptr72)
+
+      const ret = fns.fcrypto_secp256k1_pubkey_parse(
+        this.ctx,
+        this.ptr64,
+        this.ptr72,
+        pubkey.length
+      )
+      if (ret === 0) {
+        obj.handle = Object.freeze({})
+        const data = heapu8.slice(this.ptr64, this.ptr64 + 64)
+        parsedPubkeys.set(obj.handle, data)
+      }
+
+      return ret
+    }
+
     publicKeyConvert (output, pubkey) {
+      pubkey = loadPubkey(pubkey)
       heapu8.set(pubkey, this.ptr72)
 
       const ret = fns.fcrypto_secp256k1_pubkey_convert(
@@ -136,6 +216,7 @@ module.exports = ({ fns, heapu8, heap32 }) => {
     }
 
     publicKeyNegate (output, pubkey) {
+      pubkey = loadPubkey(pubkey)
       heapu8.set(pubkey, this.ptr72)
 
       const ret = fns.fcrypto_secp256k1_pubkey_negate(
@@ -153,25 +234,31 @@ module.exports = ({ fns, heapu8, heap32 }) => {
     }
 
     publicKeyCombine (output, pubkeys) {
-      let keys, inputs, inputslen
+      pubkeys = pubkeys.map(loadPubkey)
+
       try {
         let totallen = 0
         for (let i = 0; i < pubkeys.length; ++i) totallen += pubkeys[i].length
 
         // While wasm is 32bit, pointer size is 4
-        keys = fns.malloc(totallen)
-        inputs = fns.malloc(4 * pubkeys.length) / 4
-        inputslen = fns.malloc(4 * pubkeys.length) / 4
+        const keys = this.arenaAlloc(totallen)
+        const inputs = this.arenaAlloc(4 * pubkeys.length) / 4
+        const inputslen = this.arenaAlloc(4 * pubkeys.length) / 4
+        if (keys === 0 || inputs === 0 || inputslen === 0) return 4
 
+        // Keys can have different length, so offset is a sum of previous
+        let offset = keys
         for (let i = 0; i < pubkeys.length; ++i) {
           const pubkey = pubkeys[i]
-          heap32[inputs + i] = keys + pubkey.length * i
-          heapu8.set(pubkey, heap32[inputs + i])
+          heap32[inputs + i] = offset
+          heapu8.set(pubkey, offset)
           heap32[inputslen + i] = pubkey.length
+          offset += pubkey.length
         }
 
         const ret = fns.fcrypto_secp256k1_pubkey_combine(
           this.ctx,
+          this.arena,
           this.ptr72,
           inputs * 4,
           inputslen * 4,
@@ -184,13 +271,59 @@ module.exports = ({ fns, heapu8, heap32 }) => {
 
         return ret
       } finally {
-        fns.free(keys)
-        fns.free(inputs * 4)
-        fns.free(inputslen * 4)
+        fns.fcrypto_arena_reset(this.arena)
+      }
+    }
+
+    publicKeyLinearCombination (output, pubkeys, scalars, gscalar) {
+      pubkeys = pubkeys.map(loadPubkey)
+
+      try {
+        let totallen = 0
+        for (let i = 0; i < pubkeys.length; ++i) totallen += pubkeys[i].length
+
+        const keys = this.arenaAlloc(totallen)
+        const inputs = this.arenaAlloc(4 * pubkeys.length) / 4
+        const inputslen = this.arenaAlloc(4 * pubkeys.length) / 4
+        const scalarsptr = this.arenaAlloc(scalars.length)
+        if (keys === 0 || inputs === 0 || inputslen === 0 || scalarsptr === 0) {
+          return 4
+        }
+
+        let offset = keys
+        for (let i = 0; i < pubkeys.length; ++i) {
+          const pubkey = pubkeys[i]
+          heap32[inputs + i] = offset
+          heapu8.set(pubkey, offset)
+          heap32[inputslen + i] = pubkey.length
+          offset += pubkey.length
+        }
+        heapu8.set(scalars, scalarsptr)
+        if (gscalar !== null) heapu8.set(gscalar, this.ptr32)
+
+        const ret = fns.fcrypto_secp256k1_pubkey_linear_combination(
+          this.ctx,
+          this.arena,
+          this.ptr72,
+          inputs * 4,
+          inputslen * 4,
+          scalarsptr,
+          gscalar === null ? 0 : this.ptr32,
+          pubkeys.length,
+          output.length
+        )
+        if (ret === 0) {
+          output.set(heapu8.subarray(this.ptr72, this.ptr72 + output.length), 0)
+        }
+
+        return ret
+      } finally {
+        fns.fcrypto_arena_reset(this.arena)
       }
     }
 
     publicKeyTweakAdd (output, pubkey, tweak) {
+      pubkey = loadPubkey(pubkey)
       try {
         heapu8.set(pubkey, this.ptr72)
         heapu8.set(tweak, this.ptr32)
@@ -215,6 +348,7 @@ module.exports = ({ fns, heapu8, heap32 }) => {
     }
 
     publicKeyTweakMul (output, pubkey, tweak) {
+      pubkey = loadPubkey(pubkey)
       try {
         heapu8.set(pubkey, this.ptr72)
         heapu8.set(tweak, this.ptr32)
@@ -310,6 +444,7 @@ module.exports = ({ fns, heapu8, heap32 }) => {
     }
 
     ecdsaVerify (sig, msg32, pubkey) {
+      pubkey = loadPubkey(pubkey)
       heapu8.set(sig, this.ptr64)
       heapu8.set(msg32, this.ptr32)
       heapu8.set(pubkey, this.ptr72)
@@ -323,6 +458,153 @@ module.exports = ({ fns, heapu8, heap32 }) => {
       )
     }
 
+    // Message can be any length, placed in arena
+    ecdsaSignMessage (obj, msg, seckey, hash) {
+      try {
+        const msgptr = this.arenaAlloc(msg.length)
+        if (msgptr === 0) throw new Error('Memory allocation error')
+        heapu8.set(msg, msgptr)
+        heapu8.set(seckey, this.ptr32)
+
+        const ret = fns.fcrypto_secp256k1_ecdsa_sign_message(
+          this.ctx,
+          this.ptr64,
+          this.ptr4,
+          msgptr,
+          msg.length,
+          this.ptr32,
+          hash
+        )
+        if (ret === 0) {
+          obj.signature.set(heapu8.subarray(this.ptr64, this.ptr64 + 64), 0)
+          obj.recid = heap32[this.ptr4 / 4]
+        }
+
+        return ret
+      } finally {
+        heapu8.set(this.z32, this.ptr32)
+        fns.fcrypto_arena_reset(this.arena)
+      }
+    }
+
+    ecdsaVerifyMessage (sig, msg, pubkey, hash) {
+      pubkey = loadPubkey(pubkey)
+      try {
+        const msgptr = this.arenaAlloc(msg.length)
+        if (msgptr === 0) throw new Error('Memory allocation error')
+        heapu8.set(msg, msgptr)
+        heapu8.set(sig, this.ptr64)
+        heapu8.set(pubkey, this.ptr72)
+
+        return fns.fcrypto_secp256k1_ecdsa_verify_message(
+          this.ctx,
+          this.ptr64,
+          msgptr,
+          msg.length,
+          this.ptr72,
+          pubkey.length,
+          hash
+        )
+      } finally {
+        fns.fcrypto_arena_reset(this.arena)
+      }
+    }
+
+    ecdsaVerifierCreate (obj, pubkey) {
+      pubkey = loadPubkey(pubkey)
+
+      const ptr = fns.malloc(fns.fcrypto_secp256k1_verifier_size())
+      if (ptr === 0) return 2
+
+      heapu8.set(pubkey, this.ptr72)
+      const ret = fns.fcrypto_secp256k1_verifier_init(
+        this.ctx,
+        ptr,
+        this.ptr72,
+        pubkey.length
+      )
+      if (ret === 0) {
+        obj.handle = Object.freeze({})
+        verifiers.set(obj.handle, ptr)
+      } else {
+        fns.free(ptr)
+      }
+
+      return ret
+    }
+
+    ecdsaVerifierDestroy (handle) {
+      fns.free(getVerifier(handle))
+      verifiers.set(handle, 0)
+    }
+
+    ecdsaVerifyPrepared (sig, msg32, handle) {
+      const ptr = getVerifier(handle)
+      heapu8.set(sig, this.ptr64)
+      heapu8.set(msg32, this.ptr32)
+
+      return fns.fcrypto_secp256k1_ecdsa_verify_prepared(
+        this.ctx,
+        this.ptr64,
+        this.ptr32,
+        ptr
+      )
+    }
+
+    ecdsaVerifyBatch (results, sigs, recids, msgs32, pubkeys) {
+      pubkeys = pubkeys.map(loadPubkey)
+      const n = sigs.length
+      try {
+        let keyslen = 0
+        for (let i = 0; i < n; ++i) keyslen += pubkeys[i].length
+
+        // One area: 5 arrays of pointers / integers (4 bytes in wasm32),
+        // then signatures, messages, public keys and results.
+        const ptr = this.arenaAlloc(20 * n + 96 * n + keyslen + n)
+        if (ptr === 0) return 2
+        const sigsptr = ptr / 4
+        const recidsptr = sigsptr + n
+        const msgsptr = recidsptr + n
+        const inputs = msgsptr + n
+        const inputslen = inputs + n
+
+        let offset = ptr + 20 * n
+        for (let i = 0; i < n; ++i) {
+          heap32[sigsptr + i] = offset
+          heapu8.set(sigs[i], offset)
+          offset += 64
+
+          heap32[recidsptr + i] = recids[i]
+
+          heap32[msgsptr + i] = offset
+          heapu8.set(msgs32[i], offset)
+          offset += 32
+
+          heap32[inputs + i] = offset
+          heapu8.set(pubkeys[i], offset)
+          heap32[inputslen + i] = pubkeys[i].length
+          offset += pubkeys[i].length
+        }
+
+        const ret = fns.fcrypto_secp256k1_ecdsa_verify_batch(
+          this.ctx,
+          this.arena,
+          offset,
+          sigsptr * 4,
+          recidsptr * 4,
+          msgsptr * 4,
+          inputs * 4,
+          inputslen * 4,
+          n
+        )
+        results.set(heapu8.subarray(offset, offset + n), 0)
+
+        return ret
+      } finally {
+        fns.fcrypto_arena_reset(this.arena)
+      }
+    }
+
     ecdsaRecover (output, sig, recid, msg32) {
       heapu8.set(sig, this.ptr64)
       heapu8.set(msg32, this.ptr32)
@@ -342,16 +624,32 @@ module.exports = ({ fns, heapu8, heap32 }) => {
       return ret
     }
 
-    ecdh (output, pubkey, seckey) {
+    ecdsaRecoverAddress (output, sig, recid, msg32, type) {
+      heapu8.set(sig, this.ptr64)
+      heapu8.set(msg32, this.ptr32)
+
+      const ret = fns.fcrypto_secp256k1_ecdsa_recover_address(
+        this.ctx,
+        this.ptr72,
+        this.ptr64,
+        recid,
+        this.ptr32,
+        type
+      )
+      if (ret === 0) {
+        output.set(heapu8.subarray(this.ptr72, this.ptr72 + 20), 0)
+      }
+
+      return ret
+    }
+
+    xOnlyPublicKeyCreate (output, seckey) {
       try {
-        heapu8.set(pubkey, this.ptr72)
         heapu8.set(seckey, this.ptr32)
 
-        const ret = fns.fcrypto_secp256k1_ecdh(
+        const ret = fns.fcrypto_secp256k1_xonly_pubkey_create(
           this.ctx,
           this.ptr64,
-          this.ptr72,
-          pubkey.length,
           this.ptr32
         )
         if (ret === 0) {
@@ -363,5 +661,523 @@ module.exports = ({ fns, heapu8, heap32 }) => {
         heapu8.set(this.z32, this.ptr32)
       }
     }
+
+    xOnlyPublicKeyConvert (output, pubkey) {
+      pubkey = loadPubkey(pubkey)
+      heapu8.set(pubkey, this.ptr72)
+
+      const ret = fns.fcrypto_secp256k1_xonly_pubkey_convert(
+        this.ctx,
+        this.ptr32,
+        this.ptr72,
+        pubkey.length
+      )
+      if (ret === 0) {
+        output.set(heapu8.subarray(this.ptr32, this.ptr32 + 32), 0)
+      }
+
+      return ret
+    }
+
+    // Message and auxiliary data in ptr72, secret key in ptr32
+    schnorrSign (output, msg32, seckey, auxrand32) {
+      try {
+        heapu8.set(msg32, this.ptr72)
+        if (auxrand32 !== null) heapu8.set(auxrand32, this.ptr72 + 32)
+        heapu8.set(seckey, this.ptr32)
+
+        const ret = fns.fcrypto_secp256k1_schnorr_sign(
+          this.ctx,
+          this.ptr64,
+          this.ptr72,
+          this.ptr32,
+          auxrand32 === null ? 0 : this.ptr72 + 32
+        )
+        if (ret === 0) {
+          output.set(heapu8.subarray(this.ptr64, this.ptr64 + 64), 0)
+        }
+
+        return ret
+      } finally {
+        heapu8.set(this.z32, this.ptr32)
+      }
+    }
+
+    schnorrVerify (sig, msg32, pubkey) {
+      heapu8.set(sig, this.ptr64)
+      heapu8.set(msg32, this.ptr32)
+      heapu8.set(pubkey, this.ptr72)
+
+      return fns.fcrypto_secp256k1_schnorr_verify(
+        this.ctx,
+        this.ptr64,
+        this.ptr32,
+        this.ptr72
+      )
+    }
+
+    schnorrVerifyBatch (results, inputs, batchSize) {
+      const n = results.length
+      try {
+        const ptr = this.arenaAlloc(inputs.length + n)
+        if (ptr === 0) return 2
+        heapu8.set(inputs, ptr)
+
+        const ret = fns.fcrypto_secp256k1_schnorr_verify_batch(
+          this.ctx,
+          this.arena,
+          ptr + inputs.length,
+          ptr,
+          n,
+          batchSize
+        )
+        const offset = ptr + inputs.length
+        results.set(heapu8.subarray(offset, offset + n), 0)
+
+        return ret
+      } finally {
+        fns.fcrypto_arena_reset(this.arena)
+      }
+    }
+
+    // Uncompressed point (65 bytes) does not fit to ptr64, placed in arena
+    ecdh (output, pubkey, seckey, mode) {
+      pubkey = loadPubkey(pubkey)
+      let outputptr = this.ptr64
+      try {
+        if (output.length > 64) {
+          outputptr = this.arenaAlloc(output.length)
+          if (outputptr === 0) throw new Error('Memory allocation error')
+        }
+        heapu8.set(pubkey, this.ptr72)
+        heapu8.set(seckey, this.ptr32)
+
+        const ret = fns.fcrypto_secp256k1_ecdh_mode(
+          this.ctx,
+          outputptr,
+          this.ptr72,
+          pubkey.length,
+          this.ptr32,
+          mode
+        )
+        if (ret === 0) {
+          output.set(heapu8.subarray(outputptr, outputptr + output.length), 0)
+        }
+
+        return ret
+      } finally {
+        heapu8.set(this.z32, this.ptr32)
+        if (outputptr !== 0) {
+          heapu8.fill(0, outputptr, outputptr + output.length)
+        }
+        fns.fcrypto_arena_reset(this.arena)
+      }
+    }
+
+    arenaAlloc (size) {
+      return fns.fcrypto_arena_alloc(this.arena, size)
+    }
+
+    // Staging: long-lived areas in heap allocated by user (see Staging in
+    // ../secp256k1.js). Functions below receive pointers to these areas, so
+    // nothing is copied and nothing is wiped here.
+    stagingAlloc (size) {
+      return fns.malloc(size)
+    }
+
+    stagingFree (ptr) {
+      fns.free(ptr)
+    }
+
+    stagingView (ptr, size) {
+      return heapu8.subarray(ptr, ptr + size)
+    }
+
+    publicKeyCreateStaged (output, outputlen, seckey) {
+      return fns.fcrypto_secp256k1_pubkey_create(
+        this.ctx,
+        output,
+        seckey,
+        outputlen
+      )
+    }
+
+    ecdsaSignStaged (obj, output, msg32, seckey) {
+      const ret = fns.fcrypto_secp256k1_ecdsa_sign(
+        this.ctx,
+        output,
+        this.ptr4,
+        msg32,
+        seckey
+      )
+      if (ret === 0) obj.recid = heap32[this.ptr4 / 4]
+
+      return ret
+    }
+
+    ecdsaVerifyStaged (sig, msg32, pubkey, pubkeylen) {
+      return fns.fcrypto_secp256k1_ecdsa_verify(
+        this.ctx,
+        sig,
+        msg32,
+        pubkey,
+        pubkeylen
+      )
+    }
+
+    ecdsaRecoverStaged (output, outputlen, sig, recid, msg32) {
+      return fns.fcrypto_secp256k1_ecdsa_recover(
+        this.ctx,
+        output,
+        sig,
+        recid,
+        msg32,
+        outputlen
+      )
+    }
+
+    ecdhStaged (output, pubkey, pubkeylen, seckey) {
+      return fns.fcrypto_secp256k1_ecdh(
+        this.ctx,
+        output,
+        pubkey,
+        pubkeylen,
+        seckey
+      )
+    }
+
+    // Bulk functions: inputs, output and statuses placed in one area.
+    // `fn` receive pointers to output, statuses and inputs.
+    // Addon accept number of threads as last argument. Here it's used only by
+    // verify and recover (no secret data), batch split between worker_threads
+    // if SharedArrayBuffer is available, see ./pool.js
+    callMany (output, statuses, inputs, secret, fn) {
+      const outputlen = output === null ? 0 : output.length
+      let ptr = 0
+      try {
+        ptr = this.arenaAlloc(inputs.length + outputlen + statuses.length)
+        if (ptr === 0) throw new Error('Memory allocation error')
+        const inputsptr = ptr
+        const outputptr = inputsptr + inputs.length
+        const statusesptr = outputptr + outputlen
+        heapu8.set(inputs, inputsptr)
+
+        const ret = fn(outputptr, statusesptr, inputsptr)
+        if (output !== null) {
+          output.set(heapu8.subarray(outputptr, outputptr + outputlen), 0)
+        }
+        const end = statusesptr + statuses.length
+        statuses.set(heapu8.subarray(statusesptr, end), 0)
+
+        return ret
+      } finally {
+        // Outputs can be secret too (ECDH secrets, BIP32 private keys)
+        if (secret && ptr !== 0) {
+          heapu8.fill(0, ptr, ptr + inputs.length + outputlen)
+        }
+        fns.fcrypto_arena_reset(this.arena)
+      }
+    }
+
+    privateKeyVerifyMany (statuses, seckeys) {
+      return this.callMany(null, statuses, seckeys, true, (_, sptr, iptr) => {
+        return fns.fcrypto_secp256k1_seckey_verify_many(
+          this.ctx,
+          sptr,
+          iptr,
+          statuses.length
+        )
+      })
+    }
+
+    publicKeyCreateMany (output, statuses, seckeys) {
+      return this.callMany(output, statuses, seckeys, true, (...ptrs) => {
+        return fns.fcrypto_secp256k1_pubkey_create_many(
+          this.ctx,
+          ...ptrs,
+          statuses.length,
+          output.length / statuses.length
+        )
+      })
+    }
+
+    publicKeyCreateRange (output, statuses, seckey) {
+      return this.callMany(output, statuses, seckey, true, (...ptrs) => {
+        return fns.fcrypto_secp256k1_pubkey_create_range(
+          this.ctx,
+          ...ptrs,
+          statuses.length,
+          output.length / statuses.length
+        )
+      })
+    }
+
+    ecdsaSignMany (output, statuses, inputs) {
+      return this.callMany(output, statuses, inputs, true, (...ptrs) => {
+        return fns.fcrypto_secp256k1_ecdsa_sign_many(
+          this.ctx,
+          ...ptrs,
+          statuses.length
+        )
+      })
+    }
+
+    // Offsets (bytes of Uint32Array) placed first, arena pointers are aligned
+    ecdsaSignMessageMany (output, statuses, seckeys, msgs, offsets, hash) {
+      const size =
+        offsets.length + seckeys.length + msgs.length + output.length
+      let ptr = 0
+      try {
+        ptr = this.arenaAlloc(size + statuses.length)
+        if (ptr === 0) throw new Error('Memory allocation error')
+        const seckeysptr = ptr + offsets.length
+        const msgsptr = seckeysptr + seckeys.length
+        const outputptr = msgsptr + msgs.length
+        const statusesptr = outputptr + output.length
+        heapu8.set(offsets, ptr)
+        heapu8.set(seckeys, seckeysptr)
+        heapu8.set(msgs, msgsptr)
+
+        const ret = fns.fcrypto_secp256k1_ecdsa_sign_message_many(
+          this.ctx,
+          outputptr,
+          statusesptr,
+          seckeysptr,
+          msgsptr,
+          ptr,
+          statuses.length,
+          hash
+        )
+        output.set(heapu8.subarray(outputptr, statusesptr), 0)
+        const end = statusesptr + statuses.length
+        statuses.set(heapu8.subarray(statusesptr, end), 0)
+
+        return ret
+      } finally {
+        if (ptr !== 0) heapu8.fill(0, ptr, ptr + size)
+        fns.fcrypto_arena_reset(this.arena)
+      }
+    }
+
+    ecdsaVerifyMessageMany (statuses, inputs, msgs, offsets, hash) {
+      try {
+        const size = offsets.length + inputs.length + msgs.length
+        const ptr = this.arenaAlloc(size + statuses.length)
+        if (ptr === 0) throw new Error('Memory allocation error')
+        const inputsptr = ptr + offsets.length
+        const msgsptr = inputsptr + inputs.length
+        const statusesptr = msgsptr + msgs.length
+        heapu8.set(offsets, ptr)
+        heapu8.set(inputs, inputsptr)
+        heapu8.set(msgs, msgsptr)
+
+        const ret = fns.fcrypto_secp256k1_ecdsa_verify_message_many(
+          this.ctx,
+          statusesptr,
+          inputsptr,
+          msgsptr,
+          ptr,
+          statuses.length,
+          inputs.length / statuses.length - 64,
+          hash
+        )
+        const end = statusesptr + statuses.length
+        statuses.set(heapu8.subarray(statusesptr, end), 0)
+
+        return ret
+      } finally {
+        fns.fcrypto_arena_reset(this.arena)
+      }
+    }
+
+    ecdsaRecoverMany (output, statuses, inputs, threads = 1) {
+      if (threads > 1 && pool !== null) {
+        return pool.run(
+          this,
+          'ecdsaRecoverMany',
+          output,
+          statuses,
+          inputs,
+          threads
+        )
+      }
+
+      return this.callMany(output, statuses, inputs, false, (...ptrs) => {
+        return fns.fcrypto_secp256k1_ecdsa_recover_many(
+          this.ctx,
+          ...ptrs,
+          statuses.length,
+          output.length / statuses.length
+        )
+      })
+    }
+
+    ecdsaRecoverAddressMany (output, statuses, inputs, type, threads = 1) {
+      if (threads > 1 && pool !== null) {
+        return pool.run(
+          this,
+          'ecdsaRecoverAddressMany',
+          output,
+          statuses,
+          inputs,
+          threads,
+          [type]
+        )
+      }
+
+      return this.callMany(output, statuses, inputs, false, (...ptrs) => {
+        return fns.fcrypto_secp256k1_ecdsa_recover_address_many(
+          this.ctx,
+          ...ptrs,
+          statuses.length,
+          type
+        )
+      })
+    }
+
+    ecdsaVerifyMany (statuses, inputs, threads = 1) {
+      if (threads > 1 && pool !== null) {
+        return pool.run(
+          this,
+          'ecdsaVerifyMany',
+          null,
+          statuses,
+          inputs,
+          threads
+        )
+      }
+
+      return this.callMany(null, statuses, inputs, false, (_, sptr, iptr) => {
+        return fns.fcrypto_secp256k1_ecdsa_verify_many(
+          this.ctx,
+          sptr,
+          iptr,
+          statuses.length,
+          inputs.length / statuses.length - 96
+        )
+      })
+    }
+
+    ecdhMany (output, statuses, inputs) {
+      return this.callMany(output, statuses, inputs, true, (...ptrs) => {
+        return fns.fcrypto_secp256k1_ecdh_many(
+          this.ctx,
+          ...ptrs,
+          statuses.length,
+          inputs.length / statuses.length - 32
+        )
+      })
+    }
+
+    ecdhPubkeysMany (output, statuses, seckey, inputs, mode) {
+      try {
+        heapu8.set(seckey, this.ptr32)
+        return this.callMany(output, statuses, inputs, true, (...ptrs) => {
+          const [outputptr, statusesptr, inputsptr] = ptrs
+          return fns.fcrypto_secp256k1_ecdh_pubkeys_many(
+            this.ctx,
+            outputptr,
+            statusesptr,
+            this.ptr32,
+            inputsptr,
+            statuses.length,
+            inputs.length / statuses.length,
+            mode
+          )
+        })
+      } finally {
+        heapu8.set(this.z32, this.ptr32)
+      }
+    }
+
+    // BIP32, path is bytes of Uint32Array (little endian, same as WASM)
+    bip32FromSeed (output, seed) {
+      let ptr = 0
+      try {
+        ptr = this.arenaAlloc(64 + seed.length)
+        if (ptr === 0) throw new Error('Memory allocation error')
+        heapu8.set(seed, ptr + 64)
+
+        const ret = fns.fcrypto_bip32_from_seed(
+          this.ctx,
+          ptr,
+          ptr + 64,
+          seed.length
+        )
+        if (ret === 0) output.set(heapu8.subarray(ptr, ptr + 64), 0)
+
+        return ret
+      } finally {
+        if (ptr !== 0) heapu8.fill(0, ptr, ptr + 64 + seed.length)
+        fns.fcrypto_arena_reset(this.arena)
+      }
+    }
+
+    bip32Derive (output, xkey, path) {
+      const size = path.length + xkey.length + output.length
+      let ptr = 0
+      try {
+        // Path first, arena pointers are aligned
+        ptr = this.arenaAlloc(size)
+        if (ptr === 0) throw new Error('Memory allocation error')
+        const xkeyptr = ptr + path.length
+        const outputptr = xkeyptr + xkey.length
+        heapu8.set(path, ptr)
+        heapu8.set(xkey, xkeyptr)
+
+        const ret = fns.fcrypto_bip32_derive(
+          this.ctx,
+          outputptr,
+          output.length,
+          xkeyptr,
+          xkey.length,
+          ptr,
+          path.length / 4
+        )
+        if (ret === 0) {
+          output.set(heapu8.subarray(outputptr, outputptr + output.length), 0)
+        }
+
+        return ret
+      } finally {
+        if (ptr !== 0) heapu8.fill(0, ptr, ptr + size)
+        fns.fcrypto_arena_reset(this.arena)
+      }
+    }
+
+    bip32DeriveRange (output, statuses, xkey, index) {
+      return this.callMany(output, statuses, xkey, true, (...ptrs) => {
+        return fns.fcrypto_bip32_derive_range(
+          this.ctx,
+          ...ptrs,
+          xkey.length,
+          index,
+          statuses.length,
+          output.length / statuses.length
+        )
+      })
+    }
+
+    // WebAssembly do not have threads, so async methods only for same API
+    async ecdsaSignAsync (obj, msg32, seckey) {
+      return this.ecdsaSign(obj, msg32, seckey)
+    }
+
+    async ecdsaVerifyAsync (sig, msg32, pubkey) {
+      return this.ecdsaVerify(sig, msg32, pubkey)
+    }
+
+    async ecdsaRecoverAsync (output, sig, recid, msg32) {
+      return this.ecdsaRecover(output, sig, recid, msg32)
+    }
+
+    async ecdhAsync (output, pubkey, seckey) {
+      return this.ecdh(output, pubkey, seckey, 0)
+    }
+
+    // Worker pool (if threads > 1) blocks calling thread until batch is done
+    async ecdsaVerifyManyAsync (statuses, inputs, threads = 1) {
+      return this.ecdsaVerifyMany(statuses, inputs, threads)
+    }
   }
 }
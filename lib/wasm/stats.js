@@ -0,0 +1,195 @@
+// Per-method counters of WebAssembly version, same snapshot as AddonStats in
+// src/addon/stats.h: calls, return codes and latency histogram where bucket 0
+// is 0ns, bucket i is [2^(i-1), 2^i) ns and last bucket has no upper bound.
+// Methods wrapped only while stats are enabled: wrappers are own properties
+// of instance which shadow methods of class, on disable they are deleted, so
+// disabled stats cost nothing.
+const kCodes = 8
+const kBuckets = 40
+
+// Method => name in snapshot. Staged versions counted as regular methods,
+// because in addon staging is plain Uint8Array and regular methods are used.
+const methods = {}
+for (const name of [
+  'contextRandomize',
+  'privateKeyVerify',
+  'privateKeyNegate',
+  'privateKeyTweakAdd',
+  'privateKeyTweakMul',
+  'publicKeyCreate',
+  'publicKeyParse',
+  'publicKeyConvert',
+  'publicKeyNegate',
+  'publicKeyCombine',
+  'publicKeyLinearCombination',
+  'publicKeyTweakAdd',
+  'publicKeyTweakMul',
+  'signatureNormalize',
+  'signatureExport',
+  'signatureImport',
+  'ecdsaSign',
+  'ecdsaVerify',
+  'ecdsaSignMessage',
+  'ecdsaVerifyMessage',
+  'ecdsaVerifyBatch',
+  'ecdsaVerifierCreate',
+  'ecdsaVerifyPrepared',
+  'ecdsaRecover',
+  'ecdsaRecoverAddress',
+  'xOnlyPublicKeyCreate',
+  'xOnlyPublicKeyConvert',
+  'schnorrSign',
+  'schnorrVerify',
+  'schnorrVerifyBatch',
+  'ecdh',
+  'privateKeyVerifyMany',
+  'publicKeyCreateMany',
+  'publicKeyCreateRange',
+  'ecdsaSignMany',
+  'ecdsaVerifyMany',
+  'ecdsaSignMessageMany',
+  'ecdsaVerifyMessageMany',
+  'ecdsaRecoverMany',
+  'ecdsaRecoverAddressMany',
+  'ecdhMany',
+  'ecdhPubkeysMany',
+  'bip32FromSeed',
+  'bip32Derive',
+  'bip32DeriveRange',
+  'ecdsaSignAsync',
+  'ecdsaVerifyAsync',
+  'ecdsaRecoverAsync',
+  'ecdhAsync',
+  'ecdsaVerifyManyAsync',
+]) {
+  methods[name] = name
+}
+for (const name of [
+  'publicKeyCreate',
+  'ecdsaSign',
+  'ecdsaVerify',
+  'ecdsaRecover',
+  'ecdh',
+]) {
+  methods[`${name}Staged`] = name
+}
+
+// Elapsed nanoseconds: process.hrtime in node, performance.now in browsers
+const hrtime =
+  typeof process === 'object' && typeof process.hrtime === 'function'
+
+function timerStart () {
+  return hrtime ? process.hrtime() : performance.now()
+}
+
+function timerElapsed (start) {
+  if (!hrtime) return Math.round((performance.now() - start) * 1e6)
+
+  const [s, ns] = process.hrtime(start)
+  return s * 1e9 + ns
+}
+
+class Stats {
+  constructor (target) {
+    this.target = target
+    this.enabled = false
+    // Async methods call sync ones, only outermost call recorded
+    this.depth = 0
+
+    this.counters = new Map()
+    for (const name of Object.values(methods)) {
+      if (this.counters.has(name)) continue
+      this.counters.set(name, {
+        calls: 0,
+        codes: new Float64Array(kCodes),
+        sum: 0,
+        buckets: new Float64Array(kBuckets),
+      })
+    }
+  }
+
+  enable (enabled) {
+    if (enabled === this.enabled) return
+    this.enabled = enabled
+
+    for (const [method, name] of Object.entries(methods)) {
+      if (enabled) {
+        this.target[method] = this.wrap(this.target[method], name)
+      } else {
+        delete this.target[method]
+      }
+    }
+  }
+
+  // Exceptions are not recorded, same as in addon
+  wrap (fn, name) {
+    const stats = this
+    return function (...args) {
+      if (stats.depth > 0) return fn.apply(this, args)
+
+      const start = timerStart()
+      let ret
+      stats.depth += 1
+      try {
+        ret = fn.apply(this, args)
+      } finally {
+        stats.depth -= 1
+      }
+
+      if (!(ret instanceof Promise)) {
+        stats.record(name, ret, timerElapsed(start))
+        return ret
+      }
+
+      return ret.then((code) => {
+        stats.record(name, code, timerElapsed(start))
+        return code
+      })
+    }
+  }
+
+  // Bucket is bit length of latency in nanoseconds
+  record (name, code, ns) {
+    let bucket = 0
+    for (let x = ns; x >= 1 && bucket < kBuckets - 1; x = Math.floor(x / 2)) {
+      bucket += 1
+    }
+
+    const counter = this.counters.get(name)
+    counter.calls += 1
+    if (code >= 0 && code < kCodes) counter.codes[code] += 1
+    counter.sum += ns
+    counter.buckets[bucket] += 1
+  }
+
+  reset () {
+    for (const counter of this.counters.values()) {
+      counter.calls = 0
+      counter.codes.fill(0)
+      counter.sum = 0
+      counter.buckets.fill(0)
+    }
+  }
+
+  snapshot () {
+    const snapshot = {}
+    for (const [name, counter] of this.counters) {
+      if (counter.calls === 0) continue
+
+      const codes = {}
+      for (let code = 0; code < kCodes; ++code) {
+        if (counter.codes[code] !== 0) codes[code] = counter.codes[code]
+      }
+
+      snapshot[name] = {
+        calls: counter.calls,
+        codes,
+        latency: { sum: counter.sum, buckets: Array.from(counter.buckets) },
+      }
+    }
+
+    return snapshot
+  }
+}
+
+module.exports = Stats
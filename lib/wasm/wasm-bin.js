@@ -1,9 +1,35 @@
 const fs = require('fs')
 const path = require('path')
+const { Readable } = require('stream')
 
-module.exports = new Promise((resolve, reject) => {
-  const location = path.join(__dirname, '..', '..', 'fcrypto.wasm')
-  fs.readFile(location, (err, data) => {
-    return err ? reject(err) : resolve(data)
+function getLocation (name) {
+  return path.join(__dirname, '..', '..', `${name}.wasm`)
+}
+
+// name: `fcrypto` or `fcrypto-simd`, see `build-wasm-variant` in Makefile
+function readCode (name = 'fcrypto') {
+  return new Promise((resolve, reject) => {
+    fs.readFile(getLocation(name), (err, data) => {
+      return err ? reject(err) : resolve(data)
+    })
   })
-})
+}
+
+// Compilation starts on first chunks of file with `compileStreaming` (Node
+// with fetch API), otherwise whole file read before compile
+async function compile (name = 'fcrypto') {
+  const streaming =
+    typeof WebAssembly.compileStreaming === 'function' &&
+    typeof Response === 'function' &&
+    typeof Readable.toWeb === 'function'
+  if (!streaming) return WebAssembly.compile(await readCode(name))
+
+  const stream = fs.createReadStream(getLocation(name))
+  const response = new Response(Readable.toWeb(stream), {
+    headers: { 'content-type': 'application/wasm' },
+  })
+  return WebAssembly.compileStreaming(response)
+}
+
+module.exports = readCode
+module.exports.compile = compile
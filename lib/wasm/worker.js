@@ -0,0 +1,18 @@
+const { parentPort, workerData } = require('worker_threads')
+const { instantiate } = require('./index')
+const { processChunks } = require('./pool')
+const secp256k1Wrapper = require('./secp256k1')
+
+const { wasmModule, variant } = workerData
+const ready = instantiate(wasmModule, variant).then((env) => {
+  const Secp256k1 = secp256k1Wrapper(env)
+  return new Secp256k1()
+})
+
+// Without instance (for example no memory for it) worker stops taking tasks
+// and exits, chunks are processed by calling thread and other workers
+ready.catch(() => parentPort.close())
+
+parentPort.on('message', (task) => {
+  ready.then((secp256k1) => processChunks(secp256k1, task), () => {})
+})
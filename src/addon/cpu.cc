@@ -0,0 +1,45 @@
+#include <addon/cpu.h>
+
+#ifndef ADDON_VARIANT
+#define ADDON_VARIANT baseline
+#endif
+#define ADDON_STR(x) #x
+#define ADDON_XSTR(x) ADDON_STR(x)
+
+const char* AddonVariant() { return ADDON_XSTR(ADDON_VARIANT); }
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <cpuid.h>
+
+// YMM registers should be enabled by OS (XCR0 bits 1 and 2), otherwise AVX2
+// instructions fault even if CPU supports them
+static bool OsSupportsYmm() {
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_OSXSAVE)) {
+    return false;
+  }
+
+  unsigned int xcr0_lo, xcr0_hi;
+  __asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+  return (xcr0_lo & 0x6) == 0x6;
+}
+
+Napi::Value CpuFeatures(const Napi::CallbackInfo& info) {
+  unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+  __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx);
+
+  auto obj = Napi::Object::New(info.Env());
+  obj.Set("bmi2", (ebx & bit_BMI2) != 0);
+  obj.Set("adx", (ebx & (1 << 19)) != 0);
+  obj.Set("avx2", (ebx & bit_AVX2) != 0 && OsSupportsYmm());
+  return obj;
+}
+#else
+Napi::Value CpuFeatures(const Napi::CallbackInfo& info) {
+  auto obj = Napi::Object::New(info.Env());
+  obj.Set("bmi2", false);
+  obj.Set("adx", false);
+  obj.Set("avx2", false);
+  return obj;
+}
+#endif
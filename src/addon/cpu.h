@@ -0,0 +1,13 @@
+#ifndef ADDON_CPU
+#define ADDON_CPU
+
+#include <napi.h>
+
+// Name of build variant (`addon_variant` in binding.gyp): baseline, bmi2, avx2
+const char* AddonVariant();
+
+// CPU features required by variants, checked by loader before requiring
+// variant: { bmi2, adx, avx2 }. Always false on non-x64.
+Napi::Value CpuFeatures(const Napi::CallbackInfo& info);
+
+#endif  // ADDON_CPU
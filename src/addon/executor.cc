@@ -0,0 +1,131 @@
+#include <addon/executor.h>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <utility>
+
+struct BatchExecutor::Job {
+  using Chunk = std::pair<size_t, size_t>;
+
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Chunk> chunks;
+  };
+
+  Job(size_t participants, const ChunkFn& fn) : queues(participants), fn(fn) {}
+
+  // Own chunks taken from front, stolen chunks from back
+  bool Pop(size_t id, Chunk* chunk) {
+    for (size_t i = 0; i < queues.size(); ++i) {
+      auto& queue = queues[(id + i) % queues.size()];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (queue.chunks.empty()) continue;
+
+      if (i == 0) {
+        *chunk = queue.chunks.front();
+        queue.chunks.pop_front();
+      } else {
+        *chunk = queue.chunks.back();
+        queue.chunks.pop_back();
+      }
+      return true;
+    }
+
+    return false;
+  }
+
+  void Work(size_t id) {
+    Chunk chunk;
+    while (Pop(id, &chunk)) {
+      fn(chunk.first, chunk.second);
+      if (remaining.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(done_mutex);
+        done_cv.notify_all();
+      }
+    }
+  }
+
+  std::vector<Queue> queues;
+  ChunkFn fn;
+  std::atomic<size_t> next_id{1};  // 0 is calling thread
+  std::atomic<size_t> remaining{0};
+  std::mutex done_mutex;
+  std::condition_variable done_cv;
+};
+
+// Never destroyed: threads wait on condition variable until process exit,
+// this way we do not depend from order of static destructors.
+BatchExecutor& BatchExecutor::Instance() {
+  static BatchExecutor* executor = [] {
+    size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    return new BatchExecutor(cores - 1);
+  }();
+  return *executor;
+}
+
+BatchExecutor::BatchExecutor(size_t workers) {
+  for (size_t i = 0; i < workers; ++i) {
+    workers_.emplace_back(&BatchExecutor::WorkerLoop, this);
+  }
+}
+
+void BatchExecutor::WorkerLoop() {
+  size_t generation = 0;
+  for (;;) {
+    std::shared_ptr<Job> job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [&] { return generation_ != generation; });
+      generation = generation_;
+      job = job_;
+    }
+
+    // Job can be already finished by other participants
+    if (!job) continue;
+
+    size_t id = job->next_id++;
+    if (id < job->queues.size()) job->Work(id);
+  }
+}
+
+void BatchExecutor::Run(size_t n, size_t threads, const ChunkFn& fn) {
+  if (n == 0) return;
+
+  // Pool busy with other batch: calling thread (can be JS thread or libuv
+  // threadpool thread) does not wait for it, batch computed without pool
+  std::unique_lock<std::mutex> run_lock(run_mutex_, std::try_to_lock);
+
+  size_t participants = std::min(std::min(threads, Size()), n);
+  if (!run_lock.owns_lock() || participants <= 1) {
+    fn(0, n);
+    return;
+  }
+
+  // Few chunks per participant, so there is what to steal. Initially every
+  // participant receive contiguous part of batch.
+  size_t chunk = std::max<size_t>(1, n / (participants * 8));
+  auto job = std::make_shared<Job>(participants, fn);
+  size_t count = 0;
+  for (size_t begin = 0; begin < n; begin += chunk, ++count) {
+    size_t end = std::min(begin + chunk, n);
+    job->queues[begin * participants / n].chunks.emplace_back(begin, end);
+  }
+  job->remaining = count;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    job_ = job;
+    generation_ += 1;
+  }
+  cv_.notify_all();
+
+  job->Work(0);
+  {
+    std::unique_lock<std::mutex> lock(job->done_mutex);
+    job->done_cv.wait(lock, [&] { return job->remaining == 0; });
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  job_.reset();
+}
@@ -0,0 +1,47 @@
+#ifndef ADDON_EXECUTOR
+#define ADDON_EXECUTOR
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed pool of threads for splitting big batches across cores.
+// Batch split to chunks, every participant (calling thread is one of them)
+// have own queue of chunks and steal from others when own queue is empty, so
+// slow items (or fast failures) in one part of batch do not stall pool.
+class BatchExecutor {
+ public:
+  using ChunkFn = std::function<void(size_t begin, size_t end)>;
+
+  // Process-wide pool, threads created on first call
+  static BatchExecutor& Instance();
+
+  // Maximum number of participants (pool threads + calling thread)
+  size_t Size() const { return workers_.size() + 1; }
+
+  // Run fn on [0, n) with up to `threads` participants, blocks until done.
+  // If pool is busy with other batch, fn(0, n) called on calling thread.
+  void Run(size_t n, size_t threads, const ChunkFn& fn);
+
+ private:
+  struct Job;
+
+  explicit BatchExecutor(size_t workers);
+
+  void WorkerLoop();
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::shared_ptr<Job> job_;
+  size_t generation_ = 0;
+
+  // Only one batch at time, see Run
+  std::mutex run_mutex_;
+};
+
+#endif  // ADDON_EXECUTOR
@@ -1,9 +1,12 @@
+#include <addon/cpu.h>
 #include <addon/secp256k1.h>
 
 #include <napi.h>
 
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
   exports.Set("Secp256k1", Secp256k1Addon::Init(env));
+  exports.Set("variant", AddonVariant());
+  exports.Set("cpuFeatures", Napi::Function::New(env, CpuFeatures));
   return exports;
 }
 
@@ -1,42 +1,111 @@
+#include <addon/cpu.h>
+#include <addon/executor.h>
 #include <addon/secp256k1.h>
 
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
 #define RET(result) return Napi::Number::New(info.Env(), result);
 
 Napi::FunctionReference Secp256k1Addon::constructor;
 
+// PublicKey handle
+Napi::Function Secp256k1PublicKey::Define(Napi::Env env) {
+  return DefineClass(env, "Secp256k1PublicKey", {});
+}
+
+Secp256k1PublicKey::Secp256k1PublicKey(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<Secp256k1PublicKey>(info) {
+  std::memset(pubkey_.data, 0, sizeof(pubkey_.data));
+}
+
+// Prepared verifier
+Napi::Function Secp256k1Verifier::Define(Napi::Env env) {
+  return DefineClass(env, "Secp256k1Verifier", {});
+}
+
+Secp256k1Verifier* Secp256k1Verifier::FromValue(Secp256k1Addon* addon,
+                                                const Napi::Value& value) {
+  auto obj = value.As<Napi::Object>();
+  if (!obj.InstanceOf(addon->verifier_constructor_.Value())) {
+    throw Napi::TypeError::New(value.Env(), "Expected verifier");
+  }
+
+  return Unwrap(obj);
+}
+
+Secp256k1Verifier::Secp256k1Verifier(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<Secp256k1Verifier>(info) {
+  size_t size = fcrypto_secp256k1_verifier_size();
+  data_ = static_cast<unsigned char*>(std::malloc(size));
+  if (data_ != nullptr) {
+    Napi::MemoryManagement::AdjustExternalMemory(info.Env(), size);
+  }
+}
+
+void Secp256k1Verifier::Finalize(Napi::Env env) { Release(env); }
+
+void Secp256k1Verifier::Release(Napi::Env env) {
+  if (data_ == nullptr) {
+    return;
+  }
+
+  std::free(data_);
+  data_ = nullptr;
+
+  size_t size = fcrypto_secp256k1_verifier_size();
+  Napi::MemoryManagement::AdjustExternalMemory(env, -size);
+}
+
+PubkeyArg::PubkeyArg(Secp256k1Addon* addon, const Napi::Value& value) {
+  if (value.IsBuffer()) {
+    auto pubkey = value.As<Napi::Buffer<const unsigned char>>();
+    data_ = pubkey.Data();
+    length_ = pubkey.Length();
+    return;
+  }
+
+  // Only objects created by PublicKeyParse, arbitrary 64 bytes can be not a
+  // point on curve
+  auto obj = value.As<Napi::Object>();
+  if (!obj.InstanceOf(addon->pubkey_constructor_.Value())) {
+    throw Napi::TypeError::New(value.Env(), "Expected public key");
+  }
+
+  data_ = Secp256k1PublicKey::Unwrap(obj)->Data();
+  length_ = sizeof(secp256k1_pubkey);
+}
+
+// Classes of handles are static values of addon class, so every instance
+// takes classes of own env from new.target
 Napi::Value Secp256k1Addon::Init(Napi::Env env) {
   Napi::Function func = DefineClass(
       env,
       "Secp256k1Addon",
       {
-          InstanceMethod("contextRandomize", &Secp256k1Addon::ContextRandomize),
-
-          InstanceMethod("privateKeyVerify", &Secp256k1Addon::PrivateKeyVerify),
-          InstanceMethod("privateKeyNegate", &Secp256k1Addon::PrivateKeyNegate),
-          InstanceMethod("privateKeyTweakAdd",
-                         &Secp256k1Addon::PrivateKeyTweakAdd),
-          InstanceMethod("privateKeyTweakMul",
-                         &Secp256k1Addon::PrivateKeyTweakMul),
-
-          InstanceMethod("publicKeyCreate", &Secp256k1Addon::PublicKeyCreate),
-          InstanceMethod("publicKeyConvert", &Secp256k1Addon::PublicKeyConvert),
-          InstanceMethod("publicKeyNegate", &Secp256k1Addon::PublicKeyNegate),
-          InstanceMethod("publicKeyCombine", &Secp256k1Addon::PublicKeyCombine),
-          InstanceMethod("publicKeyTweakAdd",
-                         &Secp256k1Addon::PublicKeyTweakAdd),
-          InstanceMethod("publicKeyTweakMul",
-                         &Secp256k1Addon::PublicKeyTweakMul),
-
-          InstanceMethod("signatureNormalize",
-                         &Secp256k1Addon::SignatureNormalize),
-          InstanceMethod("signatureExport", &Secp256k1Addon::SignatureExport),
-          InstanceMethod("signatureImport", &Secp256k1Addon::SignatureImport),
-
-          InstanceMethod("ecdsaSign", &Secp256k1Addon::ECDSASign),
-          InstanceMethod("ecdsaVerify", &Secp256k1Addon::ECDSAVerify),
-          InstanceMethod("ecdsaRecover", &Secp256k1Addon::ECDSARecover),
-
-          InstanceMethod("ecdh", &Secp256k1Addon::ECDH),
+          StaticValue("PublicKey", Secp256k1PublicKey::Define(env)),
+          StaticValue("Verifier", Secp256k1Verifier::Define(env)),
+
+          InstanceMethod("buildInfo", &Secp256k1Addon::BuildInfo),
+          InstanceMethod("statsEnable", &Secp256k1Addon::StatsEnable),
+          InstanceMethod("statsReset", &Secp256k1Addon::StatsReset),
+          InstanceMethod("statsSnapshot", &Secp256k1Addon::StatsSnapshot),
+          InstanceMethod("ecdsaVerifierDestroy",
+                         &Secp256k1Addon::ECDSAVerifierDestroy),
+
+// Instrumented<Method> only checks AddonStats::Enabled when disabled
+#define X(name, method)                                                 \
+  InstanceMethod(#name,                                                 \
+                 &Secp256k1Addon::Instrumented<&Secp256k1Addon::method, \
+                                               kMethod##method>),
+          SECP256K1_ADDON_METHODS(X)
+#undef X
+
+#define X(name, method) InstanceMethod(#name, &Secp256k1Addon::method),
+          SECP256K1_ADDON_ASYNC_METHODS(X)
+#undef X
       });
 
   constructor = Napi::Persistent(func);
@@ -45,27 +114,135 @@ Napi::Value Secp256k1Addon::Init(Napi::Env env) {
   return func;
 }
 
+// Context with precomputed tables is shared by all instances in process
+// (including worker threads), created with first instance and destroyed with
+// last one. Tables do not belong to one isolate, so only clones reported
+// through AdjustExternalMemory.
+static std::mutex shared_ctx_mutex;
+static secp256k1_context* shared_ctx = nullptr;
+static size_t shared_ctx_refs = 0;
+
+// Returns NULL without reference if context can not be created, so next
+// instance tries again
+static const secp256k1_context* SharedContextAcquire() {
+  std::lock_guard<std::mutex> lock(shared_ctx_mutex);
+  if (shared_ctx_refs == 0) {
+    shared_ctx = fcrypto_secp256k1_context_create();
+    if (shared_ctx == nullptr) {
+      return nullptr;
+    }
+  }
+  shared_ctx_refs += 1;
+  return shared_ctx;
+}
+
+static void SharedContextRelease() {
+  std::lock_guard<std::mutex> lock(shared_ctx_mutex);
+  if (--shared_ctx_refs == 0) {
+    fcrypto_secp256k1_context_destroy(shared_ctx);
+    shared_ctx = nullptr;
+  }
+}
+
+// Release arena memory at the end of call, including exceptions
+class ArenaScope {
+ public:
+  explicit ArenaScope(fcrypto_arena* arena) : arena_(arena) {}
+  ~ArenaScope() { fcrypto_arena_reset(arena_); }
+
+  template <typename T>
+  T* Alloc(size_t n) {
+    return static_cast<T*>(fcrypto_arena_alloc(arena_, n * sizeof(T)));
+  }
+
+ private:
+  fcrypto_arena* arena_;
+};
+
+static const char* const method_names[] = {
+#define X(name, method) #name,
+    SECP256K1_ADDON_METHODS(X) SECP256K1_ADDON_ASYNC_METHODS(X)
+#undef X
+};
+
+// Every instance has own clone for randomization
 Secp256k1Addon::Secp256k1Addon(const Napi::CallbackInfo& info)
-    : Napi::ObjectWrap<Secp256k1Addon>(info) {
-  ctx_ = fcrypto_secp256k1_context_create();
+    : Napi::ObjectWrap<Secp256k1Addon>(info),
+      stats_(method_names, kMethodCount) {
+  auto target = info.NewTarget().As<Napi::Object>();
+  pubkey_constructor_ =
+      Napi::Persistent(target.Get("PublicKey").As<Napi::Function>());
+  verifier_constructor_ =
+      Napi::Persistent(target.Get("Verifier").As<Napi::Function>());
+
+  arena_ = fcrypto_arena_create(4096);
+  if (arena_ == nullptr) {
+    throw Napi::Error::New(info.Env(), "Memory allocation error");
+  }
+
+  // Reference released in Finalize, even if clone is not created
+  auto shared = SharedContextAcquire();
+  if (shared == nullptr) {
+    throw Napi::Error::New(info.Env(), "Memory allocation error");
+  }
+  shared_ctx_acquired_ = true;
+  ctx_ = fcrypto_secp256k1_context_clone(shared);
+  if (ctx_ == nullptr) {
+    throw Napi::Error::New(info.Env(), "Memory allocation error");
+  }
 
-  size_t size = fcrypto_secp256k1_context_size();
+  size_t size = fcrypto_secp256k1_context_clone_size();
   Napi::MemoryManagement::AdjustExternalMemory(info.Env(), size);
 }
 
 void Secp256k1Addon::Finalize(Napi::Env env) {
-  fcrypto_secp256k1_context_destroy(const_cast<secp256k1_context*>(ctx_));
+  fcrypto_arena_destroy(arena_);
+  if (shared_ctx_acquired_) {
+    SharedContextRelease();
+  }
+  if (ctx_ == nullptr) {
+    return;
+  }
+
+  fcrypto_secp256k1_context_clone_destroy(
+      const_cast<secp256k1_context*>(ctx_));
 
-  size_t size = fcrypto_secp256k1_context_size();
+  size_t size = fcrypto_secp256k1_context_clone_size();
   Napi::MemoryManagement::AdjustExternalMemory(env, -size);
 }
 
+Napi::Value Secp256k1Addon::BuildInfo(const Napi::CallbackInfo& info) {
+  auto obj = Napi::Object::New(info.Env());
+  obj.Set("ecmultGenPrecBits", fcrypto_secp256k1_ecmult_gen_prec_bits());
+  obj.Set("ecmultWindowSize", fcrypto_secp256k1_ecmult_window_size());
+  obj.Set("contextSize", fcrypto_secp256k1_context_size());
+  obj.Set("staticTables", fcrypto_secp256k1_static_tables() == 1);
+  obj.Set("variant", AddonVariant());
+  return obj;
+}
+
+Napi::Value Secp256k1Addon::StatsEnable(const Napi::CallbackInfo& info) {
+  stats_.SetEnabled(info[0].As<Napi::Boolean>().Value());
+  return info.Env().Undefined();
+}
+
+Napi::Value Secp256k1Addon::StatsReset(const Napi::CallbackInfo& info) {
+  stats_.Reset();
+  return info.Env().Undefined();
+}
+
+Napi::Value Secp256k1Addon::StatsSnapshot(const Napi::CallbackInfo& info) {
+  return stats_.Snapshot(info.Env());
+}
+
 Napi::Value Secp256k1Addon::ContextRandomize(const Napi::CallbackInfo& info) {
   const unsigned char* seed32 = NULL;
   if (!info[0].IsNull()) {
     seed32 = info[0].As<Napi::Buffer<const unsigned char>>().Data();
   }
 
+  // Wait async workers which use context right now
+  std::unique_lock<std::shared_timed_mutex> lock(ctx_mutex_);
   RET(fcrypto_secp256k1_context_randomize(
       const_cast<secp256k1_context*>(this->ctx_), seed32));
 }
@@ -106,9 +283,24 @@ Napi::Value Secp256k1Addon::PublicKeyCreate(const Napi::CallbackInfo& info) {
       this->ctx_, output.Data(), seckey, output.Length()));
 }
 
+Napi::Value Secp256k1Addon::PublicKeyParse(const Napi::CallbackInfo& info) {
+  auto obj = info[0].As<Napi::Object>();
+  auto input = info[1].As<Napi::Buffer<const unsigned char>>();
+
+  auto handle = pubkey_constructor_.New({});
+  auto output = Secp256k1PublicKey::Unwrap(handle)->Data();
+  int ret = fcrypto_secp256k1_pubkey_parse(
+      this->ctx_, output, input.Data(), input.Length());
+  if (ret == 0) {
+    obj.Set("handle", handle);
+  }
+
+  RET(ret);
+}
+
 Napi::Value Secp256k1Addon::PublicKeyConvert(const Napi::CallbackInfo& info) {
   auto output = info[0].As<Napi::Buffer<unsigned char>>();
-  auto pubkey = info[1].As<Napi::Buffer<const unsigned char>>();
+  PubkeyArg pubkey(this, info[1]);
 
   RET(fcrypto_secp256k1_pubkey_convert(this->ctx_,
                                        output.Data(),
@@ -119,7 +311,7 @@ Napi::Value Secp256k1Addon::PublicKeyConvert(const Napi::CallbackInfo& info) {
 
 Napi::Value Secp256k1Addon::PublicKeyNegate(const Napi::CallbackInfo& info) {
   auto output = info[0].As<Napi::Buffer<unsigned char>>();
-  auto pubkey = info[1].As<Napi::Buffer<const unsigned char>>();
+  PubkeyArg pubkey(this, info[1]);
 
   RET(fcrypto_secp256k1_pubkey_negate(this->ctx_,
                                       output.Data(),
@@ -132,26 +324,65 @@ Napi::Value Secp256k1Addon::PublicKeyCombine(const Napi::CallbackInfo& info) {
   auto output = info[0].As<Napi::Buffer<unsigned char>>();
   auto pubkeys = info[1].As<Napi::Array>();
 
-  std::unique_ptr<const unsigned char*[]> inputs(
-      new const unsigned char*[pubkeys.Length()]);
-  std::unique_ptr<size_t[]> inputslen(new size_t[pubkeys.Length()]);
+  ArenaScope scope(this->arena_);
+  auto inputs = scope.Alloc<const unsigned char*>(pubkeys.Length());
+  auto inputslen = scope.Alloc<size_t>(pubkeys.Length());
+  if (inputs == nullptr || inputslen == nullptr) {
+    RET(4);
+  }
+
   for (size_t i = 0; i < pubkeys.Length(); ++i) {
-    auto pubkey = pubkeys.Get(i).As<Napi::Buffer<const unsigned char>>();
+    PubkeyArg pubkey(this, pubkeys.Get(i));
     inputs[i] = pubkey.Data();
     inputslen[i] = pubkey.Length();
   }
 
   RET(fcrypto_secp256k1_pubkey_combine(this->ctx_,
+                                       this->arena_,
                                        output.Data(),
-                                       inputs.get(),
-                                       inputslen.get(),
+                                       inputs,
+                                       inputslen,
                                        pubkeys.Length(),
                                        output.Length()));
 }
 
+Napi::Value Secp256k1Addon::PublicKeyLinearCombination(
+    const Napi::CallbackInfo& info) {
+  auto output = info[0].As<Napi::Buffer<unsigned char>>();
+  auto pubkeys = info[1].As<Napi::Array>();
+  auto scalars = info[2].As<Napi::Buffer<const unsigned char>>().Data();
+  const unsigned char* gscalar = nullptr;
+  if (!info[3].IsNull()) {
+    gscalar = info[3].As<Napi::Buffer<const unsigned char>>().Data();
+  }
+
+  ArenaScope scope(this->arena_);
+  auto inputs = scope.Alloc<const unsigned char*>(pubkeys.Length());
+  auto inputslen = scope.Alloc<size_t>(pubkeys.Length());
+  if (inputs == nullptr || inputslen == nullptr) {
+    RET(4);
+  }
+
+  for (size_t i = 0; i < pubkeys.Length(); ++i) {
+    PubkeyArg pubkey(this, pubkeys.Get(i));
+    inputs[i] = pubkey.Data();
+    inputslen[i] = pubkey.Length();
+  }
+
+  RET(fcrypto_secp256k1_pubkey_linear_combination(this->ctx_,
+                                                  this->arena_,
+                                                  output.Data(),
+                                                  inputs,
+                                                  inputslen,
+                                                  scalars,
+                                                  gscalar,
+                                                  pubkeys.Length(),
+                                                  output.Length()));
+}
+
 Napi::Value Secp256k1Addon::PublicKeyTweakAdd(const Napi::CallbackInfo& info) {
   auto output = info[0].As<Napi::Buffer<unsigned char>>();
-  auto pubkey = info[1].As<Napi::Buffer<const unsigned char>>();
+  PubkeyArg pubkey(this, info[1]);
   auto tweak = info[2].As<Napi::Buffer<const unsigned char>>().Data();
 
   RET(fcrypto_secp256k1_pubkey_tweak_add(this->ctx_,
@@ -164,7 +395,7 @@ Napi::Value Secp256k1Addon::PublicKeyTweakAdd(const Napi::CallbackInfo& info) {
 
 Napi::Value Secp256k1Addon::PublicKeyTweakMul(const Napi::CallbackInfo& info) {
   auto output = info[0].As<Napi::Buffer<unsigned char>>();
-  auto pubkey = info[1].As<Napi::Buffer<const unsigned char>>();
+  PubkeyArg pubkey(this, info[1]);
   auto tweak = info[2].As<Napi::Buffer<const unsigned char>>().Data();
 
   RET(fcrypto_secp256k1_pubkey_tweak_mul(this->ctx_,
@@ -225,12 +456,126 @@ Napi::Value Secp256k1Addon::ECDSASign(const Napi::CallbackInfo& info) {
 Napi::Value Secp256k1Addon::ECDSAVerify(const Napi::CallbackInfo& info) {
   auto sigraw = info[0].As<Napi::Buffer<const unsigned char>>().Data();
   auto msg32 = info[1].As<Napi::Buffer<const unsigned char>>().Data();
-  auto pubkey = info[2].As<Napi::Buffer<const unsigned char>>();
+  PubkeyArg pubkey(this, info[2]);
 
   RET(fcrypto_secp256k1_ecdsa_verify(
       this->ctx_, sigraw, msg32, pubkey.Data(), pubkey.Length()));
 }
 
+Napi::Value Secp256k1Addon::ECDSASignMessage(const Napi::CallbackInfo& info) {
+  auto obj = info[0].As<Napi::Object>();
+  auto output = obj.Get("signature").As<Napi::Buffer<unsigned char>>().Data();
+  int recid;
+  auto msg = info[1].As<Napi::Buffer<const unsigned char>>();
+  auto seckey = info[2].As<Napi::Buffer<const unsigned char>>().Data();
+  auto hash = info[3].As<Napi::Number>().Int32Value();
+
+  int ret = fcrypto_secp256k1_ecdsa_sign_message(
+      this->ctx_, output, &recid, msg.Data(), msg.Length(), seckey, hash);
+  if (ret == 0) {
+    obj.Set("recid", recid);
+  }
+
+  RET(ret);
+}
+
+Napi::Value Secp256k1Addon::ECDSAVerifyMessage(
+    const Napi::CallbackInfo& info) {
+  auto sigraw = info[0].As<Napi::Buffer<const unsigned char>>().Data();
+  auto msg = info[1].As<Napi::Buffer<const unsigned char>>();
+  PubkeyArg pubkey(this, info[2]);
+  auto hash = info[3].As<Napi::Number>().Int32Value();
+
+  RET(fcrypto_secp256k1_ecdsa_verify_message(this->ctx_,
+                                             sigraw,
+                                             msg.Data(),
+                                             msg.Length(),
+                                             pubkey.Data(),
+                                             pubkey.Length(),
+                                             hash));
+}
+
+Napi::Value Secp256k1Addon::ECDSAVerifierCreate(
+    const Napi::CallbackInfo& info) {
+  auto obj = info[0].As<Napi::Object>();
+  PubkeyArg pubkey(this, info[1]);
+
+  auto handle = verifier_constructor_.New({});
+  auto verifier = Secp256k1Verifier::Unwrap(handle);
+  if (verifier->Data() == nullptr) {
+    RET(2);
+  }
+
+  int ret = fcrypto_secp256k1_verifier_init(
+      this->ctx_, verifier->Data(), pubkey.Data(), pubkey.Length());
+  if (ret == 0) {
+    obj.Set("handle", handle);
+  } else {
+    verifier->Release(info.Env());
+  }
+
+  RET(ret);
+}
+
+Napi::Value Secp256k1Addon::ECDSAVerifierDestroy(
+    const Napi::CallbackInfo& info) {
+  Secp256k1Verifier::FromValue(this, info[0])->Release(info.Env());
+
+  return info.Env().Undefined();
+}
+
+Napi::Value Secp256k1Addon::ECDSAVerifyPrepared(
+    const Napi::CallbackInfo& info) {
+  auto sigraw = info[0].As<Napi::Buffer<const unsigned char>>().Data();
+  auto msg32 = info[1].As<Napi::Buffer<const unsigned char>>().Data();
+  auto verifier = Secp256k1Verifier::FromValue(this, info[2]);
+  if (verifier->Data() == nullptr) {
+    throw Napi::Error::New(info.Env(), "Verifier destroyed");
+  }
+
+  RET(fcrypto_secp256k1_ecdsa_verify_prepared(
+      this->ctx_, sigraw, msg32, verifier->Data()));
+}
+
+Napi::Value Secp256k1Addon::ECDSAVerifyBatch(const Napi::CallbackInfo& info) {
+  auto results = info[0].As<Napi::Buffer<unsigned char>>();
+  auto sigs = info[1].As<Napi::Array>();
+  auto recids = info[2].As<Napi::Array>();
+  auto msgs = info[3].As<Napi::Array>();
+  auto pubkeys = info[4].As<Napi::Array>();
+  size_t n = sigs.Length();
+
+  ArenaScope scope(this->arena_);
+  auto sigsptr = scope.Alloc<const unsigned char*>(n);
+  auto recidsptr = scope.Alloc<int>(n);
+  auto msgsptr = scope.Alloc<const unsigned char*>(n);
+  auto inputs = scope.Alloc<const unsigned char*>(n);
+  auto inputslen = scope.Alloc<size_t>(n);
+  if (sigsptr == nullptr || recidsptr == nullptr || msgsptr == nullptr ||
+      inputs == nullptr || inputslen == nullptr) {
+    RET(2);
+  }
+
+  for (size_t i = 0; i < n; ++i) {
+    sigsptr[i] = sigs.Get(i).As<Napi::Buffer<const unsigned char>>().Data();
+    recidsptr[i] = recids.Get(i).As<Napi::Number>().Int32Value();
+    msgsptr[i] = msgs.Get(i).As<Napi::Buffer<const unsigned char>>().Data();
+    PubkeyArg pubkey(this, pubkeys.Get(i));
+    inputs[i] = pubkey.Data();
+    inputslen[i] = pubkey.Length();
+  }
+
+  RET(fcrypto_secp256k1_ecdsa_verify_batch(this->ctx_,
+                                           this->arena_,
+                                           results.Data(),
+                                           sigsptr,
+                                           recidsptr,
+                                           msgsptr,
+                                           inputs,
+                                           inputslen,
+                                           n));
+}
+
 Napi::Value Secp256k1Addon::ECDSARecover(const Napi::CallbackInfo& info) {
   auto output = info[0].As<Napi::Buffer<unsigned char>>();
   auto sig = info[1].As<Napi::Buffer<const unsigned char>>().Data();
@@ -241,12 +586,351 @@ Napi::Value Secp256k1Addon::ECDSARecover(const Napi::CallbackInfo& info) {
       this->ctx_, output.Data(), sig, recid, msg32, output.Length()));
 }
 
+Napi::Value Secp256k1Addon::ECDSARecoverAddress(
+    const Napi::CallbackInfo& info) {
+  auto output = info[0].As<Napi::Buffer<unsigned char>>().Data();
+  auto sig = info[1].As<Napi::Buffer<const unsigned char>>().Data();
+  auto recid = info[2].As<Napi::Number>().Int32Value();
+  auto msg32 = info[3].As<Napi::Buffer<const unsigned char>>().Data();
+  auto type = info[4].As<Napi::Number>().Int32Value();
+
+  RET(fcrypto_secp256k1_ecdsa_recover_address(
+      this->ctx_, output, sig, recid, msg32, type));
+}
+
+// Schnorr
+Napi::Value Secp256k1Addon::XOnlyPublicKeyCreate(
+    const Napi::CallbackInfo& info) {
+  auto output = info[0].As<Napi::Buffer<unsigned char>>().Data();
+  auto seckey = info[1].As<Napi::Buffer<const unsigned char>>().Data();
+
+  RET(fcrypto_secp256k1_xonly_pubkey_create(this->ctx_, output, seckey));
+}
+
+Napi::Value Secp256k1Addon::XOnlyPublicKeyConvert(
+    const Napi::CallbackInfo& info) {
+  auto output = info[0].As<Napi::Buffer<unsigned char>>().Data();
+  PubkeyArg pubkey(this, info[1]);
+
+  RET(fcrypto_secp256k1_xonly_pubkey_convert(
+      this->ctx_, output, pubkey.Data(), pubkey.Length()));
+}
+
+Napi::Value Secp256k1Addon::SchnorrSign(const Napi::CallbackInfo& info) {
+  auto output = info[0].As<Napi::Buffer<unsigned char>>().Data();
+  auto msg32 = info[1].As<Napi::Buffer<const unsigned char>>().Data();
+  auto seckey = info[2].As<Napi::Buffer<const unsigned char>>().Data();
+  const unsigned char* auxrand32 = nullptr;
+  if (!info[3].IsNull()) {
+    auxrand32 = info[3].As<Napi::Buffer<const unsigned char>>().Data();
+  }
+
+  RET(fcrypto_secp256k1_schnorr_sign(
+      this->ctx_, output, msg32, seckey, auxrand32));
+}
+
+Napi::Value Secp256k1Addon::SchnorrVerify(const Napi::CallbackInfo& info) {
+  auto sig = info[0].As<Napi::Buffer<const unsigned char>>().Data();
+  auto msg32 = info[1].As<Napi::Buffer<const unsigned char>>().Data();
+  auto pubkey = info[2].As<Napi::Buffer<const unsigned char>>().Data();
+
+  RET(fcrypto_secp256k1_schnorr_verify(this->ctx_, sig, msg32, pubkey));
+}
+
+Napi::Value Secp256k1Addon::SchnorrVerifyBatch(
+    const Napi::CallbackInfo& info) {
+  auto results = info[0].As<Napi::Buffer<unsigned char>>();
+  auto inputs = info[1].As<Napi::Buffer<const unsigned char>>().Data();
+  auto batchsize = info[2].As<Napi::Number>().Uint32Value();
+
+  ArenaScope scope(this->arena_);
+  RET(fcrypto_secp256k1_schnorr_verify_batch(this->ctx_,
+                                             this->arena_,
+                                             results.Data(),
+                                             inputs,
+                                             results.Length(),
+                                             batchsize));
+}
+
 // ECDH
 Napi::Value Secp256k1Addon::ECDH(const Napi::CallbackInfo& info) {
   auto output = info[0].As<Napi::Buffer<unsigned char>>().Data();
-  auto pubkey = info[1].As<Napi::Buffer<const unsigned char>>();
+  PubkeyArg pubkey(this, info[1]);
   auto seckey = info[2].As<Napi::Buffer<const unsigned char>>().Data();
+  auto mode = info[3].As<Napi::Number>().Int32Value();
 
-  RET(fcrypto_secp256k1_ecdh(
-      this->ctx_, output, pubkey.Data(), pubkey.Length(), seckey));
+  RET(fcrypto_secp256k1_ecdh_mode(
+      this->ctx_, output, pubkey.Data(), pubkey.Length(), seckey, mode));
+}
+
+// Bulk, number of items is length of statuses
+Napi::Value Secp256k1Addon::PrivateKeyVerifyMany(
+    const Napi::CallbackInfo& info) {
+  auto statuses = info[0].As<Napi::Buffer<unsigned char>>();
+  auto seckeys = info[1].As<Napi::Buffer<const unsigned char>>().Data();
+
+  RET(fcrypto_secp256k1_seckey_verify_many(
+      this->ctx_, statuses.Data(), seckeys, statuses.Length()));
+}
+
+// Functions with optional `threads` argument split batch across BatchExecutor.
+// Context used only for reading there, libsecp256k1 allow this from many
+// threads at once, so all participants share precomputed tables.
+template <typename F>
+static int RunMany(size_t n, const Napi::Value& threads, F fn) {
+  size_t count =
+      threads.IsNumber() ? threads.As<Napi::Number>().Uint32Value() : 1;
+  if (count <= 1 || n <= 1) {
+    return fn(0, n);
+  }
+
+  std::atomic<int> ret{0};
+  BatchExecutor::Instance().Run(n, count, [&](size_t begin, size_t end) {
+    if (fn(begin, end) != 0) {
+      ret = 1;
+    }
+  });
+  return ret;
+}
+
+Napi::Value Secp256k1Addon::PublicKeyCreateMany(
+    const Napi::CallbackInfo& info) {
+  auto output = info[0].As<Napi::Buffer<unsigned char>>();
+  auto statuses = info[1].As<Napi::Buffer<unsigned char>>();
+  auto seckeys = info[2].As<Napi::Buffer<const unsigned char>>().Data();
+  size_t n = statuses.Length();
+  size_t outputlen = n == 0 ? 0 : output.Length() / n;
+
+  RET(RunMany(n, info[3], [&](size_t begin, size_t end) {
+    return fcrypto_secp256k1_pubkey_create_many(
+        this->ctx_,
+        output.Data() + begin * outputlen,
+        statuses.Data() + begin,
+        seckeys + begin * 32,
+        end - begin,
+        outputlen);
+  }));
+}
+
+Napi::Value Secp256k1Addon::PublicKeyCreateRange(
+    const Napi::CallbackInfo& info) {
+  auto output = info[0].As<Napi::Buffer<unsigned char>>();
+  auto statuses = info[1].As<Napi::Buffer<unsigned char>>();
+  auto seckey = info[2].As<Napi::Buffer<const unsigned char>>().Data();
+  size_t n = statuses.Length();
+
+  RET(fcrypto_secp256k1_pubkey_create_range(this->ctx_,
+                                            output.Data(),
+                                            statuses.Data(),
+                                            seckey,
+                                            n,
+                                            output.Length() / n));
+}
+
+Napi::Value Secp256k1Addon::ECDSASignMany(const Napi::CallbackInfo& info) {
+  auto output = info[0].As<Napi::Buffer<unsigned char>>().Data();
+  auto statuses = info[1].As<Napi::Buffer<unsigned char>>();
+  auto inputs = info[2].As<Napi::Buffer<const unsigned char>>().Data();
+
+  RET(fcrypto_secp256k1_ecdsa_sign_many(
+      this->ctx_, output, statuses.Data(), inputs, statuses.Length()));
+}
+
+Napi::Value Secp256k1Addon::ECDSAVerifyMany(const Napi::CallbackInfo& info) {
+  auto statuses = info[0].As<Napi::Buffer<unsigned char>>();
+  auto inputs = info[1].As<Napi::Buffer<const unsigned char>>();
+  size_t n = statuses.Length();
+  size_t recordlen = n == 0 ? 0 : inputs.Length() / n;
+
+  RET(RunMany(n, info[2], [&](size_t begin, size_t end) {
+    return fcrypto_secp256k1_ecdsa_verify_many(
+        this->ctx_,
+        statuses.Data() + begin,
+        inputs.Data() + begin * recordlen,
+        end - begin,
+        recordlen - 96);
+  }));
+}
+
+// Messages packed to one buffer, offsets passed as bytes of Uint32Array
+// (native byte order) with n + 1 items
+Napi::Value Secp256k1Addon::ECDSASignMessageMany(
+    const Napi::CallbackInfo& info) {
+  auto output = info[0].As<Napi::Buffer<unsigned char>>().Data();
+  auto statuses = info[1].As<Napi::Buffer<unsigned char>>();
+  auto seckeys = info[2].As<Napi::Buffer<const unsigned char>>().Data();
+  auto msgs = info[3].As<Napi::Buffer<const unsigned char>>().Data();
+  auto offsets = reinterpret_cast<const uint32_t*>(
+      info[4].As<Napi::Buffer<const unsigned char>>().Data());
+  auto hash = info[5].As<Napi::Number>().Int32Value();
+
+  RET(fcrypto_secp256k1_ecdsa_sign_message_many(this->ctx_,
+                                                output,
+                                                statuses.Data(),
+                                                seckeys,
+                                                msgs,
+                                                offsets,
+                                                statuses.Length(),
+                                                hash));
+}
+
+Napi::Value Secp256k1Addon::ECDSAVerifyMessageMany(
+    const Napi::CallbackInfo& info) {
+  auto statuses = info[0].As<Napi::Buffer<unsigned char>>();
+  auto inputs = info[1].As<Napi::Buffer<const unsigned char>>();
+  auto msgs = info[2].As<Napi::Buffer<const unsigned char>>().Data();
+  auto offsets = reinterpret_cast<const uint32_t*>(
+      info[3].As<Napi::Buffer<const unsigned char>>().Data());
+  auto hash = info[4].As<Napi::Number>().Int32Value();
+  size_t n = statuses.Length();
+  size_t recordlen = n == 0 ? 0 : inputs.Length() / n;
+
+  // Offsets are absolute, so every chunk use same messages buffer
+  RET(RunMany(n, info[5], [&](size_t begin, size_t end) {
+    return fcrypto_secp256k1_ecdsa_verify_message_many(
+        this->ctx_,
+        statuses.Data() + begin,
+        inputs.Data() + begin * recordlen,
+        msgs,
+        offsets + begin,
+        end - begin,
+        recordlen - 64,
+        hash);
+  }));
+}
+
+Napi::Value Secp256k1Addon::ECDSARecoverMany(const Napi::CallbackInfo& info) {
+  auto output = info[0].As<Napi::Buffer<unsigned char>>();
+  auto statuses = info[1].As<Napi::Buffer<unsigned char>>();
+  auto inputs = info[2].As<Napi::Buffer<const unsigned char>>().Data();
+  size_t n = statuses.Length();
+  size_t outputlen = n == 0 ? 0 : output.Length() / n;
+
+  RET(RunMany(n, info[3], [&](size_t begin, size_t end) {
+    return fcrypto_secp256k1_ecdsa_recover_many(
+        this->ctx_,
+        output.Data() + begin * outputlen,
+        statuses.Data() + begin,
+        inputs + begin * 97,
+        end - begin,
+        outputlen);
+  }));
+}
+
+Napi::Value Secp256k1Addon::ECDSARecoverAddressMany(
+    const Napi::CallbackInfo& info) {
+  auto output = info[0].As<Napi::Buffer<unsigned char>>().Data();
+  auto statuses = info[1].As<Napi::Buffer<unsigned char>>();
+  auto inputs = info[2].As<Napi::Buffer<const unsigned char>>().Data();
+  auto type = info[3].As<Napi::Number>().Int32Value();
+
+  RET(RunMany(statuses.Length(), info[4], [&](size_t begin, size_t end) {
+    return fcrypto_secp256k1_ecdsa_recover_address_many(
+        this->ctx_,
+        output + begin * 20,
+        statuses.Data() + begin,
+        inputs + begin * 97,
+        end - begin,
+        type);
+  }));
+}
+
+Napi::Value Secp256k1Addon::ECDHMany(const Napi::CallbackInfo& info) {
+  auto output = info[0].As<Napi::Buffer<unsigned char>>().Data();
+  auto statuses = info[1].As<Napi::Buffer<unsigned char>>();
+  auto inputs = info[2].As<Napi::Buffer<const unsigned char>>();
+  size_t n = statuses.Length();
+  size_t recordlen = n == 0 ? 0 : inputs.Length() / n;
+
+  RET(RunMany(n, info[3], [&](size_t begin, size_t end) {
+    return fcrypto_secp256k1_ecdh_many(
+        this->ctx_,
+        output + begin * 32,
+        statuses.Data() + begin,
+        inputs.Data() + begin * recordlen,
+        end - begin,
+        recordlen - 32);
+  }));
+}
+
+Napi::Value Secp256k1Addon::ECDHPubkeysMany(const Napi::CallbackInfo& info) {
+  auto output = info[0].As<Napi::Buffer<unsigned char>>();
+  auto statuses = info[1].As<Napi::Buffer<unsigned char>>();
+  auto seckey = info[2].As<Napi::Buffer<const unsigned char>>().Data();
+  auto inputs = info[3].As<Napi::Buffer<const unsigned char>>();
+  auto mode = info[4].As<Napi::Number>().Int32Value();
+  size_t n = statuses.Length();
+  size_t pubkeylen = n == 0 ? 0 : inputs.Length() / n;
+  size_t outputlen = n == 0 ? 0 : output.Length() / n;
+
+  // Invalid secret key (or mode) reported by all threads
+  std::atomic<int> invalid{0};
+  int ret = RunMany(n, info[5], [&](size_t begin, size_t end) {
+    int code = fcrypto_secp256k1_ecdh_pubkeys_many(
+        this->ctx_,
+        output.Data() + begin * outputlen,
+        statuses.Data() + begin,
+        seckey,
+        inputs.Data() + begin * pubkeylen,
+        end - begin,
+        pubkeylen,
+        mode);
+    if (code > 1) {
+      invalid = code;
+    }
+    return code;
+  });
+  RET(invalid != 0 ? invalid.load() : ret);
+}
+
+// BIP32
+Napi::Value Secp256k1Addon::BIP32FromSeed(const Napi::CallbackInfo& info) {
+  auto output = info[0].As<Napi::Buffer<unsigned char>>().Data();
+  auto seed = info[1].As<Napi::Buffer<const unsigned char>>();
+
+  RET(fcrypto_bip32_from_seed(
+      this->ctx_, output, seed.Data(), seed.Length()));
+}
+
+// Path passed as bytes of Uint32Array (native byte order)
+Napi::Value Secp256k1Addon::BIP32Derive(const Napi::CallbackInfo& info) {
+  auto output = info[0].As<Napi::Buffer<unsigned char>>();
+  auto xkey = info[1].As<Napi::Buffer<const unsigned char>>();
+  auto path = info[2].As<Napi::Buffer<const unsigned char>>();
+
+  RET(fcrypto_bip32_derive(this->ctx_,
+                           output.Data(),
+                           output.Length(),
+                           xkey.Data(),
+                           xkey.Length(),
+                           reinterpret_cast<const uint32_t*>(path.Data()),
+                           path.Length() / 4));
+}
+
+// Every thread derive own subrange from same parent, invalid extended key
+// reported by all of them
+Napi::Value Secp256k1Addon::BIP32DeriveRange(const Napi::CallbackInfo& info) {
+  auto output = info[0].As<Napi::Buffer<unsigned char>>();
+  auto statuses = info[1].As<Napi::Buffer<unsigned char>>();
+  auto xkey = info[2].As<Napi::Buffer<const unsigned char>>();
+  uint32_t index = info[3].As<Napi::Number>().Uint32Value();
+  size_t n = statuses.Length();
+  size_t outputlen = n == 0 ? 0 : output.Length() / n;
+
+  std::atomic<bool> invalid{false};
+  int ret = RunMany(n, info[4], [&](size_t begin, size_t end) {
+    int code = fcrypto_bip32_derive_range(this->ctx_,
+                                          output.Data() + begin * outputlen,
+                                          statuses.Data() + begin,
+                                          xkey.Data(),
+                                          xkey.Length(),
+                                          index + static_cast<uint32_t>(begin),
+                                          end - begin,
+                                          outputlen);
+    if (code == 2) {
+      invalid = true;
+    }
+    return code;
+  });
+  RET(invalid ? 2 : ret);
 }
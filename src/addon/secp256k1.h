@@ -1,9 +1,126 @@
 #ifndef ADDON_SECP256K1
 #define ADDON_SECP256K1
 
+#include <addon/stats.h>
+#include <fcrypto/bip32.h>
 #include <fcrypto/secp256k1.h>
 #include <napi.h>
 
+#include <shared_mutex>
+
+class Secp256k1Addon;
+
+// Parsed public key, created by Secp256k1Addon::PublicKeyParse. Class defined
+// once per env and referenced by every Secp256k1Addon of this env.
+class Secp256k1PublicKey : public Napi::ObjectWrap<Secp256k1PublicKey> {
+ public:
+  static Napi::Function Define(Napi::Env env);
+
+  Secp256k1PublicKey(const Napi::CallbackInfo& info);
+
+  unsigned char* Data() { return pubkey_.data; }
+
+ private:
+  secp256k1_pubkey pubkey_;
+};
+
+// Prepared verifier, created by Secp256k1Addon::ECDSAVerifierCreate.
+// Table of public key multiples allocated with malloc and reported to V8
+// through AdjustExternalMemory, can be freed before GC with Release.
+class Secp256k1Verifier : public Napi::ObjectWrap<Secp256k1Verifier> {
+ public:
+  static Napi::Function Define(Napi::Env env);
+  static Secp256k1Verifier* FromValue(Secp256k1Addon* addon,
+                                      const Napi::Value& value);
+
+  Secp256k1Verifier(const Napi::CallbackInfo& info);
+  void Finalize(Napi::Env env);
+
+  unsigned char* Data() { return data_; }
+  void Release(Napi::Env env);
+
+ private:
+  unsigned char* data_;
+};
+
+// Public key argument: serialized key in Buffer or Secp256k1PublicKey, which
+// passed to fcrypto functions as 64 bytes (see fcrypto_secp256k1_pubkey_parse)
+class PubkeyArg {
+ public:
+  PubkeyArg(Secp256k1Addon* addon, const Napi::Value& value);
+
+  const unsigned char* Data() const { return data_; }
+  size_t Length() const { return length_; }
+
+ private:
+  const unsigned char* data_;
+  size_t length_;
+};
+
+// Methods which return code of fcrypto function, counted by AddonStats:
+// X(JS name, method of Secp256k1Addon)
+#define SECP256K1_ADDON_METHODS(X)                          \
+  X(contextRandomize, ContextRandomize)                     \
+  X(privateKeyVerify, PrivateKeyVerify)                     \
+  X(privateKeyNegate, PrivateKeyNegate)                     \
+  X(privateKeyTweakAdd, PrivateKeyTweakAdd)                 \
+  X(privateKeyTweakMul, PrivateKeyTweakMul)                 \
+  X(publicKeyCreate, PublicKeyCreate)                       \
+  X(publicKeyParse, PublicKeyParse)                         \
+  X(publicKeyConvert, PublicKeyConvert)                     \
+  X(publicKeyNegate, PublicKeyNegate)                       \
+  X(publicKeyCombine, PublicKeyCombine)                     \
+  X(publicKeyLinearCombination, PublicKeyLinearCombination) \
+  X(publicKeyTweakAdd, PublicKeyTweakAdd)                   \
+  X(publicKeyTweakMul, PublicKeyTweakMul)                   \
+  X(signatureNormalize, SignatureNormalize)                 \
+  X(signatureExport, SignatureExport)                       \
+  X(signatureImport, SignatureImport)                       \
+  X(ecdsaSign, ECDSASign)                                   \
+  X(ecdsaVerify, ECDSAVerify)                               \
+  X(ecdsaSignMessage, ECDSASignMessage)                     \
+  X(ecdsaVerifyMessage, ECDSAVerifyMessage)                 \
+  X(ecdsaVerifyBatch, ECDSAVerifyBatch)                     \
+  X(ecdsaVerifierCreate, ECDSAVerifierCreate)               \
+  X(ecdsaVerifyPrepared, ECDSAVerifyPrepared)               \
+  X(ecdsaRecover, ECDSARecover)                             \
+  X(ecdsaRecoverAddress, ECDSARecoverAddress)               \
+  X(xOnlyPublicKeyCreate, XOnlyPublicKeyCreate)             \
+  X(xOnlyPublicKeyConvert, XOnlyPublicKeyConvert)           \
+  X(schnorrSign, SchnorrSign)                               \
+  X(schnorrVerify, SchnorrVerify)                           \
+  X(schnorrVerifyBatch, SchnorrVerifyBatch)                 \
+  X(ecdh, ECDH)                                             \
+  X(privateKeyVerifyMany, PrivateKeyVerifyMany)             \
+  X(publicKeyCreateMany, PublicKeyCreateMany)               \
+  X(publicKeyCreateRange, PublicKeyCreateRange)             \
+  X(ecdsaSignMany, ECDSASignMany)                           \
+  X(ecdsaVerifyMany, ECDSAVerifyMany)                       \
+  X(ecdsaSignMessageMany, ECDSASignMessageMany)             \
+  X(ecdsaVerifyMessageMany, ECDSAVerifyMessageMany)         \
+  X(ecdsaRecoverMany, ECDSARecoverMany)                     \
+  X(ecdsaRecoverAddressMany, ECDSARecoverAddressMany)       \
+  X(ecdhMany, ECDHMany)                                     \
+  X(ecdhPubkeysMany, ECDHPubkeysMany)                       \
+  X(bip32FromSeed, BIP32FromSeed)                           \
+  X(bip32Derive, BIP32Derive)                               \
+  X(bip32DeriveRange, BIP32DeriveRange)
+
+// Async methods, counted by workers on threadpool (see secp256k1_async.cc)
+#define SECP256K1_ADDON_ASYNC_METHODS(X)  \
+  X(ecdsaSignAsync, ECDSASignAsync)       \
+  X(ecdsaVerifyAsync, ECDSAVerifyAsync)   \
+  X(ecdsaRecoverAsync, ECDSARecoverAsync) \
+  X(ecdhAsync, ECDHAsync)                 \
+  X(ecdsaVerifyManyAsync, ECDSAVerifyManyAsync)
+
+enum Secp256k1Method {
+#define X(name, method) kMethod##method,
+  SECP256K1_ADDON_METHODS(X) SECP256K1_ADDON_ASYNC_METHODS(X)
+#undef X
+  kMethodCount
+};
+
 class Secp256k1Addon : public Napi::ObjectWrap<Secp256k1Addon> {
  public:
   static Napi::Value Init(Napi::Env env);
@@ -12,9 +129,42 @@ class Secp256k1Addon : public Napi::ObjectWrap<Secp256k1Addon> {
   void Finalize(Napi::Env env);
 
  private:
-  const secp256k1_context* ctx_;
+  const secp256k1_context* ctx_ = nullptr;
+  // Constructor can throw before reference to shared context is taken
+  bool shared_ctx_acquired_ = false;
+  // Temporary data of variable-size calls, only for calls on main thread
+  fcrypto_arena* arena_ = nullptr;
+  // Shared for async workers, exclusive for context randomization
+  std::shared_timed_mutex ctx_mutex_;
+  AddonStats stats_;
+  // Classes of handles of this env (see Init), static references would be
+  // overwritten by other envs (worker threads)
+  Napi::FunctionReference pubkey_constructor_;
+  Napi::FunctionReference verifier_constructor_;
   static Napi::FunctionReference constructor;
 
+  friend class PubkeyArg;
+  friend class Secp256k1Verifier;
+  friend class Secp256k1Worker;
+
+  // Registered instead of Method, see SECP256K1_ADDON_METHODS
+  template <Napi::Value (Secp256k1Addon::*Method)(const Napi::CallbackInfo&),
+            Secp256k1Method Id>
+  Napi::Value Instrumented(const Napi::CallbackInfo& info) {
+    if (!stats_.Enabled()) {
+      return (this->*Method)(info);
+    }
+
+    auto start = AddonStats::Clock::now();
+    auto result = (this->*Method)(info);
+    stats_.Record(Id, result.As<Napi::Number>().Int32Value(), start);
+    return result;
+  }
+
+  Napi::Value BuildInfo(const Napi::CallbackInfo& info);
+  Napi::Value StatsEnable(const Napi::CallbackInfo& info);
+  Napi::Value StatsReset(const Napi::CallbackInfo& info);
+  Napi::Value StatsSnapshot(const Napi::CallbackInfo& info);
   Napi::Value ContextRandomize(const Napi::CallbackInfo& info);
 
   Napi::Value PrivateKeyVerify(const Napi::CallbackInfo& info);
@@ -23,9 +173,11 @@ class Secp256k1Addon : public Napi::ObjectWrap<Secp256k1Addon> {
   Napi::Value PrivateKeyTweakMul(const Napi::CallbackInfo& info);
 
   Napi::Value PublicKeyCreate(const Napi::CallbackInfo& info);
+  Napi::Value PublicKeyParse(const Napi::CallbackInfo& info);
   Napi::Value PublicKeyConvert(const Napi::CallbackInfo& info);
   Napi::Value PublicKeyNegate(const Napi::CallbackInfo& info);
   Napi::Value PublicKeyCombine(const Napi::CallbackInfo& info);
+  Napi::Value PublicKeyLinearCombination(const Napi::CallbackInfo& info);
   Napi::Value PublicKeyTweakAdd(const Napi::CallbackInfo& info);
   Napi::Value PublicKeyTweakMul(const Napi::CallbackInfo& info);
 
@@ -35,9 +187,45 @@ class Secp256k1Addon : public Napi::ObjectWrap<Secp256k1Addon> {
 
   Napi::Value ECDSASign(const Napi::CallbackInfo& info);
   Napi::Value ECDSAVerify(const Napi::CallbackInfo& info);
+  Napi::Value ECDSASignMessage(const Napi::CallbackInfo& info);
+  Napi::Value ECDSAVerifyMessage(const Napi::CallbackInfo& info);
+  Napi::Value ECDSAVerifyBatch(const Napi::CallbackInfo& info);
+  Napi::Value ECDSAVerifierCreate(const Napi::CallbackInfo& info);
+  Napi::Value ECDSAVerifierDestroy(const Napi::CallbackInfo& info);
+  Napi::Value ECDSAVerifyPrepared(const Napi::CallbackInfo& info);
   Napi::Value ECDSARecover(const Napi::CallbackInfo& info);
+  Napi::Value ECDSARecoverAddress(const Napi::CallbackInfo& info);
+
+  Napi::Value XOnlyPublicKeyCreate(const Napi::CallbackInfo& info);
+  Napi::Value XOnlyPublicKeyConvert(const Napi::CallbackInfo& info);
+  Napi::Value SchnorrSign(const Napi::CallbackInfo& info);
+  Napi::Value SchnorrVerify(const Napi::CallbackInfo& info);
+  Napi::Value SchnorrVerifyBatch(const Napi::CallbackInfo& info);
 
   Napi::Value ECDH(const Napi::CallbackInfo& info);
+
+  Napi::Value PrivateKeyVerifyMany(const Napi::CallbackInfo& info);
+  Napi::Value PublicKeyCreateMany(const Napi::CallbackInfo& info);
+  Napi::Value PublicKeyCreateRange(const Napi::CallbackInfo& info);
+  Napi::Value ECDSASignMany(const Napi::CallbackInfo& info);
+  Napi::Value ECDSAVerifyMany(const Napi::CallbackInfo& info);
+  Napi::Value ECDSASignMessageMany(const Napi::CallbackInfo& info);
+  Napi::Value ECDSAVerifyMessageMany(const Napi::CallbackInfo& info);
+  Napi::Value ECDSARecoverMany(const Napi::CallbackInfo& info);
+  Napi::Value ECDSARecoverAddressMany(const Napi::CallbackInfo& info);
+  Napi::Value ECDHMany(const Napi::CallbackInfo& info);
+  Napi::Value ECDHPubkeysMany(const Napi::CallbackInfo& info);
+
+  Napi::Value BIP32FromSeed(const Napi::CallbackInfo& info);
+  Napi::Value BIP32Derive(const Napi::CallbackInfo& info);
+  Napi::Value BIP32DeriveRange(const Napi::CallbackInfo& info);
+
+  // Async, see secp256k1_async.cc
+  Napi::Value ECDSASignAsync(const Napi::CallbackInfo& info);
+  Napi::Value ECDSAVerifyAsync(const Napi::CallbackInfo& info);
+  Napi::Value ECDSARecoverAsync(const Napi::CallbackInfo& info);
+  Napi::Value ECDHAsync(const Napi::CallbackInfo& info);
+  Napi::Value ECDSAVerifyManyAsync(const Napi::CallbackInfo& info);
 };
 
 #endif  // ADDON_SECP256K1
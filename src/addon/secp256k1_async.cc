@@ -0,0 +1,275 @@
+#include <addon/executor.h>
+#include <addon/secp256k1.h>
+
+#include <array>
+#include <cstring>
+#include <vector>
+
+// Async workers run on libuv threadpool (see UV_THREADPOOL_SIZE).
+// Inputs copied on creation, so JS side can change or free buffers right after
+// call. Outputs written to JS buffers only in OnOK, which called on main
+// thread, while references keep these buffers alive. Addon itself referenced
+// until worker is done, so context can not be destroyed by GC in the middle.
+class Secp256k1Worker : public Napi::AsyncWorker {
+ public:
+  Secp256k1Worker(Secp256k1Addon* addon,
+                  Napi::Env env,
+                  Secp256k1Method method)
+      : Napi::AsyncWorker(env),
+        addon_(addon),
+        method_(method),
+        deferred_(Napi::Promise::Deferred::New(env)) {
+    addon_->Ref();
+  }
+
+  ~Secp256k1Worker() { addon_->Unref(); }
+
+  Napi::Promise Queue() {
+    auto promise = deferred_.Promise();
+    Napi::AsyncWorker::Queue();
+    return promise;
+  }
+
+ protected:
+  // Context randomization change context, so it's exclusive lock.
+  // Latency in stats is time of Run, without time in threadpool queue.
+  void Execute() override {
+    std::shared_lock<std::shared_timed_mutex> lock(addon_->ctx_mutex_);
+    if (!addon_->stats_.Enabled()) {
+      ret_ = Run(addon_->ctx_);
+      return;
+    }
+
+    auto start = AddonStats::Clock::now();
+    ret_ = Run(addon_->ctx_);
+    addon_->stats_.Record(method_, ret_, start);
+  }
+
+  void OnOK() override {
+    Napi::HandleScope scope(Env());
+    if (ret_ == 0) {
+      Complete();
+    }
+    deferred_.Resolve(Napi::Number::New(Env(), ret_));
+  }
+
+  void OnError(const Napi::Error& e) override {
+    Napi::HandleScope scope(Env());
+    deferred_.Reject(e.Value());
+  }
+
+  virtual int Run(const secp256k1_context* ctx) = 0;
+  virtual void Complete() {}
+
+ private:
+  Secp256k1Addon* addon_;
+  Secp256k1Method method_;
+  Napi::Promise::Deferred deferred_;
+  int ret_ = 0;
+};
+
+// Copy of public key, length can be 33 or 65 (or 64 for parsed key)
+static std::vector<unsigned char> CopyPubkey(Secp256k1Addon* addon,
+                                             const Napi::Value& value) {
+  PubkeyArg pubkey(addon, value);
+  return std::vector<unsigned char>(pubkey.Data(),
+                                    pubkey.Data() + pubkey.Length());
+}
+
+template <size_t N>
+static std::array<unsigned char, N> CopyArray(const Napi::Value& value) {
+  std::array<unsigned char, N> arr;
+  auto data = value.As<Napi::Buffer<const unsigned char>>().Data();
+  std::memcpy(arr.data(), data, N);
+  return arr;
+}
+
+// ECDSA
+class ECDSASignWorker : public Secp256k1Worker {
+ public:
+  ECDSASignWorker(Secp256k1Addon* addon, const Napi::CallbackInfo& info)
+      : Secp256k1Worker(addon, info.Env(), kMethodECDSASignAsync),
+        obj_(Napi::Persistent(info[0].As<Napi::Object>())),
+        msg32_(CopyArray<32>(info[1])),
+        seckey_(CopyArray<32>(info[2])) {}
+
+  ~ECDSASignWorker() { std::memset(seckey_.data(), 0, seckey_.size()); }
+
+ protected:
+  int Run(const secp256k1_context* ctx) override {
+    return fcrypto_secp256k1_ecdsa_sign(
+        ctx, output_.data(), &recid_, msg32_.data(), seckey_.data());
+  }
+
+  void Complete() override {
+    auto obj = obj_.Value();
+    auto output = obj.Get("signature").As<Napi::Buffer<unsigned char>>();
+    std::memcpy(output.Data(), output_.data(), output_.size());
+    obj.Set("recid", recid_);
+  }
+
+ private:
+  Napi::ObjectReference obj_;
+  std::array<unsigned char, 32> msg32_;
+  std::array<unsigned char, 32> seckey_;
+  std::array<unsigned char, 64> output_;
+  int recid_;
+};
+
+class ECDSAVerifyWorker : public Secp256k1Worker {
+ public:
+  ECDSAVerifyWorker(Secp256k1Addon* addon, const Napi::CallbackInfo& info)
+      : Secp256k1Worker(addon, info.Env(), kMethodECDSAVerifyAsync),
+        sig_(CopyArray<64>(info[0])),
+        msg32_(CopyArray<32>(info[1])),
+        pubkey_(CopyPubkey(addon, info[2])) {}
+
+ protected:
+  int Run(const secp256k1_context* ctx) override {
+    return fcrypto_secp256k1_ecdsa_verify(
+        ctx, sig_.data(), msg32_.data(), pubkey_.data(), pubkey_.size());
+  }
+
+ private:
+  std::array<unsigned char, 64> sig_;
+  std::array<unsigned char, 32> msg32_;
+  std::vector<unsigned char> pubkey_;
+};
+
+class ECDSARecoverWorker : public Secp256k1Worker {
+ public:
+  ECDSARecoverWorker(Secp256k1Addon* addon, const Napi::CallbackInfo& info)
+      : Secp256k1Worker(addon, info.Env(), kMethodECDSARecoverAsync),
+        output_(Napi::Persistent(info[0].As<Napi::Buffer<unsigned char>>())),
+        outputlen_(output_.Value().Length()),
+        sig_(CopyArray<64>(info[1])),
+        recid_(info[2].As<Napi::Number>().Int32Value()),
+        msg32_(CopyArray<32>(info[3])) {}
+
+ protected:
+  int Run(const secp256k1_context* ctx) override {
+    return fcrypto_secp256k1_ecdsa_recover(ctx,
+                                           pubkey_.data(),
+                                           sig_.data(),
+                                           recid_,
+                                           msg32_.data(),
+                                           outputlen_);
+  }
+
+  void Complete() override {
+    std::memcpy(output_.Value().Data(), pubkey_.data(), outputlen_);
+  }
+
+ private:
+  Napi::Reference<Napi::Buffer<unsigned char>> output_;
+  size_t outputlen_;
+  std::array<unsigned char, 64> sig_;
+  int recid_;
+  std::array<unsigned char, 32> msg32_;
+  std::array<unsigned char, 65> pubkey_;
+};
+
+// ECDH
+class ECDHWorker : public Secp256k1Worker {
+ public:
+  ECDHWorker(Secp256k1Addon* addon, const Napi::CallbackInfo& info)
+      : Secp256k1Worker(addon, info.Env(), kMethodECDHAsync),
+        output_(Napi::Persistent(info[0].As<Napi::Buffer<unsigned char>>())),
+        pubkey_(CopyPubkey(addon, info[1])),
+        seckey_(CopyArray<32>(info[2])) {}
+
+  ~ECDHWorker() {
+    std::memset(seckey_.data(), 0, seckey_.size());
+    std::memset(secret_.data(), 0, secret_.size());
+  }
+
+ protected:
+  int Run(const secp256k1_context* ctx) override {
+    return fcrypto_secp256k1_ecdh(
+        ctx, secret_.data(), pubkey_.data(), pubkey_.size(), seckey_.data());
+  }
+
+  void Complete() override {
+    std::memcpy(output_.Value().Data(), secret_.data(), secret_.size());
+  }
+
+ private:
+  Napi::Reference<Napi::Buffer<unsigned char>> output_;
+  std::vector<unsigned char> pubkey_;
+  std::array<unsigned char, 32> seckey_;
+  std::array<unsigned char, 32> secret_;
+};
+
+// Bulk
+// Statuses of every item copied to JS buffer, so worker itself always
+// successful (Complete called only for zero code). With threads > 1 batch
+// split across BatchExecutor same as in sync ecdsaVerifyMany, threadpool
+// thread is one of participants.
+class ECDSAVerifyManyWorker : public Secp256k1Worker {
+ public:
+  ECDSAVerifyManyWorker(Secp256k1Addon* addon, const Napi::CallbackInfo& info)
+      : Secp256k1Worker(addon, info.Env(), kMethodECDSAVerifyManyAsync),
+        statuses_(
+            Napi::Persistent(info[0].As<Napi::Buffer<unsigned char>>())),
+        results_(statuses_.Value().Length()),
+        threads_(info[2].IsNumber() ? info[2].As<Napi::Number>().Uint32Value()
+                                    : 1) {
+    auto inputs = info[1].As<Napi::Buffer<const unsigned char>>();
+    inputs_.assign(inputs.Data(), inputs.Data() + inputs.Length());
+  }
+
+ protected:
+  int Run(const secp256k1_context* ctx) override {
+    size_t n = results_.size();
+    if (n == 0) {
+      return 0;
+    }
+
+    size_t recordlen = inputs_.size() / n;
+    auto verify = [&](size_t begin, size_t end) {
+      fcrypto_secp256k1_ecdsa_verify_many(ctx,
+                                          results_.data() + begin,
+                                          inputs_.data() + begin * recordlen,
+                                          end - begin,
+                                          recordlen - 96);
+    };
+    if (threads_ <= 1 || n <= 1) {
+      verify(0, n);
+    } else {
+      BatchExecutor::Instance().Run(n, threads_, verify);
+    }
+    return 0;
+  }
+
+  void Complete() override {
+    std::memcpy(statuses_.Value().Data(), results_.data(), results_.size());
+  }
+
+ private:
+  Napi::Reference<Napi::Buffer<unsigned char>> statuses_;
+  std::vector<unsigned char> results_;
+  std::vector<unsigned char> inputs_;
+  size_t threads_;
+};
+
+// AsyncWorker delete itself after OnOK / OnError
+Napi::Value Secp256k1Addon::ECDSASignAsync(const Napi::CallbackInfo& info) {
+  return (new ECDSASignWorker(this, info))->Queue();
+}
+
+Napi::Value Secp256k1Addon::ECDSAVerifyAsync(const Napi::CallbackInfo& info) {
+  return (new ECDSAVerifyWorker(this, info))->Queue();
+}
+
+Napi::Value Secp256k1Addon::ECDSARecoverAsync(const Napi::CallbackInfo& info) {
+  return (new ECDSARecoverWorker(this, info))->Queue();
+}
+
+Napi::Value Secp256k1Addon::ECDHAsync(const Napi::CallbackInfo& info) {
+  return (new ECDHWorker(this, info))->Queue();
+}
+
+Napi::Value Secp256k1Addon::ECDSAVerifyManyAsync(
+    const Napi::CallbackInfo& info) {
+  return (new ECDSAVerifyManyWorker(this, info))->Queue();
+}
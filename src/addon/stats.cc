@@ -0,0 +1,77 @@
+#include <addon/stats.h>
+
+constexpr size_t AddonStats::kCodes;
+constexpr size_t AddonStats::kBuckets;
+
+static const auto relaxed = std::memory_order_relaxed;
+
+AddonStats::AddonStats(const char* const* names, size_t count)
+    : names_(names), count_(count), methods_(new Method[count]) {
+  Reset();
+}
+
+// Bucket is bit length of latency in nanoseconds
+void AddonStats::Record(size_t method, int code, Clock::time_point start) {
+  auto elapsed = Clock::now() - start;
+  auto ns = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+
+  size_t bucket = 0;
+  for (uint64_t x = ns; x != 0 && bucket < kBuckets - 1; x >>= 1) {
+    ++bucket;
+  }
+
+  auto& m = methods_[method];
+  m.calls.fetch_add(1, relaxed);
+  if (code >= 0 && static_cast<size_t>(code) < kCodes) {
+    m.codes[code].fetch_add(1, relaxed);
+  }
+  m.sum.fetch_add(ns, relaxed);
+  m.buckets[bucket].fetch_add(1, relaxed);
+}
+
+void AddonStats::Reset() {
+  for (size_t i = 0; i < count_; ++i) {
+    auto& m = methods_[i];
+    m.calls.store(0, relaxed);
+    for (auto& code : m.codes) code.store(0, relaxed);
+    m.sum.store(0, relaxed);
+    for (auto& bucket : m.buckets) bucket.store(0, relaxed);
+  }
+}
+
+// Counters converted to double, exact up to 2^53
+Napi::Object AddonStats::Snapshot(Napi::Env env) const {
+  auto snapshot = Napi::Object::New(env);
+  for (size_t i = 0; i < count_; ++i) {
+    auto& m = methods_[i];
+    uint64_t calls = m.calls.load(relaxed);
+    if (calls == 0) continue;
+
+    auto codes = Napi::Object::New(env);
+    for (size_t code = 0; code < kCodes; ++code) {
+      uint64_t count = m.codes[code].load(relaxed);
+      if (count != 0) {
+        codes.Set(static_cast<uint32_t>(code), static_cast<double>(count));
+      }
+    }
+
+    auto buckets = Napi::Array::New(env, kBuckets);
+    for (size_t bucket = 0; bucket < kBuckets; ++bucket) {
+      buckets.Set(static_cast<uint32_t>(bucket),
+                  static_cast<double>(m.buckets[bucket].load(relaxed)));
+    }
+
+    auto latency = Napi::Object::New(env);
+    latency.Set("sum", static_cast<double>(m.sum.load(relaxed)));
+    latency.Set("buckets", buckets);
+
+    auto method = Napi::Object::New(env);
+    method.Set("calls", static_cast<double>(calls));
+    method.Set("codes", codes);
+    method.Set("latency", latency);
+    snapshot.Set(names_[i], method);
+  }
+
+  return snapshot;
+}
@@ -0,0 +1,53 @@
+#ifndef ADDON_STATS
+#define ADDON_STATS
+
+#include <napi.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+// Per-method counters of Secp256k1Addon: number of calls, number of every
+// return code and latency histogram with power-of-two buckets (bucket 0 is
+// 0ns, bucket i is [2^(i-1), 2^i) ns, last bucket has no upper bound).
+// Disabled by default, then cost of call is one relaxed load. Counters are
+// relaxed atomics, because async workers record on threadpool, so snapshot
+// taken in the middle of calls is not consistent between counters.
+class AddonStats {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  // Codes above kCodes - 1 counted only as calls
+  static constexpr size_t kCodes = 8;
+  static constexpr size_t kBuckets = 40;
+
+  AddonStats(const char* const* names, size_t count);
+
+  bool Enabled() const { return enabled_.load(std::memory_order_relaxed); }
+  void SetEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+
+  void Record(size_t method, int code, Clock::time_point start);
+  void Reset();
+
+  // { [name]: { calls, codes: { [code]: count }, latency: { sum, buckets } } }
+  // only for methods with calls, sum is in nanoseconds
+  Napi::Object Snapshot(Napi::Env env) const;
+
+ private:
+  struct Method {
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> codes[kCodes];
+    std::atomic<uint64_t> sum;
+    std::atomic<uint64_t> buckets[kBuckets];
+  };
+
+  const char* const* names_;
+  size_t count_;
+  std::unique_ptr<Method[]> methods_;
+  std::atomic<bool> enabled_{false};
+};
+
+#endif  // ADDON_STATS
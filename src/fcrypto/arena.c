@@ -0,0 +1,133 @@
+#include <fcrypto/arena.h>
+
+#include <stdlib.h>
+
+#define ARENA_ALIGN 16
+// Region is not grown above this size, bigger calls use malloc every time
+#define ARENA_MAX_SIZE (1024 * 1024)
+
+// Allocation which did not fit to region, data placed after header
+typedef struct arena_block {
+  struct arena_block* next;
+} arena_block;
+
+struct fcrypto_arena_struct {
+  unsigned char* data;
+  size_t size;
+  size_t used;
+  // Bytes allocated in blocks since last reset
+  size_t overflow;
+  // Biggest used + overflow before rewinds since last reset
+  size_t peak;
+  arena_block* blocks;
+};
+
+static size_t align_up(size_t size) {
+  return (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+fcrypto_arena* fcrypto_arena_create(size_t size) {
+  fcrypto_arena* arena = malloc(sizeof(fcrypto_arena));
+  if (arena == NULL) {
+    return NULL;
+  }
+
+  arena->size = align_up(size);
+  arena->data = NULL;
+  if (arena->size > 0) {
+    arena->data = malloc(arena->size);
+    if (arena->data == NULL) {
+      free(arena);
+      return NULL;
+    }
+  }
+
+  arena->used = 0;
+  arena->overflow = 0;
+  arena->peak = 0;
+  arena->blocks = NULL;
+  return arena;
+}
+
+void fcrypto_arena_destroy(fcrypto_arena* arena) {
+  if (arena == NULL) {
+    return;
+  }
+
+  fcrypto_arena_reset(arena);
+  free(arena->data);
+  free(arena);
+}
+
+void* fcrypto_arena_alloc(fcrypto_arena* arena, size_t size) {
+  size = align_up(size);
+  if (size <= arena->size - arena->used) {
+    void* ptr = arena->data + arena->used;
+    arena->used += size;
+    return ptr;
+  }
+
+  // Header size is ARENA_ALIGN, so data keep alignment of malloc
+  arena_block* block = malloc(ARENA_ALIGN + size);
+  if (block == NULL) {
+    return NULL;
+  }
+
+  block->next = arena->blocks;
+  arena->blocks = block;
+  arena->overflow += size;
+  return (unsigned char*)block + ARENA_ALIGN;
+}
+
+void fcrypto_arena_reset(fcrypto_arena* arena) {
+  size_t needed = arena->used + arena->overflow;
+  if (needed < arena->peak) {
+    needed = arena->peak;
+  }
+
+  while (arena->blocks != NULL) {
+    arena_block* next = arena->blocks->next;
+    free(arena->blocks);
+    arena->blocks = next;
+  }
+  arena->used = 0;
+  arena->overflow = 0;
+  arena->peak = 0;
+
+  // Grow region, so next call of same size fit to it. On failure old region
+  // is kept, blocks will be used again.
+  if (needed > arena->size && needed <= ARENA_MAX_SIZE) {
+    unsigned char* data = malloc(needed);
+    if (data != NULL) {
+      free(arena->data);
+      arena->data = data;
+      arena->size = needed;
+    }
+  }
+}
+
+fcrypto_arena_checkpoint fcrypto_arena_get_checkpoint(
+    const fcrypto_arena* arena) {
+  fcrypto_arena_checkpoint checkpoint;
+  checkpoint.used = arena->used;
+  checkpoint.overflow = arena->overflow;
+  checkpoint.blocks = arena->blocks;
+  return checkpoint;
+}
+
+// Blocks are list from newest to oldest, so blocks allocated after
+// checkpoint are at the head
+void fcrypto_arena_rewind(fcrypto_arena* arena,
+                          const fcrypto_arena_checkpoint* checkpoint) {
+  if (arena->used + arena->overflow > arena->peak) {
+    arena->peak = arena->used + arena->overflow;
+  }
+
+  while (arena->blocks != checkpoint->blocks) {
+    arena_block* next = arena->blocks->next;
+    free(arena->blocks);
+    arena->blocks = next;
+  }
+  arena->used = checkpoint->used;
+  arena->overflow = checkpoint->overflow;
+}
@@ -0,0 +1,55 @@
+#ifndef FCRYPTO_ARENA
+#define FCRYPTO_ARENA
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+/** Bump allocator for temporary data of variable-size calls.
+ *  Memory returned by fcrypto_arena_alloc is valid until fcrypto_arena_reset.
+ *  Requests which do not fit to region are served by malloc and freed on
+ *  reset, after that region is grown to size of whole previous call (up to
+ *  1MiB), so calls of same size do not touch heap in steady state.
+ *  Arena is not thread safe.
+ */
+typedef struct fcrypto_arena_struct fcrypto_arena;
+
+/** Create arena with initial region of size bytes.
+ *  Returns: arena, or NULL if there is not enough memory
+ */
+fcrypto_arena* fcrypto_arena_create(size_t size);
+void fcrypto_arena_destroy(fcrypto_arena* arena);
+
+/** Allocate size bytes (aligned to 16) from arena.
+ *  Returns: pointer, or NULL if there is not enough memory
+ */
+void* fcrypto_arena_alloc(fcrypto_arena* arena, size_t size);
+
+/** Release everything allocated since previous reset. */
+void fcrypto_arena_reset(fcrypto_arena* arena);
+
+/** Position in arena, so loops can release memory of every iteration with
+ *  fcrypto_arena_rewind instead of growing arena.
+ */
+typedef struct {
+  size_t used;
+  size_t overflow;
+  void* blocks;
+} fcrypto_arena_checkpoint;
+
+fcrypto_arena_checkpoint fcrypto_arena_get_checkpoint(
+    const fcrypto_arena* arena);
+
+/** Release everything allocated since checkpoint. Size of region after next
+ *  reset still counts memory released here.
+ */
+void fcrypto_arena_rewind(fcrypto_arena* arena,
+                          const fcrypto_arena_checkpoint* checkpoint);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // FCRYPTO_ARENA
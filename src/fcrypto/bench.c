@@ -0,0 +1,955 @@
+// Microbenchmark of functions from secp256k1.h without JavaScript layer
+// (argument checks, allocation of outputs, N-API / WebAssembly calls), so
+// cost of boundary can be measured: benchmarks/secp256k1-native.js runs this
+// program with --json and same methods through addon and WebAssembly.
+// Built and run on host by Makefile (see `bench-native`) with definitions of
+// addon from binding.gyp for selected profile and variant.
+//
+// Every function called in loop over fixtures, time of each sample measured
+// with CLOCK_MONOTONIC and TSC (x86 only; TSC ticks with constant rate, so
+// with turbo or power saving it is not same as core cycles). With --perf on
+// Linux core cycles, instructions, cache misses and branch misses counted by
+// perf_event (user space only, so perf_event_paranoid <= 2 is enough).
+//
+// Usage: fcrypto-bench [--json] [--perf] [--time=ms] [name...]
+// Names are prefixes of benchmark names (ecdsa_verify, pubkey_create_many,
+// ...), SEED environment changes fixtures.
+#define _GNU_SOURCE
+
+#include <fcrypto/hash.h>
+#include <fcrypto/secp256k1.h>
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_TSC 1
+#endif
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define BENCH_HAVE_PERF 1
+#endif
+
+// Fixtures for single calls, items of bulk calls (same as in
+// benchmarks/secp256k1.js), keys with prepared verifier
+#define FIXTURES 256
+#define BULK 1024
+#define BATCH 64
+#define COMBINATION 16
+#define MESSAGE 256
+#define VERIFIERS 16
+
+#define SAMPLES 10
+
+typedef struct {
+  unsigned char seckey[32];
+  unsigned char tweak[32];
+  unsigned char msg32[32];
+  unsigned char pubkey33[33];
+  unsigned char pubkey65[65];
+  unsigned char parsed[64];
+  unsigned char sig[64];
+  int recid;
+  unsigned char der[72];
+  size_t derlen;
+  unsigned char xonly[32];
+  unsigned char schnorr[64];
+  unsigned char msg[MESSAGE];
+  unsigned char msgsig[64];
+} fixture;
+
+static secp256k1_context* ctx;
+static fcrypto_arena* arena;
+static fixture fixtures[FIXTURES];
+static unsigned char* verifiers[VERIFIERS];
+
+// Inputs of bulk calls, records same as in secp256k1.h
+static struct {
+  unsigned char seckeys[BULK * 32];
+  unsigned char sign[BULK * 64];
+  unsigned char verify[BULK * 129];
+  unsigned char recover[BULK * 97];
+  unsigned char ecdh[BULK * 65];
+  unsigned char pubkeys[BULK * 33];
+  unsigned char msgs[BULK * MESSAGE];
+  uint32_t offsets[BULK + 1];
+  unsigned char verify_message[BULK * 97];
+  unsigned char schnorr[BULK * 128];
+  const unsigned char* sigs[BATCH];
+  int recids[BATCH];
+  const unsigned char* msgs32[BATCH];
+  const unsigned char* inputs[COMBINATION];
+  size_t inputslen[COMBINATION];
+  unsigned char scalars[COMBINATION * 32];
+} bulk;
+
+// Outputs, content is not used
+static unsigned char output[BULK * 65];
+static unsigned char statuses[BULK];
+static unsigned char scratch[72];
+
+static const fixture* fixture_at(size_t i) {
+  return &fixtures[i % FIXTURES];
+}
+
+// Setup
+
+static void fatal(const char* name, int ret) {
+  fprintf(stderr, "%s failed with code %d\n", name, ret);
+  exit(1);
+}
+
+#define CHECK(call)                \
+  do {                             \
+    int ret_ = (call);             \
+    if (ret_ != 0) {               \
+      fatal(#call, ret_);          \
+    }                              \
+  } while (0)
+
+// sha256(seed || tag || i), so fixtures are same for same SEED
+static void derive(unsigned char* out32,
+                   const char* seed,
+                   const char* tag,
+                   uint32_t i) {
+  fcrypto_sha256 hash;
+  unsigned char index[4] = {(unsigned char)(i >> 24), (unsigned char)(i >> 16),
+                            (unsigned char)(i >> 8), (unsigned char)i};
+  fcrypto_sha256_init(&hash);
+  fcrypto_sha256_update(&hash, (const unsigned char*)seed, strlen(seed));
+  fcrypto_sha256_update(&hash, (const unsigned char*)tag, strlen(tag));
+  fcrypto_sha256_update(&hash, index, 4);
+  fcrypto_sha256_finalize(&hash, out32);
+}
+
+static void create_fixtures(const char* seed) {
+  for (uint32_t i = 0; i < FIXTURES; ++i) {
+    fixture* f = &fixtures[i];
+    size_t len;
+
+    // Invalid key probability is below 2^-127, but keep loop honest
+    for (uint32_t j = 0;; ++j) {
+      derive(f->seckey, seed, "seckey", i * 16 + j);
+      if (fcrypto_secp256k1_seckey_verify(ctx, f->seckey) == 0) {
+        break;
+      }
+    }
+    derive(f->tweak, seed, "tweak", i);
+    derive(f->msg32, seed, "msg32", i);
+    for (size_t j = 0; j < MESSAGE; j += 32) {
+      derive(f->msg + j, seed, "msg", (uint32_t)(i * MESSAGE + j));
+    }
+
+    CHECK(fcrypto_secp256k1_pubkey_create(ctx, f->pubkey33, f->seckey, 33));
+    CHECK(fcrypto_secp256k1_pubkey_create(ctx, f->pubkey65, f->seckey, 65));
+    CHECK(fcrypto_secp256k1_pubkey_parse(ctx, f->parsed, f->pubkey33, 33));
+    CHECK(fcrypto_secp256k1_ecdsa_sign(
+        ctx, f->sig, &f->recid, f->msg32, f->seckey));
+    len = sizeof(f->der);
+    CHECK(fcrypto_secp256k1_signature_export(ctx, f->der, &len, f->sig));
+    f->derlen = len;
+    CHECK(fcrypto_secp256k1_xonly_pubkey_create(ctx, f->xonly, f->seckey));
+    CHECK(fcrypto_secp256k1_schnorr_sign(
+        ctx, f->schnorr, f->msg32, f->seckey, NULL));
+    CHECK(fcrypto_secp256k1_ecdsa_sign_message(ctx, f->msgsig, &f->recid,
+                                               f->msg, MESSAGE, f->seckey,
+                                               FCRYPTO_HASH_SHA256));
+    // recid of msg32 signature is used by recover and batch verification
+    CHECK(fcrypto_secp256k1_ecdsa_sign(
+        ctx, f->sig, &f->recid, f->msg32, f->seckey));
+  }
+
+  for (size_t i = 0; i < VERIFIERS; ++i) {
+    verifiers[i] = malloc(fcrypto_secp256k1_verifier_size());
+    if (verifiers[i] == NULL) {
+      fatal("malloc", 1);
+    }
+    CHECK(fcrypto_secp256k1_verifier_init(
+        ctx, verifiers[i], fixtures[i].pubkey33, 33));
+  }
+
+  for (size_t i = 0; i < BULK; ++i) {
+    const fixture* f = fixture_at(i);
+    memcpy(bulk.seckeys + i * 32, f->seckey, 32);
+    memcpy(bulk.sign + i * 64, f->msg32, 32);
+    memcpy(bulk.sign + i * 64 + 32, f->seckey, 32);
+    memcpy(bulk.verify + i * 129, f->sig, 64);
+    memcpy(bulk.verify + i * 129 + 64, f->msg32, 32);
+    memcpy(bulk.verify + i * 129 + 96, f->pubkey33, 33);
+    memcpy(bulk.recover + i * 97, f->sig, 64);
+    bulk.recover[i * 97 + 64] = (unsigned char)f->recid;
+    memcpy(bulk.recover + i * 97 + 65, f->msg32, 32);
+    memcpy(bulk.ecdh + i * 65, f->pubkey33, 33);
+    memcpy(bulk.ecdh + i * 65 + 33, f->seckey, 32);
+    memcpy(bulk.pubkeys + i * 33, f->pubkey33, 33);
+    memcpy(bulk.msgs + i * MESSAGE, f->msg, MESSAGE);
+    bulk.offsets[i] = (uint32_t)(i * MESSAGE);
+    memcpy(bulk.verify_message + i * 97, f->msgsig, 64);
+    memcpy(bulk.verify_message + i * 97 + 64, f->pubkey33, 33);
+    memcpy(bulk.schnorr + i * 128, f->schnorr, 64);
+    memcpy(bulk.schnorr + i * 128 + 64, f->msg32, 32);
+    memcpy(bulk.schnorr + i * 128 + 96, f->xonly, 32);
+  }
+  bulk.offsets[BULK] = BULK * MESSAGE;
+
+  for (size_t i = 0; i < BATCH; ++i) {
+    bulk.sigs[i] = fixtures[i].sig;
+    bulk.recids[i] = fixtures[i].recid;
+    bulk.msgs32[i] = fixtures[i].msg32;
+  }
+
+  for (size_t i = 0; i < COMBINATION; ++i) {
+    bulk.inputs[i] = fixtures[i].pubkey33;
+    bulk.inputslen[i] = 33;
+    memcpy(bulk.scalars + i * 32, fixtures[i].tweak, 32);
+  }
+}
+
+// Benchmarks, i is number of call. In-place functions work on copy, so
+// fixtures stay same between samples.
+
+static int bench_context_create(size_t i) {
+  (void)i;
+  secp256k1_context* c = fcrypto_secp256k1_context_create();
+  if (c == NULL) {
+    return 1;
+  }
+  fcrypto_secp256k1_context_destroy(c);
+  return 0;
+}
+
+static int bench_context_clone(size_t i) {
+  (void)i;
+  secp256k1_context* c = fcrypto_secp256k1_context_clone(ctx);
+  if (c == NULL) {
+    return 1;
+  }
+  fcrypto_secp256k1_context_clone_destroy(c);
+  return 0;
+}
+
+static int bench_context_randomize(size_t i) {
+  return fcrypto_secp256k1_context_randomize(ctx, fixture_at(i)->tweak);
+}
+
+static int bench_seckey_verify(size_t i) {
+  return fcrypto_secp256k1_seckey_verify(ctx, fixture_at(i)->seckey);
+}
+
+static int bench_seckey_negate(size_t i) {
+  memcpy(scratch, fixture_at(i)->seckey, 32);
+  return fcrypto_secp256k1_seckey_negate(ctx, scratch);
+}
+
+static int bench_seckey_tweak_add(size_t i) {
+  const fixture* f = fixture_at(i);
+  memcpy(scratch, f->seckey, 32);
+  return fcrypto_secp256k1_seckey_tweak_add(ctx, scratch, f->tweak);
+}
+
+static int bench_seckey_tweak_mul(size_t i) {
+  const fixture* f = fixture_at(i);
+  memcpy(scratch, f->seckey, 32);
+  return fcrypto_secp256k1_seckey_tweak_mul(ctx, scratch, f->tweak);
+}
+
+static int bench_pubkey_create(size_t i) {
+  return fcrypto_secp256k1_pubkey_create(ctx, output, fixture_at(i)->seckey,
+                                         33);
+}
+
+static int bench_pubkey_parse(size_t i) {
+  return fcrypto_secp256k1_pubkey_parse(ctx, output, fixture_at(i)->pubkey33,
+                                        33);
+}
+
+static int bench_pubkey_convert(size_t i) {
+  return fcrypto_secp256k1_pubkey_convert(ctx, output, fixture_at(i)->pubkey33,
+                                          33, 65);
+}
+
+static int bench_pubkey_negate(size_t i) {
+  return fcrypto_secp256k1_pubkey_negate(ctx, output, fixture_at(i)->pubkey33,
+                                         33, 33);
+}
+
+static int bench_pubkey_combine(size_t i) {
+  const unsigned char* inputs[2] = {fixture_at(i)->pubkey33,
+                                    fixture_at(i + 1)->pubkey33};
+  const size_t inputslen[2] = {33, 33};
+  int ret = fcrypto_secp256k1_pubkey_combine(ctx, arena, output, inputs,
+                                             inputslen, 2, 33);
+  fcrypto_arena_reset(arena);
+  return ret;
+}
+
+static int bench_pubkey_linear_combination(size_t i) {
+  int ret = fcrypto_secp256k1_pubkey_linear_combination(
+      ctx, arena, output, bulk.inputs, bulk.inputslen, bulk.scalars,
+      fixture_at(i)->tweak, COMBINATION, 33);
+  fcrypto_arena_reset(arena);
+  return ret;
+}
+
+static int bench_pubkey_tweak_add(size_t i) {
+  const fixture* f = fixture_at(i);
+  return fcrypto_secp256k1_pubkey_tweak_add(ctx, output, f->pubkey33, 33,
+                                            f->tweak, 33);
+}
+
+static int bench_pubkey_tweak_mul(size_t i) {
+  const fixture* f = fixture_at(i);
+  return fcrypto_secp256k1_pubkey_tweak_mul(ctx, output, f->pubkey33, 33,
+                                            f->tweak, 33);
+}
+
+static int bench_signature_normalize(size_t i) {
+  memcpy(scratch, fixture_at(i)->sig, 64);
+  return fcrypto_secp256k1_signature_normalize(ctx, scratch);
+}
+
+static int bench_signature_export(size_t i) {
+  size_t outputlen = 72;
+  return fcrypto_secp256k1_signature_export(ctx, output, &outputlen,
+                                            fixture_at(i)->sig);
+}
+
+static int bench_signature_import(size_t i) {
+  const fixture* f = fixture_at(i);
+  return fcrypto_secp256k1_signature_import(ctx, output, f->der, f->derlen);
+}
+
+static int bench_ecdsa_sign(size_t i) {
+  const fixture* f = fixture_at(i);
+  int recid;
+  return fcrypto_secp256k1_ecdsa_sign(ctx, output, &recid, f->msg32,
+                                      f->seckey);
+}
+
+static int bench_ecdsa_verify(size_t i) {
+  const fixture* f = fixture_at(i);
+  return fcrypto_secp256k1_ecdsa_verify(ctx, f->sig, f->msg32, f->pubkey33,
+                                        33);
+}
+
+static int bench_ecdsa_verify_parsed(size_t i) {
+  const fixture* f = fixture_at(i);
+  return fcrypto_secp256k1_ecdsa_verify(ctx, f->sig, f->msg32, f->parsed, 64);
+}
+
+static int bench_ecdsa_sign_message(size_t i) {
+  const fixture* f = fixture_at(i);
+  int recid;
+  return fcrypto_secp256k1_ecdsa_sign_message(
+      ctx, output, &recid, f->msg, MESSAGE, f->seckey, FCRYPTO_HASH_SHA256);
+}
+
+static int bench_ecdsa_verify_message(size_t i) {
+  const fixture* f = fixture_at(i);
+  return fcrypto_secp256k1_ecdsa_verify_message(
+      ctx, f->msgsig, f->msg, MESSAGE, f->pubkey33, 33, FCRYPTO_HASH_SHA256);
+}
+
+static int bench_verifier_init(size_t i) {
+  return fcrypto_secp256k1_verifier_init(ctx, verifiers[i % VERIFIERS],
+                                         fixture_at(i % VERIFIERS)->pubkey33,
+                                         33);
+}
+
+static int bench_ecdsa_verify_prepared(size_t i) {
+  const fixture* f = fixture_at(i % VERIFIERS);
+  return fcrypto_secp256k1_ecdsa_verify_prepared(ctx, f->sig, f->msg32,
+                                                 verifiers[i % VERIFIERS]);
+}
+
+static int bench_ecdsa_verify_batch(size_t i) {
+  (void)i;
+  const unsigned char* inputs[BATCH];
+  size_t inputslen[BATCH];
+  for (size_t j = 0; j < BATCH; ++j) {
+    inputs[j] = fixtures[j].pubkey33;
+    inputslen[j] = 33;
+  }
+  int ret = fcrypto_secp256k1_ecdsa_verify_batch(
+      ctx, arena, statuses, bulk.sigs, bulk.recids, bulk.msgs32, inputs,
+      inputslen, BATCH);
+  fcrypto_arena_reset(arena);
+  return ret;
+}
+
+static int bench_ecdsa_recover(size_t i) {
+  const fixture* f = fixture_at(i);
+  return fcrypto_secp256k1_ecdsa_recover(ctx, output, f->sig, f->recid,
+                                         f->msg32, 33);
+}
+
+static int bench_ecdsa_recover_address(size_t i) {
+  const fixture* f = fixture_at(i);
+  return fcrypto_secp256k1_ecdsa_recover_address(
+      ctx, output, f->sig, f->recid, f->msg32, FCRYPTO_ADDRESS_KECCAK256);
+}
+
+static int bench_xonly_pubkey_create(size_t i) {
+  return fcrypto_secp256k1_xonly_pubkey_create(ctx, output,
+                                               fixture_at(i)->seckey);
+}
+
+static int bench_xonly_pubkey_convert(size_t i) {
+  return fcrypto_secp256k1_xonly_pubkey_convert(ctx, output,
+                                                fixture_at(i)->pubkey33, 33);
+}
+
+static int bench_schnorr_sign(size_t i) {
+  const fixture* f = fixture_at(i);
+  return fcrypto_secp256k1_schnorr_sign(ctx, output, f->msg32, f->seckey,
+                                        NULL);
+}
+
+static int bench_schnorr_verify(size_t i) {
+  const fixture* f = fixture_at(i);
+  return fcrypto_secp256k1_schnorr_verify(ctx, f->schnorr, f->msg32,
+                                          f->xonly);
+}
+
+static int bench_schnorr_verify_batch(size_t i) {
+  (void)i;
+  int ret = fcrypto_secp256k1_schnorr_verify_batch(ctx, arena, statuses,
+                                                   bulk.schnorr, BULK, BATCH);
+  fcrypto_arena_reset(arena);
+  return ret;
+}
+
+static int bench_ecdh(size_t i) {
+  const fixture* f = fixture_at(i);
+  return fcrypto_secp256k1_ecdh(ctx, output, f->pubkey33, 33,
+                                fixture_at(i + 1)->seckey);
+}
+
+static int bench_ecdh_mode(size_t i) {
+  const fixture* f = fixture_at(i);
+  return fcrypto_secp256k1_ecdh_mode(ctx, output, f->pubkey33, 33,
+                                     fixture_at(i + 1)->seckey,
+                                     FCRYPTO_ECDH_RAW_X);
+}
+
+static int ecdh_copy_x(unsigned char* output,
+                       const unsigned char* x32,
+                       const unsigned char* y32,
+                       void* data) {
+  (void)y32;
+  (void)data;
+  memcpy(output, x32, 32);
+  return 1;
+}
+
+static int bench_ecdh_custom(size_t i) {
+  const fixture* f = fixture_at(i);
+  return fcrypto_secp256k1_ecdh_custom(ctx, output, f->pubkey33, 33,
+                                       fixture_at(i + 1)->seckey, ecdh_copy_x,
+                                       NULL);
+}
+
+static int bench_seckey_verify_many(size_t i) {
+  (void)i;
+  return fcrypto_secp256k1_seckey_verify_many(ctx, statuses, bulk.seckeys,
+                                              BULK);
+}
+
+static int bench_pubkey_create_many(size_t i) {
+  (void)i;
+  return fcrypto_secp256k1_pubkey_create_many(ctx, output, statuses,
+                                              bulk.seckeys, BULK, 33);
+}
+
+static int bench_pubkey_create_range(size_t i) {
+  return fcrypto_secp256k1_pubkey_create_range(
+      ctx, output, statuses, fixture_at(i)->seckey, BULK, 33);
+}
+
+static int bench_ecdsa_sign_many(size_t i) {
+  (void)i;
+  return fcrypto_secp256k1_ecdsa_sign_many(ctx, output, statuses, bulk.sign,
+                                           BULK);
+}
+
+static int bench_ecdsa_verify_many(size_t i) {
+  (void)i;
+  return fcrypto_secp256k1_ecdsa_verify_many(ctx, statuses, bulk.verify, BULK,
+                                             33);
+}
+
+static int bench_ecdsa_sign_message_many(size_t i) {
+  (void)i;
+  return fcrypto_secp256k1_ecdsa_sign_message_many(
+      ctx, output, statuses, bulk.seckeys, bulk.msgs, bulk.offsets, BULK,
+      FCRYPTO_HASH_SHA256);
+}
+
+static int bench_ecdsa_verify_message_many(size_t i) {
+  (void)i;
+  return fcrypto_secp256k1_ecdsa_verify_message_many(
+      ctx, statuses, bulk.verify_message, bulk.msgs, bulk.offsets, BULK, 33,
+      FCRYPTO_HASH_SHA256);
+}
+
+static int bench_ecdsa_recover_many(size_t i) {
+  (void)i;
+  return fcrypto_secp256k1_ecdsa_recover_many(ctx, output, statuses,
+                                              bulk.recover, BULK, 33);
+}
+
+static int bench_ecdsa_recover_address_many(size_t i) {
+  (void)i;
+  return fcrypto_secp256k1_ecdsa_recover_address_many(
+      ctx, output, statuses, bulk.recover, BULK, FCRYPTO_ADDRESS_KECCAK256);
+}
+
+static int bench_ecdh_many(size_t i) {
+  (void)i;
+  return fcrypto_secp256k1_ecdh_many(ctx, output, statuses, bulk.ecdh, BULK,
+                                     33);
+}
+
+static int bench_ecdh_pubkeys_many(size_t i) {
+  return fcrypto_secp256k1_ecdh_pubkeys_many(
+      ctx, output, statuses, fixture_at(i)->seckey, bulk.pubkeys, BULK, 33,
+      FCRYPTO_ECDH_SHA256);
+}
+
+// name: function without fcrypto_secp256k1_ prefix
+// method: method of JavaScript API with same work (NULL if there is no such)
+// items: number of items processed by one call, results are per item
+typedef struct {
+  const char* name;
+  const char* method;
+  int (*fn)(size_t i);
+  size_t items;
+} benchmark;
+
+static const benchmark benchmarks[] = {
+    {"context_create", NULL, bench_context_create, 1},
+    {"context_clone", NULL, bench_context_clone, 1},
+    {"context_randomize", "contextRandomize", bench_context_randomize, 1},
+    {"seckey_verify", "privateKeyVerify", bench_seckey_verify, 1},
+    {"seckey_negate", "privateKeyNegate", bench_seckey_negate, 1},
+    {"seckey_tweak_add", "privateKeyTweakAdd", bench_seckey_tweak_add, 1},
+    {"seckey_tweak_mul", "privateKeyTweakMul", bench_seckey_tweak_mul, 1},
+    {"pubkey_create", "publicKeyCreate", bench_pubkey_create, 1},
+    {"pubkey_parse", "publicKeyParse", bench_pubkey_parse, 1},
+    {"pubkey_convert", "publicKeyConvert", bench_pubkey_convert, 1},
+    {"pubkey_negate", "publicKeyNegate", bench_pubkey_negate, 1},
+    {"pubkey_combine", "publicKeyCombine", bench_pubkey_combine, 1},
+    {"pubkey_linear_combination", "publicKeyLinearCombination",
+     bench_pubkey_linear_combination, 1},
+    {"pubkey_tweak_add", "publicKeyTweakAdd", bench_pubkey_tweak_add, 1},
+    {"pubkey_tweak_mul", "publicKeyTweakMul", bench_pubkey_tweak_mul, 1},
+    {"signature_normalize", "signatureNormalize", bench_signature_normalize,
+     1},
+    {"signature_export", "signatureExport", bench_signature_export, 1},
+    {"signature_import", "signatureImport", bench_signature_import, 1},
+    {"ecdsa_sign", "ecdsaSign", bench_ecdsa_sign, 1},
+    {"ecdsa_verify", "ecdsaVerify", bench_ecdsa_verify, 1},
+    {"ecdsa_verify_parsed", "ecdsaVerify", bench_ecdsa_verify_parsed, 1},
+    {"ecdsa_sign_message", "ecdsaSignMessage", bench_ecdsa_sign_message, 1},
+    {"ecdsa_verify_message", "ecdsaVerifyMessage", bench_ecdsa_verify_message,
+     1},
+    {"verifier_init", "ecdsaVerifierCreate", bench_verifier_init, 1},
+    {"ecdsa_verify_prepared", "ecdsaVerify",
+     bench_ecdsa_verify_prepared, 1},
+    {"ecdsa_verify_batch", "ecdsaVerifyBatch", bench_ecdsa_verify_batch,
+     BATCH},
+    {"ecdsa_recover", "ecdsaRecover", bench_ecdsa_recover, 1},
+    {"ecdsa_recover_address", "ecdsaRecoverAddress",
+     bench_ecdsa_recover_address, 1},
+    {"xonly_pubkey_create", "xOnlyPublicKeyCreate", bench_xonly_pubkey_create,
+     1},
+    {"xonly_pubkey_convert", "xOnlyPublicKeyConvert",
+     bench_xonly_pubkey_convert, 1},
+    {"schnorr_sign", "schnorrSign", bench_schnorr_sign, 1},
+    {"schnorr_verify", "schnorrVerify", bench_schnorr_verify, 1},
+    {"schnorr_verify_batch", "schnorrVerifyBatch", bench_schnorr_verify_batch,
+     BULK},
+    {"ecdh", "ecdh", bench_ecdh, 1},
+    {"ecdh_mode", "ecdh", bench_ecdh_mode, 1},
+    {"ecdh_custom", NULL, bench_ecdh_custom, 1},
+    {"seckey_verify_many", "privateKeyVerifyMany", bench_seckey_verify_many,
+     BULK},
+    {"pubkey_create_many", "publicKeyCreateMany", bench_pubkey_create_many,
+     BULK},
+    {"pubkey_create_range", "publicKeyCreateRange", bench_pubkey_create_range,
+     BULK},
+    {"ecdsa_sign_many", "ecdsaSignMany", bench_ecdsa_sign_many, BULK},
+    {"ecdsa_verify_many", "ecdsaVerifyMany", bench_ecdsa_verify_many, BULK},
+    {"ecdsa_sign_message_many", "ecdsaSignMessageMany",
+     bench_ecdsa_sign_message_many, BULK},
+    {"ecdsa_verify_message_many", "ecdsaVerifyMessageMany",
+     bench_ecdsa_verify_message_many, BULK},
+    {"ecdsa_recover_many", "ecdsaRecoverMany", bench_ecdsa_recover_many, BULK},
+    {"ecdsa_recover_address_many", "ecdsaRecoverAddressMany",
+     bench_ecdsa_recover_address_many, BULK},
+    {"ecdh_many", "ecdhMany", bench_ecdh_many, BULK},
+    {"ecdh_pubkeys_many", "ecdhPublicKeysMany", bench_ecdh_pubkeys_many, BULK},
+};
+
+// Counters
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t tsc(void) {
+#ifdef BENCH_HAVE_TSC
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+// Core cycles, instructions, cache misses, branch misses (one group, so all
+// counters are scheduled together)
+#define PERF_COUNTERS 4
+
+typedef struct {
+  int fds[PERF_COUNTERS];
+  int enabled;
+} perf_counters;
+
+#ifdef BENCH_HAVE_PERF
+static int perf_open(perf_counters* perf) {
+  static const uint64_t configs[PERF_COUNTERS] = {
+      PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+  for (int i = 0; i < PERF_COUNTERS; ++i) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = configs[i];
+    attr.disabled = i == 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+
+    int leader = i == 0 ? -1 : perf->fds[0];
+    perf->fds[i] =
+        (int)syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+    if (perf->fds[i] < 0) {
+      while (i-- > 0) {
+        close(perf->fds[i]);
+      }
+      return 0;
+    }
+  }
+
+  perf->enabled = 1;
+  return 1;
+}
+
+static void perf_start(perf_counters* perf) {
+  if (perf->enabled) {
+    ioctl(perf->fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(perf->fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+}
+
+static void perf_stop(perf_counters* perf, uint64_t* values) {
+  struct {
+    uint64_t nr;
+    uint64_t values[PERF_COUNTERS];
+  } data;
+
+  if (!perf->enabled) {
+    return;
+  }
+  ioctl(perf->fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+  if (read(perf->fds[0], &data, sizeof(data)) != (ssize_t)sizeof(data)) {
+    return;
+  }
+  for (int i = 0; i < PERF_COUNTERS; ++i) {
+    values[i] += data.values[i];
+  }
+}
+#else
+static int perf_open(perf_counters* perf) {
+  (void)perf;
+  return 0;
+}
+
+static void perf_start(perf_counters* perf) { (void)perf; }
+
+static void perf_stop(perf_counters* perf, uint64_t* values) {
+  (void)perf;
+  (void)values;
+}
+#endif
+
+// Measurement
+
+typedef struct {
+  double ns;      // median of samples, per item
+  double rme;     // relative margin of error of samples, percent
+  double cycles;  // TSC, per item (0 without TSC)
+  double perf[PERF_COUNTERS];
+  uint64_t calls;
+} result;
+
+static int compare_double(const void* a, const void* b) {
+  double x = *(const double*)a;
+  double y = *(const double*)b;
+  return x < y ? -1 : x > y;
+}
+
+// Calls in sample doubled until sample takes time / SAMPLES, then SAMPLES
+// samples measured. Margin of error is 1.96 * standard error of mean.
+static void measure(const benchmark* b,
+                    perf_counters* perf,
+                    uint64_t time_ns,
+                    result* res) {
+  uint64_t sample_ns = time_ns / SAMPLES;
+  uint64_t calls = 1;
+  uint64_t values[PERF_COUNTERS] = {0};
+  double samples[SAMPLES];
+  double sum = 0;
+  double tsc_sum = 0;
+  size_t i = 0;
+
+  for (;;) {
+    uint64_t ts = now_ns();
+    for (uint64_t j = 0; j < calls; ++j) {
+      b->fn(i++);
+    }
+    if (now_ns() - ts >= sample_ns || calls >= ((uint64_t)1 << 40)) {
+      break;
+    }
+    calls *= 2;
+  }
+
+  for (int s = 0; s < SAMPLES; ++s) {
+    perf_start(perf);
+    uint64_t ts = now_ns();
+    uint64_t cs = tsc();
+    for (uint64_t j = 0; j < calls; ++j) {
+      b->fn(i++);
+    }
+    uint64_t ce = tsc();
+    uint64_t te = now_ns();
+    perf_stop(perf, values);
+
+    samples[s] = (double)(te - ts) / (double)(calls * b->items);
+    tsc_sum += (double)(ce - cs);
+    sum += samples[s];
+  }
+
+  double mean = sum / SAMPLES;
+  double var = 0;
+  for (int s = 0; s < SAMPLES; ++s) {
+    var += (samples[s] - mean) * (samples[s] - mean);
+  }
+  var /= SAMPLES - 1;
+  qsort(samples, SAMPLES, sizeof(samples[0]), compare_double);
+
+  uint64_t items = calls * SAMPLES * b->items;
+  res->ns = (samples[SAMPLES / 2 - 1] + samples[SAMPLES / 2]) / 2;
+  res->rme = mean > 0 ? 196.0 * sqrt(var / SAMPLES) / mean : 0;
+  res->cycles = tsc_sum / (double)items;
+  for (int k = 0; k < PERF_COUNTERS; ++k) {
+    res->perf[k] = (double)values[k] / (double)items;
+  }
+  res->calls = calls;
+}
+
+// Output
+
+// Number with thousands separators, same as toLocaleString('en-US'), small
+// values (bulk calls per item) with two decimals
+static const char* format_num(char* buf, double value) {
+  char digits[32];
+  size_t len, pos = 0;
+
+  if (value < 100) {
+    snprintf(buf, 32, "%.2f", value);
+    return buf;
+  }
+
+  snprintf(digits, sizeof(digits), "%.0f", value);
+  len = strlen(digits);
+  for (size_t i = 0; i < len; ++i) {
+    if (i > 0 && (len - i) % 3 == 0) {
+      buf[pos++] = ',';
+    }
+    buf[pos++] = digits[i];
+  }
+  buf[pos] = '\0';
+  return buf;
+}
+
+// Same layout as util.runSuite of JavaScript benchmarks, so lines can be
+// compared with output of benchmarks/secp256k1.js
+static void print_text(const benchmark* b, const result* res, int perf) {
+  char a[32], c[32], d[32];
+  const char* unit = b->items > 1 ? "item" : "op";
+
+  printf("Benchmarking: fcrypto_secp256k1_%s", b->name);
+  if (b->method != NULL) {
+    printf(" (secp256k1.%s)", b->method);
+  }
+  printf("\n--------------------------------------------------\n");
+  printf("fcrypto/native x %s %ss/sec \u00b1%.2f%% (%d runs sampled)\n",
+         format_num(a, 1e9 / res->ns), unit, res->rme, SAMPLES);
+  printf("%s ns/%s", format_num(a, res->ns), unit);
+#ifdef BENCH_HAVE_TSC
+  printf(", %s TSC cycles/%s", format_num(c, res->cycles), unit);
+#endif
+  printf(" (%s calls per run, %zu items per call)\n",
+         format_num(d, (double)res->calls), b->items);
+  if (perf) {
+    double ipc = res->perf[0] > 0 ? res->perf[1] / res->perf[0] : 0;
+    printf("perf: %s cycles/%s, %s instructions/%s (%.2f IPC), ",
+           format_num(a, res->perf[0]), unit, format_num(c, res->perf[1]),
+           unit, ipc);
+    printf("%.2f cache misses/%s, %.2f branch misses/%s\n", res->perf[2],
+           unit, res->perf[3], unit);
+  }
+  printf("==================================================\n");
+}
+
+// One object per benchmark, values per item
+static void print_json(const benchmark* b,
+                       const result* res,
+                       int perf,
+                       int first) {
+  printf("%s\n  {\"name\": \"%s\", \"method\": ", first ? "[" : ",",
+         b->name);
+  if (b->method != NULL) {
+    printf("\"%s\"", b->method);
+  } else {
+    printf("null");
+  }
+  printf(", \"items\": %zu, \"ns\": %.3f, \"rme\": %.3f, \"samples\": %d",
+         b->items, res->ns, res->rme, SAMPLES);
+#ifdef BENCH_HAVE_TSC
+  printf(", \"tsc\": %.3f", res->cycles);
+#endif
+  if (perf) {
+    printf(", \"cycles\": %.3f, \"instructions\": %.3f", res->perf[0],
+           res->perf[1]);
+    printf(", \"cacheMisses\": %.3f, \"branchMisses\": %.3f", res->perf[2],
+           res->perf[3]);
+  }
+  printf("}");
+}
+
+static int selected(const benchmark* b, int argc, char** argv) {
+  int names = 0;
+  for (int i = 1; i < argc; ++i) {
+    if (argv[i][0] == '-') {
+      continue;
+    }
+    names += 1;
+    if (strncmp(b->name, argv[i], strlen(argv[i])) == 0) {
+      return 1;
+    }
+  }
+  return names == 0;
+}
+
+int main(int argc, char** argv) {
+  perf_counters perf = {{0}, 0};
+  int json = 0;
+  int use_perf = 0;
+  long time_ms = 1000;
+  const char* seed = getenv("SEED");
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--json") == 0) {
+      json = 1;
+    } else if (strcmp(argv[i], "--perf") == 0) {
+      use_perf = 1;
+    } else if (strncmp(argv[i], "--time=", 7) == 0) {
+      time_ms = strtol(argv[i] + 7, NULL, 10);
+    } else if (argv[i][0] == '-') {
+      fprintf(stderr,
+              "Usage: %s [--json] [--perf] [--time=ms] [name...]\n",
+              argv[0]);
+      return 1;
+    }
+  }
+  if (time_ms <= 0) {
+    fprintf(stderr, "Invalid --time\n");
+    return 1;
+  }
+  if (seed == NULL) {
+    seed = "fcrypto";
+  }
+
+  if (use_perf && !perf_open(&perf)) {
+    fprintf(stderr,
+            "perf_event is not available (see "
+            "/proc/sys/kernel/perf_event_paranoid), counters are skipped\n");
+  }
+
+  ctx = fcrypto_secp256k1_context_create();
+  arena = fcrypto_arena_create(64 * 1024);
+  if (ctx == NULL || arena == NULL) {
+    fprintf(stderr, "Can not create context\n");
+    return 1;
+  }
+  create_fixtures(seed);
+
+  if (!json) {
+    printf("Benchmark seed for fixtures: %s\n", seed);
+    printf("Profile: ECMULT_GEN_PREC_BITS=%d, ECMULT_WINDOW_SIZE=%d\n",
+           fcrypto_secp256k1_ecmult_gen_prec_bits(),
+           fcrypto_secp256k1_ecmult_window_size());
+  }
+
+  int first = 1;
+  for (size_t i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); ++i) {
+    const benchmark* b = &benchmarks[i];
+    result res;
+
+    if (!selected(b, argc, argv)) {
+      continue;
+    }
+
+    // Error path is not what we want to measure
+    for (size_t j = 0; j < FIXTURES; ++j) {
+      int ret = b->fn(j);
+      if (ret != 0) {
+        fprintf(stderr, "%s: call %zu returned %d\n", b->name, j, ret);
+        return 1;
+      }
+    }
+
+    measure(b, &perf, (uint64_t)time_ms * 1000000u, &res);
+    if (json) {
+      print_json(b, &res, perf.enabled, first);
+    } else {
+      print_text(b, &res, perf.enabled);
+    }
+    fflush(stdout);
+    first = 0;
+  }
+  if (json) {
+    printf("%s\n", first ? "[]" : "\n]");
+  }
+
+  for (size_t i = 0; i < VERIFIERS; ++i) {
+    free(verifiers[i]);
+  }
+  fcrypto_arena_destroy(arena);
+  fcrypto_secp256k1_context_destroy(ctx);
+  return 0;
+}
@@ -0,0 +1,352 @@
+#include <fcrypto/bip32.h>
+#include <fcrypto/hash.h>
+#include <fcrypto/secp256k1_ext.h>
+
+#include <string.h>
+
+// Children computed in groups, same size as in secp256k1_ext
+#define BIP32_BATCH 64
+
+// Parsed extended key. Public key of private key is computed only when
+// non-hardened derivation or public output need it (see key_pubkey), so
+// path of hardened levels cost only scalar additions.
+typedef struct {
+  unsigned char chain[32];
+  unsigned char seckey[32];
+  secp256k1_pubkey pubkey;
+  int priv;
+  int pubkey_valid;
+} bip32_key;
+
+static void ser32(unsigned char* output, uint32_t index) {
+  output[0] = (unsigned char)(index >> 24);
+  output[1] = (unsigned char)(index >> 16);
+  output[2] = (unsigned char)(index >> 8);
+  output[3] = (unsigned char)index;
+}
+
+static int ser33(const secp256k1_context* ctx,
+                 unsigned char* output,
+                 const secp256k1_pubkey* pubkey) {
+  size_t outputlen = 33;
+  return secp256k1_ec_pubkey_serialize(
+      ctx, output, &outputlen, pubkey, SECP256K1_EC_COMPRESSED);
+}
+
+static int key_load(const secp256k1_context* ctx,
+                    bip32_key* key,
+                    const unsigned char* xkey,
+                    size_t xkeylen) {
+  memcpy(key->chain, xkey, 32);
+  key->priv = xkeylen == 64;
+  key->pubkey_valid = 0;
+  if (key->priv) {
+    memcpy(key->seckey, xkey + 32, 32);
+    return secp256k1_ec_seckey_verify(ctx, key->seckey);
+  }
+
+  key->pubkey_valid =
+      xkeylen == 65 &&
+      secp256k1_ec_pubkey_parse(ctx, &key->pubkey, xkey + 32, 33);
+  return key->pubkey_valid;
+}
+
+// Public key of private key created on first use after load or derivation
+static int key_pubkey(const secp256k1_context* ctx, bip32_key* key) {
+  if (!key->pubkey_valid) {
+    key->pubkey_valid =
+        secp256k1_ec_pubkey_create(ctx, &key->pubkey, key->seckey);
+  }
+  return key->pubkey_valid;
+}
+
+static int key_store(const secp256k1_context* ctx,
+                     unsigned char* output,
+                     size_t outputlen,
+                     bip32_key* key) {
+  memcpy(output, key->chain, 32);
+  if (outputlen == 64) {
+    memcpy(output + 32, key->seckey, 32);
+    return 1;
+  }
+
+  return key_pubkey(ctx, key) && ser33(ctx, output + 32, &key->pubkey);
+}
+
+// HMAC-SHA512(chain, 0x00 || seckey || index) for hardened index, otherwise
+// HMAC-SHA512(chain, ser33(pubkey) || index). Base is HMAC initialized with
+// chain code, parent is serialized data without index (33 bytes).
+static void ckd_hmac(unsigned char* output64,
+                     const fcrypto_hmac_sha512* base,
+                     const unsigned char* parent,
+                     uint32_t index) {
+  fcrypto_hmac_sha512 hmac = *base;
+  unsigned char data[4];
+  ser32(data, index);
+  fcrypto_hmac_sha512_update(&hmac, parent, 33);
+  fcrypto_hmac_sha512_update(&hmac, data, 4);
+  fcrypto_hmac_sha512_finalize(&hmac, output64);
+  memset(&hmac, 0, sizeof(hmac));
+}
+
+// Returns fcrypto_bip32_derive codes (2 or 3) on failure
+static int ckd(const secp256k1_context* ctx, bip32_key* key, uint32_t index) {
+  fcrypto_hmac_sha512 base;
+  unsigned char parent[33];
+  unsigned char i64[64];
+  int ret = 0;
+
+  if (index >= FCRYPTO_BIP32_HARDENED) {
+    if (!key->priv) {
+      return 2;
+    }
+    parent[0] = 0x00;
+    memcpy(parent + 1, key->seckey, 32);
+  } else if (!key_pubkey(ctx, key) || !ser33(ctx, parent, &key->pubkey)) {
+    return 3;
+  }
+
+  fcrypto_hmac_sha512_init(&base, key->chain, 32);
+  ckd_hmac(i64, &base, parent, index);
+
+  // Public key of private child is stale until key_pubkey
+  if (key->priv) {
+    key->pubkey_valid = 0;
+    if (!secp256k1_ec_privkey_tweak_add(ctx, key->seckey, i64)) {
+      ret = 3;
+    }
+  } else if (!secp256k1_ec_pubkey_tweak_add(ctx, &key->pubkey, i64)) {
+    ret = 3;
+  }
+  memcpy(key->chain, i64 + 32, 32);
+
+  memset(&base, 0, sizeof(base));
+  memset(parent, 0, sizeof(parent));
+  memset(i64, 0, sizeof(i64));
+  return ret;
+}
+
+int fcrypto_bip32_from_seed(const secp256k1_context* ctx,
+                            unsigned char* output,
+                            const unsigned char* seed,
+                            size_t seedlen) {
+  static const unsigned char key[12] = "Bitcoin seed";
+  fcrypto_hmac_sha512 hmac;
+  unsigned char i64[64];
+  int ret = 0;
+
+  fcrypto_hmac_sha512_init(&hmac, key, sizeof(key));
+  fcrypto_hmac_sha512_update(&hmac, seed, seedlen);
+  fcrypto_hmac_sha512_finalize(&hmac, i64);
+
+  // Key first in I, but chain code first in extended key
+  memcpy(output, i64 + 32, 32);
+  memcpy(output + 32, i64, 32);
+  if (!secp256k1_ec_seckey_verify(ctx, output + 32)) {
+    memset(output, 0, 64);
+    ret = 1;
+  }
+
+  memset(&hmac, 0, sizeof(hmac));
+  memset(i64, 0, sizeof(i64));
+  return ret;
+}
+
+int fcrypto_bip32_derive(const secp256k1_context* ctx,
+                         unsigned char* output,
+                         size_t outputlen,
+                         const unsigned char* xkey,
+                         size_t xkeylen,
+                         const uint32_t* path,
+                         size_t pathlen) {
+  bip32_key key;
+  int ret = 0;
+
+  if (!key_load(ctx, &key, xkey, xkeylen)) {
+    ret = 1;
+  } else if (!key.priv && outputlen == 64) {
+    ret = 2;
+  }
+
+  for (size_t i = 0; ret == 0 && i < pathlen; ++i) {
+    ret = ckd(ctx, &key, path[i]);
+  }
+
+  if (ret == 0 && !key_store(ctx, output, outputlen, &key)) {
+    ret = 3;
+  }
+
+  memset(&key, 0, sizeof(key));
+  return ret;
+}
+
+// Private parent: child keys computed with scalar addition, public keys (if
+// required) for whole group with secp256k1_ext_pubkey_create_batch. Parent
+// public key created only if range has non-hardened children (range starts
+// below hardened indexes or wraps after 2^32 - 1).
+static int derive_range_priv(const secp256k1_context* ctx,
+                             unsigned char* output,
+                             unsigned char* statuses,
+                             bip32_key* key,
+                             uint32_t index,
+                             size_t n,
+                             size_t outputlen) {
+  fcrypto_hmac_sha512 base;
+  unsigned char hardened[33];
+  unsigned char normal[33];
+  unsigned char i64[64];
+  unsigned char seckeys[BIP32_BATCH * 32];
+  unsigned char pubkeys[BIP32_BATCH * 33];
+  unsigned char valid[BIP32_BATCH];
+  size_t i, j, len;
+  int ret = 0;
+
+  fcrypto_hmac_sha512_init(&base, key->chain, 32);
+  hardened[0] = 0x00;
+  memcpy(hardened + 1, key->seckey, 32);
+  if ((index < FCRYPTO_BIP32_HARDENED || n > 0xffffffffu - index) &&
+      (!key_pubkey(ctx, key) || !ser33(ctx, normal, &key->pubkey))) {
+    ret = 1;
+  }
+
+  for (i = 0; ret == 0 && i < n; i += len) {
+    len = n - i < BIP32_BATCH ? n - i : BIP32_BATCH;
+
+    for (j = 0; j < len; ++j) {
+      uint32_t child = (uint32_t)(index + i + j);
+      unsigned char* record = output + (i + j) * outputlen;
+      unsigned char* seckey = seckeys + j * 32;
+
+      ckd_hmac(i64,
+               &base,
+               child >= FCRYPTO_BIP32_HARDENED ? hardened : normal,
+               child);
+      memcpy(record, i64 + 32, 32);
+      memcpy(seckey, key->seckey, 32);
+      // Zero key is rejected by secp256k1_ext_pubkey_create_batch
+      valid[j] = secp256k1_ec_privkey_tweak_add(ctx, seckey, i64);
+      if (!valid[j]) {
+        memset(seckey, 0, 32);
+      }
+    }
+
+    if (outputlen == 64) {
+      for (j = 0; j < len; ++j) {
+        memcpy(output + (i + j) * 64 + 32, seckeys + j * 32, 32);
+      }
+    } else {
+      secp256k1_ext_pubkey_create_batch(ctx, pubkeys, 33, valid, seckeys, len);
+      for (j = 0; j < len; ++j) {
+        memcpy(output + (i + j) * 65 + 32, pubkeys + j * 33, 33);
+      }
+    }
+
+    for (j = 0; j < len; ++j) {
+      statuses[i + j] = valid[j] ? 0 : 1;
+    }
+  }
+
+  memset(&base, 0, sizeof(base));
+  memset(hardened, 0, sizeof(hardened));
+  memset(i64, 0, sizeof(i64));
+  memset(seckeys, 0, sizeof(seckeys));
+  return ret;
+}
+
+// Public parent: tweaks of group added to parent key with
+// secp256k1_ext_pubkey_tweak_add_batch
+static int derive_range_pub(const secp256k1_context* ctx,
+                            unsigned char* output,
+                            unsigned char* statuses,
+                            const bip32_key* key,
+                            uint32_t index,
+                            size_t n,
+                            size_t outputlen) {
+  fcrypto_hmac_sha512 base;
+  unsigned char parent[33];
+  unsigned char i64[64];
+  unsigned char tweaks[BIP32_BATCH * 32];
+  unsigned char pubkeys[BIP32_BATCH * 33];
+  unsigned char valid[BIP32_BATCH];
+  size_t i, j, len;
+  int ret = 0;
+
+  fcrypto_hmac_sha512_init(&base, key->chain, 32);
+  if (!ser33(ctx, parent, &key->pubkey)) {
+    ret = 1;
+  }
+
+  for (i = 0; ret == 0 && i < n; i += len) {
+    len = n - i < BIP32_BATCH ? n - i : BIP32_BATCH;
+
+    for (j = 0; j < len; ++j) {
+      uint32_t child = (uint32_t)(index + i + j);
+      if (child >= FCRYPTO_BIP32_HARDENED || outputlen == 64) {
+        // Overflowed tweak, result is not used
+        memset(tweaks + j * 32, 0xff, 32);
+        continue;
+      }
+
+      ckd_hmac(i64, &base, parent, child);
+      memcpy(output + (i + j) * outputlen, i64 + 32, 32);
+      memcpy(tweaks + j * 32, i64, 32);
+    }
+
+    secp256k1_ext_pubkey_tweak_add_batch(
+        ctx, pubkeys, 33, valid, &key->pubkey, tweaks, len);
+
+    for (j = 0; j < len; ++j) {
+      uint32_t child = (uint32_t)(index + i + j);
+      unsigned char* record = output + (i + j) * outputlen;
+      if (child >= FCRYPTO_BIP32_HARDENED || outputlen == 64) {
+        statuses[i + j] = 2;
+      } else if (!valid[j]) {
+        statuses[i + j] = 1;
+      } else {
+        statuses[i + j] = 0;
+        memcpy(record + 32, pubkeys + j * 33, 33);
+      }
+    }
+  }
+
+  memset(&base, 0, sizeof(base));
+  memset(i64, 0, sizeof(i64));
+  memset(tweaks, 0, sizeof(tweaks));
+  return ret;
+}
+
+int fcrypto_bip32_derive_range(const secp256k1_context* ctx,
+                               unsigned char* output,
+                               unsigned char* statuses,
+                               const unsigned char* xkey,
+                               size_t xkeylen,
+                               uint32_t index,
+                               size_t n,
+                               size_t outputlen) {
+  bip32_key key;
+  int ret = 0;
+
+  if (!key_load(ctx, &key, xkey, xkeylen)) {
+    memset(&key, 0, sizeof(key));
+    return 2;
+  }
+
+  if (key.priv) {
+    ret = derive_range_priv(ctx, output, statuses, &key, index, n, outputlen);
+  } else {
+    ret = derive_range_pub(ctx, output, statuses, &key, index, n, outputlen);
+  }
+  memset(&key, 0, sizeof(key));
+  if (ret != 0) {
+    return 2;
+  }
+
+  // Records of failed children are zeroed
+  for (size_t i = 0; i < n; ++i) {
+    if (statuses[i] != 0) {
+      memset(output + i * outputlen, 0, outputlen);
+      ret = 1;
+    }
+  }
+  return ret;
+}
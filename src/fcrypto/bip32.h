@@ -0,0 +1,69 @@
+#ifndef FCRYPTO_BIP32
+#define FCRYPTO_BIP32
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <secp256k1/include/secp256k1.h>
+#include <stdint.h>
+
+// Hierarchical deterministic keys (BIP32).
+// Extended key: chain code (32 bytes) || key, where key is secret key (32
+// bytes, xkeylen 64) or compressed public key (33 bytes, xkeylen 65). Version,
+// depth, parent fingerprint and child number of serialization format are not
+// used for derivation, so they are not part of extended key here.
+// Indices >= FCRYPTO_BIP32_HARDENED are hardened.
+#define FCRYPTO_BIP32_HARDENED 0x80000000u
+
+/** Compute master extended private key (64 bytes) from seed.
+ *  Returns: 0: master key successfully created
+ *           1: master key is invalid (try other seed)
+ */
+int fcrypto_bip32_from_seed(const secp256k1_context* ctx,
+                            unsigned char* output,
+                            const unsigned char* seed,
+                            size_t seedlen);
+
+/** Derive extended key (outputlen 64 for private, 65 for public) by path of
+ *  pathlen indices. Between levels public key kept parsed, serialized only
+ *  for HMAC input.
+ *  Returns: 0: extended key successfully derived
+ *           1: extended key is invalid
+ *           2: private key required (hardened index or private output, but
+ * extended key is public)
+ *           3: derived key on some level is invalid (next index should be
+ * used)
+ */
+int fcrypto_bip32_derive(const secp256k1_context* ctx,
+                         unsigned char* output,
+                         size_t outputlen,
+                         const unsigned char* xkey,
+                         size_t xkeylen,
+                         const uint32_t* path,
+                         size_t pathlen);
+
+/** Derive children with indices index, index + 1, ..., index + n - 1
+ *  (modulo 2^32), each outputlen bytes (64 for private, 65 for public).
+ *  HMAC key and serialized parent computed once, public keys computed in
+ *  groups with one field inversion, see secp256k1_ext_pubkey_create_batch
+ *  and secp256k1_ext_pubkey_tweak_add_batch.
+ *  Statuses: 0 derived, 1 child is invalid, 2 private key required
+ *  Returns: 0: all children successfully derived
+ *           1: at least one child was not derived (see statuses)
+ *           2: extended key is invalid
+ */
+int fcrypto_bip32_derive_range(const secp256k1_context* ctx,
+                               unsigned char* output,
+                               unsigned char* statuses,
+                               const unsigned char* xkey,
+                               size_t xkeylen,
+                               uint32_t index,
+                               size_t n,
+                               size_t outputlen);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // FCRYPTO_BIP32
@@ -0,0 +1,94 @@
+// Generator of verification tables (pre_g and pre_g_128 of ecmult context)
+// as C source, which linked as read-only data with
+// FCRYPTO_ECMULT_STATIC_PRECOMPUTATION (see secp256k1_ext_context_create).
+// Signing table generated by gen_context.c from libsecp256k1 itself.
+// Built and run on host by Makefile (see `secp256k1_static_tables`), must be
+// compiled with same ECMULT_WINDOW_SIZE and USE_ENDOMORPHISM as target.
+// Points printed as big-endian words, so output does not depend from field
+// implementation and endianness of host.
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <secp256k1/src/secp256k1.c>
+
+void secp256k1_default_illegal_callback_fn(const char* str, void* data) {
+  (void)data;
+  fprintf(stderr, "[libsecp256k1] illegal argument: %s\n", str);
+  abort();
+}
+
+void secp256k1_default_error_callback_fn(const char* str, void* data) {
+  (void)data;
+  fprintf(stderr, "[libsecp256k1] internal consistency check failed: %s\n",
+          str);
+  abort();
+}
+
+static void print_table(FILE* fp,
+                        const char* name,
+                        const secp256k1_ge_storage* table) {
+  fprintf(fp, "static const secp256k1_ge_storage %s[%d] = {\n", name,
+          ECMULT_TABLE_SIZE(WINDOW_G));
+  for (int i = 0; i < ECMULT_TABLE_SIZE(WINDOW_G); ++i) {
+    secp256k1_ge ge;
+    secp256k1_ge_from_storage(&ge, &table[i]);
+
+    unsigned char b[64];
+    secp256k1_fe_normalize_var(&ge.x);
+    secp256k1_fe_normalize_var(&ge.y);
+    secp256k1_fe_get_b32(b, &ge.x);
+    secp256k1_fe_get_b32(b + 32, &ge.y);
+
+    fprintf(fp, "    SC(");
+    for (int j = 0; j < 16; ++j) {
+      unsigned long word = (unsigned long)b[j * 4] << 24 |
+                           (unsigned long)b[j * 4 + 1] << 16 |
+                           (unsigned long)b[j * 4 + 2] << 8 |
+                           (unsigned long)b[j * 4 + 3];
+      fprintf(fp, "%s0x%08lxUL", j == 0 ? "" : ", ", word);
+    }
+    fprintf(fp, "),\n");
+  }
+  fprintf(fp, "};\n");
+}
+
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    fprintf(stderr, "Usage: %s <output.h>\n", argv[0]);
+    return 1;
+  }
+
+  secp256k1_context* ctx = secp256k1_context_create(SECP256K1_CONTEXT_VERIFY);
+  if (ctx == NULL) {
+    fprintf(stderr, "Can not create context\n");
+    return 1;
+  }
+
+  FILE* fp = fopen(argv[1], "w");
+  if (fp == NULL) {
+    fprintf(stderr, "Can not open %s for writing\n", argv[1]);
+    return 1;
+  }
+
+  fprintf(fp, "// Generated by src/fcrypto/gen_ecmult_static.c, do not edit\n");
+  fprintf(fp, "#ifndef FCRYPTO_ECMULT_STATIC_PRE_G\n");
+  fprintf(fp, "#define FCRYPTO_ECMULT_STATIC_PRE_G\n\n");
+  fprintf(fp, "#if ECMULT_WINDOW_SIZE != %d\n", ECMULT_WINDOW_SIZE);
+  fprintf(fp, "#error \"Tables generated for other ECMULT_WINDOW_SIZE\"\n");
+  fprintf(fp, "#endif\n\n");
+  fprintf(fp, "#define SC SECP256K1_GE_STORAGE_CONST\n");
+  print_table(fp, "secp256k1_ext_static_pre_g", *ctx->ecmult_ctx.pre_g);
+#ifdef USE_ENDOMORPHISM
+  fprintf(fp, "#ifndef USE_ENDOMORPHISM\n");
+  fprintf(fp, "#error \"Tables generated with USE_ENDOMORPHISM\"\n");
+  fprintf(fp, "#endif\n");
+  print_table(
+      fp, "secp256k1_ext_static_pre_g_128", *ctx->ecmult_ctx.pre_g_128);
+#endif
+  fprintf(fp, "#undef SC\n\n");
+  fprintf(fp, "#endif  // FCRYPTO_ECMULT_STATIC_PRE_G\n");
+
+  fclose(fp);
+  secp256k1_context_destroy(ctx);
+  return 0;
+}
@@ -0,0 +1,576 @@
+#include <fcrypto/hash.h>
+
+#include <string.h>
+
+// SHA-256 (FIPS 180-4)
+static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+#define ROTR32(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+#define ROTL32(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+static uint32_t read_be32(const unsigned char* p) {
+  return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 |
+         (uint32_t)p[3];
+}
+
+static void write_be32(unsigned char* p, uint32_t x) {
+  p[0] = (unsigned char)(x >> 24);
+  p[1] = (unsigned char)(x >> 16);
+  p[2] = (unsigned char)(x >> 8);
+  p[3] = (unsigned char)x;
+}
+
+static uint32_t read_le32(const unsigned char* p) {
+  return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 |
+         (uint32_t)p[3] << 24;
+}
+
+static void write_le32(unsigned char* p, uint32_t x) {
+  p[0] = (unsigned char)x;
+  p[1] = (unsigned char)(x >> 8);
+  p[2] = (unsigned char)(x >> 16);
+  p[3] = (unsigned char)(x >> 24);
+}
+
+static void sha256_transform(uint32_t* s, const unsigned char* block) {
+  uint32_t w[64];
+  for (int i = 0; i < 16; ++i) {
+    w[i] = read_be32(block + i * 4);
+  }
+  for (int i = 16; i < 64; ++i) {
+    uint32_t s0 =
+        ROTR32(w[i - 15], 7) ^ ROTR32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+    uint32_t s1 =
+        ROTR32(w[i - 2], 17) ^ ROTR32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+
+  uint32_t a = s[0], b = s[1], c = s[2], d = s[3];
+  uint32_t e = s[4], f = s[5], g = s[6], h = s[7];
+  for (int i = 0; i < 64; ++i) {
+    uint32_t S1 = ROTR32(e, 6) ^ ROTR32(e, 11) ^ ROTR32(e, 25);
+    uint32_t ch = (e & f) ^ (~e & g);
+    uint32_t t1 = h + S1 + ch + sha256_k[i] + w[i];
+    uint32_t S0 = ROTR32(a, 2) ^ ROTR32(a, 13) ^ ROTR32(a, 22);
+    uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+    uint32_t t2 = S0 + maj;
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+
+  s[0] += a;
+  s[1] += b;
+  s[2] += c;
+  s[3] += d;
+  s[4] += e;
+  s[5] += f;
+  s[6] += g;
+  s[7] += h;
+}
+
+// Block buffering shared by SHA-256 and RIPEMD-160 (64-byte blocks)
+static void block64_update(uint32_t* s,
+                           unsigned char* buf,
+                           uint64_t* bytes,
+                           void (*transform)(uint32_t*, const unsigned char*),
+                           const unsigned char* data,
+                           size_t len) {
+  size_t bufsize = *bytes & 63;
+  *bytes += len;
+  while (len >= 64 - bufsize) {
+    size_t chunk = 64 - bufsize;
+    memcpy(buf + bufsize, data, chunk);
+    data += chunk;
+    len -= chunk;
+    transform(s, buf);
+    bufsize = 0;
+  }
+  if (len > 0) {
+    memcpy(buf + bufsize, data, len);
+  }
+}
+
+void fcrypto_sha256_init(fcrypto_sha256* hash) {
+  hash->s[0] = 0x6a09e667;
+  hash->s[1] = 0xbb67ae85;
+  hash->s[2] = 0x3c6ef372;
+  hash->s[3] = 0xa54ff53a;
+  hash->s[4] = 0x510e527f;
+  hash->s[5] = 0x9b05688c;
+  hash->s[6] = 0x1f83d9ab;
+  hash->s[7] = 0x5be0cd19;
+  hash->bytes = 0;
+}
+
+void fcrypto_sha256_update(fcrypto_sha256* hash,
+                           const unsigned char* data,
+                           size_t len) {
+  block64_update(
+      hash->s, hash->buf, &hash->bytes, sha256_transform, data, len);
+}
+
+void fcrypto_sha256_finalize(fcrypto_sha256* hash, unsigned char* out32) {
+  static const unsigned char pad[64] = {0x80};
+  unsigned char sizedesc[8];
+  write_be32(sizedesc, (uint32_t)(hash->bytes >> 29));
+  write_be32(sizedesc + 4, (uint32_t)(hash->bytes << 3));
+
+  size_t bufsize = hash->bytes & 63;
+  fcrypto_sha256_update(hash, pad, bufsize < 56 ? 56 - bufsize : 120 - bufsize);
+  fcrypto_sha256_update(hash, sizedesc, 8);
+  for (int i = 0; i < 8; ++i) {
+    write_be32(out32 + i * 4, hash->s[i]);
+  }
+}
+
+// SHA-512 (FIPS 180-4)
+static const uint64_t sha512_k[80] = {
+    0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL,
+    0xe9b5dba58189dbbcULL, 0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL,
+    0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL, 0xd807aa98a3030242ULL,
+    0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+    0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL,
+    0xc19bf174cf692694ULL, 0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL,
+    0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL, 0x2de92c6f592b0275ULL,
+    0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+    0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL,
+    0xbf597fc7beef0ee4ULL, 0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL,
+    0x06ca6351e003826fULL, 0x142929670a0e6e70ULL, 0x27b70a8546d22ffcULL,
+    0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+    0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL,
+    0x92722c851482353bULL, 0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL,
+    0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL, 0xd192e819d6ef5218ULL,
+    0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+    0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL,
+    0x34b0bcb5e19b48a8ULL, 0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL,
+    0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL, 0x748f82ee5defb2fcULL,
+    0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+    0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL,
+    0xc67178f2e372532bULL, 0xca273eceea26619cULL, 0xd186b8c721c0c207ULL,
+    0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL, 0x06f067aa72176fbaULL,
+    0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+    0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL,
+    0x431d67c49c100d4cULL, 0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL,
+    0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL,
+};
+
+#define ROTR64(x, n) (((x) >> (n)) | ((x) << (64 - (n))))
+
+static uint64_t read_be64(const unsigned char* p) {
+  return (uint64_t)p[0] << 56 | (uint64_t)p[1] << 48 | (uint64_t)p[2] << 40 |
+         (uint64_t)p[3] << 32 | (uint64_t)p[4] << 24 | (uint64_t)p[5] << 16 |
+         (uint64_t)p[6] << 8 | (uint64_t)p[7];
+}
+
+static void write_be64(unsigned char* p, uint64_t x) {
+  for (int i = 7; i >= 0; --i) {
+    p[i] = (unsigned char)x;
+    x >>= 8;
+  }
+}
+
+static void sha512_transform(uint64_t* s, const unsigned char* block) {
+  uint64_t w[80];
+  for (int i = 0; i < 16; ++i) {
+    w[i] = read_be64(block + i * 8);
+  }
+  for (int i = 16; i < 80; ++i) {
+    uint64_t s0 =
+        ROTR64(w[i - 15], 1) ^ ROTR64(w[i - 15], 8) ^ (w[i - 15] >> 7);
+    uint64_t s1 =
+        ROTR64(w[i - 2], 19) ^ ROTR64(w[i - 2], 61) ^ (w[i - 2] >> 6);
+    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+  }
+
+  uint64_t a = s[0], b = s[1], c = s[2], d = s[3];
+  uint64_t e = s[4], f = s[5], g = s[6], h = s[7];
+  for (int i = 0; i < 80; ++i) {
+    uint64_t S1 = ROTR64(e, 14) ^ ROTR64(e, 18) ^ ROTR64(e, 41);
+    uint64_t ch = (e & f) ^ (~e & g);
+    uint64_t t1 = h + S1 + ch + sha512_k[i] + w[i];
+    uint64_t S0 = ROTR64(a, 28) ^ ROTR64(a, 34) ^ ROTR64(a, 39);
+    uint64_t maj = (a & b) ^ (a & c) ^ (b & c);
+    uint64_t t2 = S0 + maj;
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+
+  s[0] += a;
+  s[1] += b;
+  s[2] += c;
+  s[3] += d;
+  s[4] += e;
+  s[5] += f;
+  s[6] += g;
+  s[7] += h;
+}
+
+void fcrypto_sha512_init(fcrypto_sha512* hash) {
+  hash->s[0] = 0x6a09e667f3bcc908ULL;
+  hash->s[1] = 0xbb67ae8584caa73bULL;
+  hash->s[2] = 0x3c6ef372fe94f82bULL;
+  hash->s[3] = 0xa54ff53a5f1d36f1ULL;
+  hash->s[4] = 0x510e527fade682d1ULL;
+  hash->s[5] = 0x9b05688c2b3e6c1fULL;
+  hash->s[6] = 0x1f83d9abfb41bd6bULL;
+  hash->s[7] = 0x5be0cd19137e2179ULL;
+  hash->bytes = 0;
+}
+
+void fcrypto_sha512_update(fcrypto_sha512* hash,
+                           const unsigned char* data,
+                           size_t len) {
+  size_t bufsize = hash->bytes & 127;
+  hash->bytes += len;
+  while (len >= 128 - bufsize) {
+    size_t chunk = 128 - bufsize;
+    memcpy(hash->buf + bufsize, data, chunk);
+    data += chunk;
+    len -= chunk;
+    sha512_transform(hash->s, hash->buf);
+    bufsize = 0;
+  }
+  if (len > 0) {
+    memcpy(hash->buf + bufsize, data, len);
+  }
+}
+
+void fcrypto_sha512_finalize(fcrypto_sha512* hash, unsigned char* out64) {
+  static const unsigned char pad[128] = {0x80};
+  unsigned char sizedesc[16] = {0};
+  write_be64(sizedesc + 8, hash->bytes << 3);
+
+  size_t bufsize = hash->bytes & 127;
+  fcrypto_sha512_update(
+      hash, pad, bufsize < 112 ? 112 - bufsize : 240 - bufsize);
+  fcrypto_sha512_update(hash, sizedesc, 16);
+  for (int i = 0; i < 8; ++i) {
+    write_be64(out64 + i * 8, hash->s[i]);
+  }
+}
+
+// HMAC-SHA512 (RFC 2104)
+void fcrypto_hmac_sha512_init(fcrypto_hmac_sha512* hmac,
+                              const unsigned char* key,
+                              size_t keylen) {
+  unsigned char rkey[128] = {0};
+  if (keylen <= sizeof(rkey)) {
+    memcpy(rkey, key, keylen);
+  } else {
+    fcrypto_sha512 hash;
+    fcrypto_sha512_init(&hash);
+    fcrypto_sha512_update(&hash, key, keylen);
+    fcrypto_sha512_finalize(&hash, rkey);
+  }
+
+  for (int i = 0; i < 128; ++i) {
+    rkey[i] ^= 0x5c;
+  }
+  fcrypto_sha512_init(&hmac->outer);
+  fcrypto_sha512_update(&hmac->outer, rkey, 128);
+
+  for (int i = 0; i < 128; ++i) {
+    rkey[i] ^= 0x5c ^ 0x36;
+  }
+  fcrypto_sha512_init(&hmac->inner);
+  fcrypto_sha512_update(&hmac->inner, rkey, 128);
+
+  memset(rkey, 0, sizeof(rkey));
+}
+
+void fcrypto_hmac_sha512_update(fcrypto_hmac_sha512* hmac,
+                                const unsigned char* data,
+                                size_t len) {
+  fcrypto_sha512_update(&hmac->inner, data, len);
+}
+
+void fcrypto_hmac_sha512_finalize(fcrypto_hmac_sha512* hmac,
+                                  unsigned char* out64) {
+  unsigned char temp[64];
+  fcrypto_sha512_finalize(&hmac->inner, temp);
+  fcrypto_sha512_update(&hmac->outer, temp, 64);
+  fcrypto_sha512_finalize(&hmac->outer, out64);
+  memset(temp, 0, sizeof(temp));
+}
+
+// RIPEMD-160
+static const unsigned char ripemd160_rl[80] = {
+    0, 1, 2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14, 15,
+    7, 4, 13, 1,  10, 6,  15, 3,  12, 0,  9,  5,  2,  14, 11, 8,
+    3, 10, 14, 4, 9,  15, 8,  1,  2,  7,  0,  6,  13, 11, 5,  12,
+    1, 9, 11, 10, 0,  8,  12, 4,  13, 3,  7,  15, 14, 5,  6,  2,
+    4, 0, 5,  9,  7,  12, 2,  10, 14, 1,  3,  8,  11, 6,  15, 13,
+};
+static const unsigned char ripemd160_rr[80] = {
+    5,  14, 7,  0, 9, 2,  11, 4,  13, 6,  15, 8,  1,  10, 3,  12,
+    6,  11, 3,  7, 0, 13, 5,  10, 14, 15, 8,  12, 4,  9,  1,  2,
+    15, 5,  1,  3, 7, 14, 6,  9,  11, 8,  12, 2,  10, 0,  4,  13,
+    8,  6,  4,  1, 3, 11, 15, 0,  5,  12, 2,  13, 9,  7,  10, 14,
+    12, 15, 10, 4, 1, 5,  8,  7,  6,  2,  13, 14, 0,  3,  9,  11,
+};
+static const unsigned char ripemd160_sl[80] = {
+    11, 14, 15, 12, 5,  8,  7,  9,  11, 13, 14, 15, 6,  7,  9,  8,
+    7,  6,  8,  13, 11, 9,  7,  15, 7,  12, 15, 9,  11, 7,  13, 12,
+    11, 13, 6,  7,  14, 9,  13, 15, 14, 8,  13, 6,  5,  12, 7,  5,
+    11, 12, 14, 15, 14, 15, 9,  8,  9,  14, 5,  6,  8,  6,  5,  12,
+    9,  15, 5,  11, 6,  8,  13, 12, 5,  12, 13, 14, 11, 8,  5,  6,
+};
+static const unsigned char ripemd160_sr[80] = {
+    8,  9,  9,  11, 13, 15, 15, 5,  7,  7,  8,  11, 14, 14, 12, 6,
+    9,  13, 15, 7,  12, 8,  9,  11, 7,  7,  12, 7,  6,  15, 13, 11,
+    9,  7,  15, 11, 8,  6,  6,  14, 12, 13, 5,  14, 13, 13, 7,  5,
+    15, 5,  8,  11, 14, 14, 6,  14, 6,  9,  12, 9,  12, 5,  15, 8,
+    8,  5,  12, 9,  12, 5,  14, 6,  8,  13, 6,  5,  15, 13, 11, 11,
+};
+static const uint32_t ripemd160_kl[5] = {
+    0x00000000, 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xa953fd4e};
+static const uint32_t ripemd160_kr[5] = {
+    0x50a28be6, 0x5c4dd124, 0x6d703ef3, 0x7a6d76e9, 0x00000000};
+
+static uint32_t ripemd160_f(int j, uint32_t x, uint32_t y, uint32_t z) {
+  switch (j / 16) {
+    case 0:
+      return x ^ y ^ z;
+    case 1:
+      return (x & y) | (~x & z);
+    case 2:
+      return (x | ~y) ^ z;
+    case 3:
+      return (x & z) | (y & ~z);
+    default:
+      return x ^ (y | ~z);
+  }
+}
+
+static void ripemd160_transform(uint32_t* s, const unsigned char* block) {
+  uint32_t x[16];
+  for (int i = 0; i < 16; ++i) {
+    x[i] = read_le32(block + i * 4);
+  }
+
+  uint32_t al = s[0], bl = s[1], cl = s[2], dl = s[3], el = s[4];
+  uint32_t ar = s[0], br = s[1], cr = s[2], dr = s[3], er = s[4];
+  for (int j = 0; j < 80; ++j) {
+    uint32_t t = al + ripemd160_f(j, bl, cl, dl) + x[ripemd160_rl[j]] +
+                 ripemd160_kl[j / 16];
+    t = ROTL32(t, ripemd160_sl[j]) + el;
+    al = el;
+    el = dl;
+    dl = ROTL32(cl, 10);
+    cl = bl;
+    bl = t;
+
+    t = ar + ripemd160_f(79 - j, br, cr, dr) + x[ripemd160_rr[j]] +
+        ripemd160_kr[j / 16];
+    t = ROTL32(t, ripemd160_sr[j]) + er;
+    ar = er;
+    er = dr;
+    dr = ROTL32(cr, 10);
+    cr = br;
+    br = t;
+  }
+
+  uint32_t t = s[1] + cl + dr;
+  s[1] = s[2] + dl + er;
+  s[2] = s[3] + el + ar;
+  s[3] = s[4] + al + br;
+  s[4] = s[0] + bl + cr;
+  s[0] = t;
+}
+
+void fcrypto_ripemd160_init(fcrypto_ripemd160* hash) {
+  hash->s[0] = 0x67452301;
+  hash->s[1] = 0xefcdab89;
+  hash->s[2] = 0x98badcfe;
+  hash->s[3] = 0x10325476;
+  hash->s[4] = 0xc3d2e1f0;
+  hash->bytes = 0;
+}
+
+void fcrypto_ripemd160_update(fcrypto_ripemd160* hash,
+                              const unsigned char* data,
+                              size_t len) {
+  block64_update(
+      hash->s, hash->buf, &hash->bytes, ripemd160_transform, data, len);
+}
+
+void fcrypto_ripemd160_finalize(fcrypto_ripemd160* hash,
+                                unsigned char* out20) {
+  static const unsigned char pad[64] = {0x80};
+  unsigned char sizedesc[8];
+  write_le32(sizedesc, (uint32_t)(hash->bytes << 3));
+  write_le32(sizedesc + 4, (uint32_t)(hash->bytes >> 29));
+
+  size_t bufsize = hash->bytes & 63;
+  fcrypto_ripemd160_update(
+      hash, pad, bufsize < 56 ? 56 - bufsize : 120 - bufsize);
+  fcrypto_ripemd160_update(hash, sizedesc, 8);
+  for (int i = 0; i < 5; ++i) {
+    write_le32(out20 + i * 4, hash->s[i]);
+  }
+}
+
+// Keccak-256: Keccak-f[1600] with rate 136 bytes, padding 0x01 ... 0x80
+#define KECCAK256_RATE 136
+#define ROTL64(x, n) (((x) << (n)) | ((x) >> (64 - (n))))
+
+static const uint64_t keccak_rc[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
+    0x8000000080008000ULL, 0x000000000000808bULL, 0x0000000080000001ULL,
+    0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL,
+    0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
+    0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+    0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
+    0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL,
+};
+
+static const unsigned char keccak_rotc[24] = {
+    1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14,
+    27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44,
+};
+
+static const unsigned char keccak_piln[24] = {
+    10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4,
+    15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1,
+};
+
+static void keccakf(uint64_t* st) {
+  uint64_t bc[5];
+  for (int round = 0; round < 24; ++round) {
+    // Theta
+    for (int i = 0; i < 5; ++i) {
+      bc[i] = st[i] ^ st[i + 5] ^ st[i + 10] ^ st[i + 15] ^ st[i + 20];
+    }
+    for (int i = 0; i < 5; ++i) {
+      uint64_t t = bc[(i + 4) % 5] ^ ROTL64(bc[(i + 1) % 5], 1);
+      for (int j = 0; j < 25; j += 5) {
+        st[j + i] ^= t;
+      }
+    }
+
+    // Rho and Pi
+    uint64_t t = st[1];
+    for (int i = 0; i < 24; ++i) {
+      int j = keccak_piln[i];
+      uint64_t tmp = st[j];
+      st[j] = ROTL64(t, keccak_rotc[i]);
+      t = tmp;
+    }
+
+    // Chi
+    for (int j = 0; j < 25; j += 5) {
+      for (int i = 0; i < 5; ++i) {
+        bc[i] = st[j + i];
+      }
+      for (int i = 0; i < 5; ++i) {
+        st[j + i] ^= (~bc[(i + 1) % 5]) & bc[(i + 2) % 5];
+      }
+    }
+
+    // Iota
+    st[0] ^= keccak_rc[round];
+  }
+}
+
+// State is array of little-endian lanes, bytes absorbed one by one into lane
+static void keccak_absorb_byte(fcrypto_keccak256* hash, unsigned char byte) {
+  hash->s[hash->pos / 8] ^= (uint64_t)byte << (8 * (hash->pos % 8));
+  if (++hash->pos == KECCAK256_RATE) {
+    keccakf(hash->s);
+    hash->pos = 0;
+  }
+}
+
+void fcrypto_keccak256_init(fcrypto_keccak256* hash) {
+  memset(hash->s, 0, sizeof(hash->s));
+  hash->pos = 0;
+}
+
+void fcrypto_keccak256_update(fcrypto_keccak256* hash,
+                              const unsigned char* data,
+                              size_t len) {
+  // Unaligned head byte by byte, then whole lanes
+  while (len > 0 && hash->pos % 8 != 0) {
+    keccak_absorb_byte(hash, *data++);
+    --len;
+  }
+  while (len >= 8) {
+    uint64_t lane = (uint64_t)read_le32(data) |
+                    (uint64_t)read_le32(data + 4) << 32;
+    hash->s[hash->pos / 8] ^= lane;
+    hash->pos += 8;
+    if (hash->pos == KECCAK256_RATE) {
+      keccakf(hash->s);
+      hash->pos = 0;
+    }
+    data += 8;
+    len -= 8;
+  }
+  while (len > 0) {
+    keccak_absorb_byte(hash, *data++);
+    --len;
+  }
+}
+
+void fcrypto_keccak256_finalize(fcrypto_keccak256* hash,
+                                unsigned char* out32) {
+  hash->s[hash->pos / 8] ^= (uint64_t)0x01 << (8 * (hash->pos % 8));
+  hash->s[(KECCAK256_RATE - 1) / 8] ^= (uint64_t)0x80
+                                       << (8 * ((KECCAK256_RATE - 1) % 8));
+  keccakf(hash->s);
+  for (int i = 0; i < 4; ++i) {
+    write_le32(out32 + i * 8, (uint32_t)hash->s[i]);
+    write_le32(out32 + i * 8 + 4, (uint32_t)(hash->s[i] >> 32));
+  }
+}
+
+// One-shot helpers
+void fcrypto_hash160(unsigned char* out20,
+                     const unsigned char* data,
+                     size_t len) {
+  fcrypto_sha256 sha256;
+  fcrypto_ripemd160 ripemd160;
+  unsigned char temp[32];
+
+  fcrypto_sha256_init(&sha256);
+  fcrypto_sha256_update(&sha256, data, len);
+  fcrypto_sha256_finalize(&sha256, temp);
+
+  fcrypto_ripemd160_init(&ripemd160);
+  fcrypto_ripemd160_update(&ripemd160, temp, 32);
+  fcrypto_ripemd160_finalize(&ripemd160, out20);
+}
+
+void fcrypto_keccak256_hash(unsigned char* out32,
+                            const unsigned char* data,
+                            size_t len) {
+  fcrypto_keccak256 hash;
+  fcrypto_keccak256_init(&hash);
+  fcrypto_keccak256_update(&hash, data, len);
+  fcrypto_keccak256_finalize(&hash, out32);
+}
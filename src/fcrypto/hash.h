@@ -0,0 +1,92 @@
+#ifndef FCRYPTO_HASH
+#define FCRYPTO_HASH
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Hash functions for code outside of libsecp256k1 (its SHA-256 is internal
+// and not exported). Streaming interface: init, update any number of times,
+// finalize. State can be copied, so HMAC with same key can be initialized
+// once and reused for many messages.
+
+typedef struct {
+  uint32_t s[8];
+  unsigned char buf[64];
+  uint64_t bytes;
+} fcrypto_sha256;
+
+void fcrypto_sha256_init(fcrypto_sha256* hash);
+void fcrypto_sha256_update(fcrypto_sha256* hash,
+                           const unsigned char* data,
+                           size_t len);
+void fcrypto_sha256_finalize(fcrypto_sha256* hash, unsigned char* out32);
+
+typedef struct {
+  uint64_t s[8];
+  unsigned char buf[128];
+  uint64_t bytes;
+} fcrypto_sha512;
+
+void fcrypto_sha512_init(fcrypto_sha512* hash);
+void fcrypto_sha512_update(fcrypto_sha512* hash,
+                           const unsigned char* data,
+                           size_t len);
+void fcrypto_sha512_finalize(fcrypto_sha512* hash, unsigned char* out64);
+
+typedef struct {
+  fcrypto_sha512 inner;
+  fcrypto_sha512 outer;
+} fcrypto_hmac_sha512;
+
+void fcrypto_hmac_sha512_init(fcrypto_hmac_sha512* hmac,
+                              const unsigned char* key,
+                              size_t keylen);
+void fcrypto_hmac_sha512_update(fcrypto_hmac_sha512* hmac,
+                                const unsigned char* data,
+                                size_t len);
+void fcrypto_hmac_sha512_finalize(fcrypto_hmac_sha512* hmac,
+                                  unsigned char* out64);
+
+typedef struct {
+  uint32_t s[5];
+  unsigned char buf[64];
+  uint64_t bytes;
+} fcrypto_ripemd160;
+
+void fcrypto_ripemd160_init(fcrypto_ripemd160* hash);
+void fcrypto_ripemd160_update(fcrypto_ripemd160* hash,
+                              const unsigned char* data,
+                              size_t len);
+void fcrypto_ripemd160_finalize(fcrypto_ripemd160* hash,
+                                unsigned char* out20);
+
+// Keccak-256 as used by Ethereum (original padding, not SHA3-256)
+typedef struct {
+  uint64_t s[25];
+  size_t pos;
+} fcrypto_keccak256;
+
+void fcrypto_keccak256_init(fcrypto_keccak256* hash);
+void fcrypto_keccak256_update(fcrypto_keccak256* hash,
+                              const unsigned char* data,
+                              size_t len);
+void fcrypto_keccak256_finalize(fcrypto_keccak256* hash,
+                                unsigned char* out32);
+
+// One-shot helpers: RIPEMD160(SHA256(data)) and Keccak-256
+void fcrypto_hash160(unsigned char* out20,
+                     const unsigned char* data,
+                     size_t len);
+void fcrypto_keccak256_hash(unsigned char* out32,
+                            const unsigned char* data,
+                            size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // FCRYPTO_HASH
@@ -1,10 +1,13 @@
+#include <fcrypto/hash.h>
 #include <fcrypto/secp256k1.h>
+#include <fcrypto/secp256k1_ext.h>
 #include <secp256k1/include/secp256k1_ecdh.h>
 #include <secp256k1/include/secp256k1_preallocated.h>
 #include <secp256k1/include/secp256k1_recovery.h>
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 // TODO: allow set callbacks from JS code?
 // We define USE_EXTERNAL_DEFAULT_CALLBACKS only for WASM, see binding.gyp
@@ -40,21 +43,58 @@ void secp256k1_default_error_callback_fn(const char* str, void* data) {
                    retcode);                                                   \
   } while (0)
 
+// Parsed public key (see fcrypto_secp256k1_pubkey_parse) passed with length
+// of secp256k1_pubkey, serialized keys have length 33 or 65
+static int pubkey_load(const secp256k1_context* ctx,
+                       secp256k1_pubkey* pubkey,
+                       const unsigned char* input,
+                       size_t inputlen) {
+  if (inputlen == sizeof(secp256k1_pubkey)) {
+    memcpy(pubkey->data, input, inputlen);
+    return 1;
+  }
+
+  return secp256k1_ec_pubkey_parse(ctx, pubkey, input, inputlen);
+}
+
 // Context
 size_t fcrypto_secp256k1_context_size() {
-  return secp256k1_context_preallocated_size(SECP256K1_CONTEXT_SIGN |
-                                             SECP256K1_CONTEXT_VERIFY);
+  return secp256k1_ext_context_size();
+}
+
+int fcrypto_secp256k1_ecmult_gen_prec_bits() {
+  return secp256k1_ext_ecmult_gen_prec_bits();
+}
+
+int fcrypto_secp256k1_ecmult_window_size() {
+  return secp256k1_ext_ecmult_window_size();
+}
+
+int fcrypto_secp256k1_static_tables() {
+  return secp256k1_ext_static_tables();
 }
 
 secp256k1_context* fcrypto_secp256k1_context_create() {
-  return secp256k1_context_create(SECP256K1_CONTEXT_SIGN |
-                                  SECP256K1_CONTEXT_VERIFY);
+  return secp256k1_ext_context_create();
 };
 
 void fcrypto_secp256k1_context_destroy(secp256k1_context* ctx) {
   return secp256k1_context_destroy(ctx);
 };
 
+size_t fcrypto_secp256k1_context_clone_size() {
+  return secp256k1_ext_context_shallow_size();
+}
+
+secp256k1_context* fcrypto_secp256k1_context_clone(
+    const secp256k1_context* ctx) {
+  return secp256k1_ext_context_shallow_clone(ctx);
+}
+
+void fcrypto_secp256k1_context_clone_destroy(secp256k1_context* ctx) {
+  secp256k1_ext_context_shallow_destroy(ctx);
+}
+
 int fcrypto_secp256k1_context_randomize(secp256k1_context* ctx,
                                         const unsigned char* seed32) {
   RETURN_INVERTED(secp256k1_context_randomize(ctx, seed32));
@@ -95,13 +135,23 @@ int fcrypto_secp256k1_pubkey_create(const secp256k1_context* ctx,
   return 0;
 }
 
+int fcrypto_secp256k1_pubkey_parse(const secp256k1_context* ctx,
+                                   unsigned char* output,
+                                   const unsigned char* input,
+                                   size_t inputlen) {
+  secp256k1_pubkey pubkey;
+  RETURN_IF_ZERO(secp256k1_ec_pubkey_parse(ctx, &pubkey, input, inputlen), 1);
+  memcpy(output, pubkey.data, sizeof(pubkey.data));
+  return 0;
+}
+
 int fcrypto_secp256k1_pubkey_convert(const secp256k1_context* ctx,
                                      unsigned char* output,
                                      const unsigned char* input,
                                      size_t inputlen,
                                      size_t outputlen) {
   secp256k1_pubkey pubkey;
-  RETURN_IF_ZERO(secp256k1_ec_pubkey_parse(ctx, &pubkey, input, inputlen), 1);
+  RETURN_IF_ZERO(pubkey_load(ctx, &pubkey, input, inputlen), 1);
   PUBKEY_SERIALIZE(2);
   return 0;
 }
@@ -112,53 +162,68 @@ int fcrypto_secp256k1_pubkey_negate(const secp256k1_context* ctx,
                                     size_t inputlen,
                                     size_t outputlen) {
   secp256k1_pubkey pubkey;
-  RETURN_IF_ZERO(secp256k1_ec_pubkey_parse(ctx, &pubkey, input, inputlen), 1);
+  RETURN_IF_ZERO(pubkey_load(ctx, &pubkey, input, inputlen), 1);
   RETURN_IF_ZERO(secp256k1_ec_pubkey_negate(ctx, &pubkey), 2);
   PUBKEY_SERIALIZE(3);
   return 0;
 }
 
-// We can not use unique_ptr in C, so no macroses here ¯\_(ツ)_/¯
+// Memory released by caller with fcrypto_arena_reset
 int fcrypto_secp256k1_pubkey_combine(const secp256k1_context* ctx,
+                                     fcrypto_arena* arena,
                                      unsigned char* output,
                                      const unsigned char* const* inputs,
                                      const size_t* inputslen,
                                      size_t n,
                                      size_t outputlen) {
-  int ret = 0;
-
-  secp256k1_pubkey* pubkeys = calloc(n, sizeof(secp256k1_pubkey));
-  const secp256k1_pubkey** ins = calloc(n, sizeof(secp256k1_pubkey*));
+  secp256k1_pubkey* pubkeys =
+      fcrypto_arena_alloc(arena, n * sizeof(secp256k1_pubkey));
+  const secp256k1_pubkey** ins =
+      fcrypto_arena_alloc(arena, n * sizeof(secp256k1_pubkey*));
+  if (pubkeys == NULL || ins == NULL) {
+    return 4;
+  }
 
   for (unsigned int i = 0; i < n; ++i) {
-    if (secp256k1_ec_pubkey_parse(ctx, &pubkeys[i], inputs[i], inputslen[i]) ==
-        0) {
-      ret = 1;
-      goto cleanup;
-    }
-
+    RETURN_IF_ZERO(pubkey_load(ctx, &pubkeys[i], inputs[i], inputslen[i]), 1);
     ins[i] = &pubkeys[i];
   }
 
   secp256k1_pubkey pubkey;
-  if (secp256k1_ec_pubkey_combine(ctx, &pubkey, ins, n) == 0) {
-    ret = 2;
-    goto cleanup;
+  RETURN_IF_ZERO(secp256k1_ec_pubkey_combine(ctx, &pubkey, ins, n), 2);
+
+  PUBKEY_SERIALIZE(3);
+  return 0;
+}
+
+// Memory released by caller with fcrypto_arena_reset
+int fcrypto_secp256k1_pubkey_linear_combination(
+    const secp256k1_context* ctx,
+    fcrypto_arena* arena,
+    unsigned char* output,
+    const unsigned char* const* inputs,
+    const size_t* inputslen,
+    const unsigned char* scalars,
+    const unsigned char* gscalar,
+    size_t n,
+    size_t outputlen) {
+  secp256k1_pubkey* pubkeys =
+      fcrypto_arena_alloc(arena, n * sizeof(secp256k1_pubkey));
+  if (pubkeys == NULL) {
+    return 4;
   }
 
-  int flags =
-      outputlen == 33 ? SECP256K1_EC_COMPRESSED : SECP256K1_EC_UNCOMPRESSED;
-  if (secp256k1_ec_pubkey_serialize(ctx, output, &outputlen, &pubkey, flags) ==
-      0) {
-    ret = 3;
-    goto cleanup;
+  for (unsigned int i = 0; i < n; ++i) {
+    RETURN_IF_ZERO(pubkey_load(ctx, &pubkeys[i], inputs[i], inputslen[i]), 1);
   }
 
-cleanup:
-  free((void*)ins);
-  free((void*)pubkeys);
+  secp256k1_pubkey pubkey;
+  RETURN_IF_ZERO(secp256k1_ext_pubkey_linear_combination(
+                     ctx, arena, &pubkey, pubkeys, scalars, gscalar, n),
+                 2);
 
-  return ret;
+  PUBKEY_SERIALIZE(3);
+  return 0;
 }
 
 int fcrypto_secp256k1_pubkey_tweak_add(const secp256k1_context* ctx,
@@ -168,7 +233,7 @@ int fcrypto_secp256k1_pubkey_tweak_add(const secp256k1_context* ctx,
                                        const unsigned char* tweak,
                                        size_t outputlen) {
   secp256k1_pubkey pubkey;
-  RETURN_IF_ZERO(secp256k1_ec_pubkey_parse(ctx, &pubkey, input, inputlen), 1);
+  RETURN_IF_ZERO(pubkey_load(ctx, &pubkey, input, inputlen), 1);
   RETURN_IF_ZERO(secp256k1_ec_pubkey_tweak_add(ctx, &pubkey, tweak), 2);
   PUBKEY_SERIALIZE(3);
   return 0;
@@ -181,7 +246,7 @@ int fcrypto_secp256k1_pubkey_tweak_mul(const secp256k1_context* ctx,
                                        const unsigned char* tweak,
                                        size_t outputlen) {
   secp256k1_pubkey pubkey;
-  RETURN_IF_ZERO(secp256k1_ec_pubkey_parse(ctx, &pubkey, input, inputlen), 1);
+  RETURN_IF_ZERO(pubkey_load(ctx, &pubkey, input, inputlen), 1);
   RETURN_IF_ZERO(secp256k1_ec_pubkey_tweak_mul(ctx, &pubkey, tweak), 2);
   PUBKEY_SERIALIZE(3);
   return 0;
@@ -250,12 +315,162 @@ int fcrypto_secp256k1_ecdsa_verify(const secp256k1_context* ctx,
   RETURN_IF_ZERO(secp256k1_ecdsa_signature_parse_compact(ctx, &sig, sigraw), 1);
 
   secp256k1_pubkey pubkey;
-  RETURN_IF_ZERO(secp256k1_ec_pubkey_parse(ctx, &pubkey, input, inputlen), 2);
+  RETURN_IF_ZERO(pubkey_load(ctx, &pubkey, input, inputlen), 2);
 
   RETURN_IF_ZERO(secp256k1_ecdsa_verify(ctx, &sig, msg32, &pubkey), 3);
   return 0;
 }
 
+// Digest of raw message for sign / verify, returns 0 for unknown hash
+static int message_hash(unsigned char* output32,
+                        const unsigned char* msg,
+                        size_t msglen,
+                        int hash) {
+  fcrypto_sha256 sha256;
+  switch (hash) {
+    case FCRYPTO_HASH_SHA256:
+    case FCRYPTO_HASH_SHA256D:
+      fcrypto_sha256_init(&sha256);
+      fcrypto_sha256_update(&sha256, msg, msglen);
+      fcrypto_sha256_finalize(&sha256, output32);
+      if (hash == FCRYPTO_HASH_SHA256D) {
+        fcrypto_sha256_init(&sha256);
+        fcrypto_sha256_update(&sha256, output32, 32);
+        fcrypto_sha256_finalize(&sha256, output32);
+      }
+      return 1;
+    case FCRYPTO_HASH_KECCAK256:
+      fcrypto_keccak256_hash(output32, msg, msglen);
+      return 1;
+    default:
+      return 0;
+  }
+}
+
+int fcrypto_secp256k1_ecdsa_sign_message(const secp256k1_context* ctx,
+                                         unsigned char* output,
+                                         int* recid,
+                                         const unsigned char* msg,
+                                         size_t msglen,
+                                         const unsigned char* seckey,
+                                         int hash) {
+  unsigned char msg32[32];
+  RETURN_IF_ZERO(message_hash(msg32, msg, msglen, hash), 3);
+  return fcrypto_secp256k1_ecdsa_sign(ctx, output, recid, msg32, seckey);
+}
+
+int fcrypto_secp256k1_ecdsa_verify_message(const secp256k1_context* ctx,
+                                           const unsigned char* sigraw,
+                                           const unsigned char* msg,
+                                           size_t msglen,
+                                           const unsigned char* input,
+                                           size_t inputlen,
+                                           int hash) {
+  unsigned char msg32[32];
+  RETURN_IF_ZERO(message_hash(msg32, msg, msglen, hash), 4);
+  return fcrypto_secp256k1_ecdsa_verify(ctx, sigraw, msg32, input, inputlen);
+}
+
+size_t fcrypto_secp256k1_verifier_size() {
+  return secp256k1_ext_verifier_size();
+}
+
+int fcrypto_secp256k1_verifier_init(const secp256k1_context* ctx,
+                                    unsigned char* verifier,
+                                    const unsigned char* input,
+                                    size_t inputlen) {
+  secp256k1_pubkey pubkey;
+  RETURN_IF_ZERO(pubkey_load(ctx, &pubkey, input, inputlen), 1);
+
+  RETURN_IF_ZERO(secp256k1_ext_verifier_build(
+                     ctx, (secp256k1_ext_verifier*)verifier, &pubkey),
+                 2);
+  return 0;
+}
+
+int fcrypto_secp256k1_ecdsa_verify_prepared(const secp256k1_context* ctx,
+                                            const unsigned char* sigraw,
+                                            const unsigned char* msg32,
+                                            const unsigned char* verifier) {
+  secp256k1_ecdsa_signature sig;
+  RETURN_IF_ZERO(secp256k1_ecdsa_signature_parse_compact(ctx, &sig, sigraw), 1);
+
+  RETURN_IF_ZERO(
+      secp256k1_ext_ecdsa_verify_prepared(
+          ctx, (const secp256k1_ext_verifier*)verifier, &sig, msg32),
+      3);
+  return 0;
+}
+
+// Parsed items packed to the beginning of arrays, so we need keep indexes.
+// Memory released by caller with fcrypto_arena_reset
+int fcrypto_secp256k1_ecdsa_verify_batch(const secp256k1_context* ctx,
+                                         fcrypto_arena* arena,
+                                         unsigned char* results,
+                                         const unsigned char* const* sigs,
+                                         const int* recids,
+                                         const unsigned char* const* msgs32,
+                                         const unsigned char* const* inputs,
+                                         const size_t* inputslen,
+                                         size_t n) {
+  int ret = 0;
+  size_t m = 0;
+
+  if (n == 0) {
+    return 0;
+  }
+
+  secp256k1_ecdsa_recoverable_signature* rsigs = fcrypto_arena_alloc(
+      arena, n * sizeof(secp256k1_ecdsa_recoverable_signature));
+  secp256k1_pubkey* pubkeys =
+      fcrypto_arena_alloc(arena, n * sizeof(secp256k1_pubkey));
+  const unsigned char** msgs =
+      fcrypto_arena_alloc(arena, n * sizeof(unsigned char*));
+  size_t* indexes = fcrypto_arena_alloc(arena, n * sizeof(size_t));
+  if (rsigs == NULL || pubkeys == NULL || msgs == NULL || indexes == NULL) {
+    return 2;
+  }
+
+  for (size_t i = 0; i < n; ++i) {
+    if (secp256k1_ecdsa_recoverable_signature_parse_compact(
+            ctx, &rsigs[m], sigs[i], recids[i]) == 0) {
+      results[i] = 1;
+      ret = 1;
+      continue;
+    }
+
+    if (pubkey_load(ctx, &pubkeys[m], inputs[i], inputslen[i]) == 0) {
+      results[i] = 2;
+      ret = 1;
+      continue;
+    }
+
+    msgs[m] = msgs32[i];
+    indexes[m] = i;
+    m += 1;
+  }
+
+  if (secp256k1_ext_ecdsa_verify_batch(ctx, arena, rsigs, msgs, pubkeys, m) ==
+      1) {
+    for (size_t i = 0; i < m; ++i) results[indexes[i]] = 0;
+    return ret;
+  }
+
+  // Batch failed (or no memory), check signatures one by one
+  for (size_t i = 0; i < m; ++i) {
+    secp256k1_ecdsa_signature sig;
+    secp256k1_ecdsa_recoverable_signature_convert(ctx, &sig, &rsigs[i]);
+    if (secp256k1_ecdsa_verify(ctx, &sig, msgs[i], &pubkeys[i]) == 1) {
+      results[indexes[i]] = 0;
+    } else {
+      results[indexes[i]] = 3;
+      ret = 1;
+    }
+  }
+
+  return ret;
+}
+
 int fcrypto_secp256k1_ecdsa_recover(const secp256k1_context* ctx,
                                     unsigned char* output,
                                     const unsigned char* sigraw,
@@ -274,21 +489,526 @@ int fcrypto_secp256k1_ecdsa_recover(const secp256k1_context* ctx,
   return 0;
 }
 
+// Public key serialized on stack only for hashing
+int fcrypto_secp256k1_ecdsa_recover_address(const secp256k1_context* ctx,
+                                            unsigned char* output,
+                                            const unsigned char* sigraw,
+                                            int recid,
+                                            const unsigned char* msg32,
+                                            int type) {
+  secp256k1_ecdsa_recoverable_signature sig;
+  RETURN_IF_ZERO(secp256k1_ecdsa_recoverable_signature_parse_compact(
+                     ctx, &sig, sigraw, recid),
+                 1);
+
+  secp256k1_pubkey pubkey;
+  RETURN_IF_ZERO(secp256k1_ecdsa_recover(ctx, &pubkey, &sig, msg32), 2);
+
+  unsigned char serialized[65];
+  size_t serializedlen = type == FCRYPTO_ADDRESS_HASH160 ? 33 : 65;
+  int flags = serializedlen == 33 ? SECP256K1_EC_COMPRESSED
+                                  : SECP256K1_EC_UNCOMPRESSED;
+  RETURN_IF_ZERO(secp256k1_ec_pubkey_serialize(
+                     ctx, serialized, &serializedlen, &pubkey, flags),
+                 3);
+
+  unsigned char hash[32];
+  switch (type) {
+    case FCRYPTO_ADDRESS_KECCAK256:
+      fcrypto_keccak256_hash(hash, serialized + 1, 64);
+      memcpy(output, hash + 12, 20);
+      return 0;
+    case FCRYPTO_ADDRESS_HASH160:
+    case FCRYPTO_ADDRESS_HASH160_UNCOMPRESSED:
+      fcrypto_hash160(output, serialized, serializedlen);
+      return 0;
+    default:
+      return 3;
+  }
+}
+
+// Schnorr (BIP340)
+int fcrypto_secp256k1_xonly_pubkey_create(const secp256k1_context* ctx,
+                                          unsigned char* output,
+                                          const unsigned char* seckey) {
+  secp256k1_pubkey pubkey;
+  RETURN_IF_ZERO(secp256k1_ec_pubkey_create(ctx, &pubkey, seckey), 1);
+
+  unsigned char serialized[33];
+  size_t outputlen = 33;
+  secp256k1_ec_pubkey_serialize(
+      ctx, serialized, &outputlen, &pubkey, SECP256K1_EC_COMPRESSED);
+  memcpy(output, serialized + 1, 32);
+  return 0;
+}
+
+int fcrypto_secp256k1_xonly_pubkey_convert(const secp256k1_context* ctx,
+                                           unsigned char* output,
+                                           const unsigned char* input,
+                                           size_t inputlen) {
+  secp256k1_pubkey pubkey;
+  RETURN_IF_ZERO(pubkey_load(ctx, &pubkey, input, inputlen), 1);
+
+  unsigned char serialized[33];
+  size_t outputlen = 33;
+  secp256k1_ec_pubkey_serialize(
+      ctx, serialized, &outputlen, &pubkey, SECP256K1_EC_COMPRESSED);
+  memcpy(output, serialized + 1, 32);
+  return 0;
+}
+
+int fcrypto_secp256k1_schnorr_sign(const secp256k1_context* ctx,
+                                   unsigned char* output,
+                                   const unsigned char* msg32,
+                                   const unsigned char* seckey,
+                                   const unsigned char* auxrand32) {
+  RETURN_IF_ZERO(
+      secp256k1_ext_schnorr_sign(ctx, output, msg32, seckey, auxrand32), 1);
+  return 0;
+}
+
+int fcrypto_secp256k1_schnorr_verify(const secp256k1_context* ctx,
+                                     const unsigned char* sig64,
+                                     const unsigned char* msg32,
+                                     const unsigned char* xonly32) {
+  secp256k1_pubkey pubkey;
+  RETURN_IF_ZERO(secp256k1_ext_xonly_pubkey_parse(ctx, &pubkey, xonly32), 1);
+  RETURN_IF_ZERO(secp256k1_ext_schnorr_verify(ctx, sig64, msg32, &pubkey), 2);
+  return 0;
+}
+
+// Same as fcrypto_secp256k1_ecdsa_verify_batch, but input split to groups of
+// batchsize items, so one incorrect signature only cost one group. Memory of
+// every group released with arena rewind, so all groups use same memory
+int fcrypto_secp256k1_schnorr_verify_batch(const secp256k1_context* ctx,
+                                           fcrypto_arena* arena,
+                                           unsigned char* results,
+                                           const unsigned char* inputs,
+                                           size_t n,
+                                           size_t batchsize) {
+  int ret = 0;
+
+  if (n == 0) {
+    return 0;
+  }
+  if (batchsize == 0 || batchsize > n) {
+    batchsize = n;
+  }
+
+  secp256k1_pubkey* pubkeys =
+      fcrypto_arena_alloc(arena, batchsize * sizeof(secp256k1_pubkey));
+  const unsigned char** sigs =
+      fcrypto_arena_alloc(arena, batchsize * sizeof(unsigned char*));
+  const unsigned char** msgs =
+      fcrypto_arena_alloc(arena, batchsize * sizeof(unsigned char*));
+  size_t* indexes = fcrypto_arena_alloc(arena, batchsize * sizeof(size_t));
+  if (pubkeys == NULL || sigs == NULL || msgs == NULL || indexes == NULL) {
+    return 2;
+  }
+
+  fcrypto_arena_checkpoint checkpoint = fcrypto_arena_get_checkpoint(arena);
+  for (size_t start = 0; start < n; start += batchsize) {
+    size_t end = n - start < batchsize ? n : start + batchsize;
+    size_t m = 0;
+
+    for (size_t i = start; i < end; ++i) {
+      const unsigned char* input = inputs + i * 128;
+      if (secp256k1_ext_xonly_pubkey_parse(ctx, &pubkeys[m], input + 96) ==
+          0) {
+        results[i] = 1;
+        ret = 1;
+        continue;
+      }
+
+      sigs[m] = input;
+      msgs[m] = input + 64;
+      indexes[m] = i;
+      m += 1;
+    }
+
+    int ok =
+        secp256k1_ext_schnorr_verify_batch(ctx, arena, sigs, msgs, pubkeys, m);
+    fcrypto_arena_rewind(arena, &checkpoint);
+    if (ok == 1) {
+      for (size_t i = 0; i < m; ++i) results[indexes[i]] = 0;
+      continue;
+    }
+
+    // Group failed (or no memory), check signatures one by one
+    for (size_t i = 0; i < m; ++i) {
+      if (secp256k1_ext_schnorr_verify(ctx, sigs[i], msgs[i], &pubkeys[i])) {
+        results[indexes[i]] = 0;
+      } else {
+        results[indexes[i]] = 2;
+        ret = 1;
+      }
+    }
+  }
+
+  return ret;
+}
+
 // ECDH
-// TODO: add custom function & data
+// Output modes, raw point serialized same as public key
+static int ecdh_hash_x(unsigned char* output,
+                       const unsigned char* x32,
+                       const unsigned char* y32,
+                       void* data) {
+  (void)y32;
+  (void)data;
+  memcpy(output, x32, 32);
+  return 1;
+}
+
+static int ecdh_hash_compressed(unsigned char* output,
+                                const unsigned char* x32,
+                                const unsigned char* y32,
+                                void* data) {
+  (void)data;
+  output[0] = 0x02 | (y32[31] & 0x01);
+  memcpy(output + 1, x32, 32);
+  return 1;
+}
+
+static int ecdh_hash_uncompressed(unsigned char* output,
+                                  const unsigned char* x32,
+                                  const unsigned char* y32,
+                                  void* data) {
+  (void)data;
+  output[0] = 0x04;
+  memcpy(output + 1, x32, 32);
+  memcpy(output + 33, y32, 32);
+  return 1;
+}
+
+static int ecdh_hash_keccak256(unsigned char* output,
+                               const unsigned char* x32,
+                               const unsigned char* y32,
+                               void* data) {
+  unsigned char point[33];
+  ecdh_hash_compressed(point, x32, y32, data);
+  fcrypto_keccak256_hash(output, point, 33);
+  memset(point, 0, sizeof(point));
+  return 1;
+}
+
+static secp256k1_ecdh_hash_function ecdh_mode_hashfp(int mode) {
+  switch (mode) {
+    case FCRYPTO_ECDH_SHA256:
+      return secp256k1_ecdh_hash_function_sha256;
+    case FCRYPTO_ECDH_KECCAK256:
+      return ecdh_hash_keccak256;
+    case FCRYPTO_ECDH_RAW_X:
+      return ecdh_hash_x;
+    case FCRYPTO_ECDH_RAW_COMPRESSED:
+      return ecdh_hash_compressed;
+    case FCRYPTO_ECDH_RAW_UNCOMPRESSED:
+      return ecdh_hash_uncompressed;
+    default:
+      return NULL;
+  }
+}
+
+size_t fcrypto_secp256k1_ecdh_outputlen(int mode) {
+  switch (mode) {
+    case FCRYPTO_ECDH_RAW_COMPRESSED:
+      return 33;
+    case FCRYPTO_ECDH_RAW_UNCOMPRESSED:
+      return 65;
+    default:
+      return ecdh_mode_hashfp(mode) == NULL ? 0 : 32;
+  }
+}
+
 int fcrypto_secp256k1_ecdh(const secp256k1_context* ctx,
                            unsigned char* output,
                            const unsigned char* input,
                            size_t inputlen,
                            const unsigned char* seckey) {
+  return fcrypto_secp256k1_ecdh_custom(ctx,
+                                       output,
+                                       input,
+                                       inputlen,
+                                       seckey,
+                                       secp256k1_ecdh_hash_function_sha256,
+                                       NULL);
+}
+
+int fcrypto_secp256k1_ecdh_mode(const secp256k1_context* ctx,
+                                unsigned char* output,
+                                const unsigned char* input,
+                                size_t inputlen,
+                                const unsigned char* seckey,
+                                int mode) {
+  secp256k1_ecdh_hash_function hashfp = ecdh_mode_hashfp(mode);
+  if (hashfp == NULL) {
+    return 3;
+  }
+
+  return fcrypto_secp256k1_ecdh_custom(
+      ctx, output, input, inputlen, seckey, hashfp, NULL);
+}
+
+int fcrypto_secp256k1_ecdh_custom(const secp256k1_context* ctx,
+                                  unsigned char* output,
+                                  const unsigned char* input,
+                                  size_t inputlen,
+                                  const unsigned char* seckey,
+                                  secp256k1_ecdh_hash_function hashfp,
+                                  void* data) {
   secp256k1_pubkey pubkey;
-  RETURN_IF_ZERO(secp256k1_ec_pubkey_parse(ctx, &pubkey, input, inputlen), 1);
-  RETURN_IF_ZERO(secp256k1_ecdh(ctx,
-                                output,
-                                &pubkey,
-                                seckey,
-                                secp256k1_ecdh_hash_function_sha256,
-                                NULL),
+  RETURN_IF_ZERO(pubkey_load(ctx, &pubkey, input, inputlen), 1);
+  RETURN_IF_ZERO(secp256k1_ecdh(ctx, output, &pubkey, seckey, hashfp, data),
                  2);
   return 0;
 }
+
+// Bulk
+#define STATUS_SET(idx, code) \
+  do {                        \
+    statuses[idx] = code;     \
+    if (code != 0) {          \
+      ret = 1;                \
+    }                         \
+  } while (0)
+
+int fcrypto_secp256k1_seckey_verify_many(const secp256k1_context* ctx,
+                                         unsigned char* statuses,
+                                         const unsigned char* seckeys,
+                                         size_t n) {
+  int ret = 0;
+  for (size_t i = 0; i < n; ++i) {
+    int code = fcrypto_secp256k1_seckey_verify(ctx, seckeys + i * 32);
+    STATUS_SET(i, code);
+  }
+  return ret;
+}
+
+int fcrypto_secp256k1_pubkey_create_many(const secp256k1_context* ctx,
+                                         unsigned char* output,
+                                         unsigned char* statuses,
+                                         const unsigned char* seckeys,
+                                         size_t n,
+                                         size_t outputlen) {
+  int ret = 0;
+  // Valid flags replaced by codes of fcrypto_secp256k1_pubkey_create
+  secp256k1_ext_pubkey_create_batch(
+      ctx, output, outputlen, statuses, seckeys, n);
+  for (size_t i = 0; i < n; ++i) {
+    STATUS_SET(i, statuses[i] == 1 ? 0 : 1);
+  }
+  return ret;
+}
+
+int fcrypto_secp256k1_pubkey_create_range(const secp256k1_context* ctx,
+                                          unsigned char* output,
+                                          unsigned char* statuses,
+                                          const unsigned char* seckey,
+                                          size_t n,
+                                          size_t outputlen) {
+  int ret = 0;
+  RETURN_IF_ZERO(secp256k1_ext_pubkey_create_range(
+                     ctx, output, outputlen, statuses, seckey, n),
+                 2);
+  for (size_t i = 0; i < n; ++i) {
+    STATUS_SET(i, statuses[i] == 1 ? 0 : 1);
+  }
+  return ret;
+}
+
+int fcrypto_secp256k1_ecdsa_sign_many(const secp256k1_context* ctx,
+                                      unsigned char* output,
+                                      unsigned char* statuses,
+                                      const unsigned char* inputs,
+                                      size_t n) {
+  int ret = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const unsigned char* input = inputs + i * 64;
+    unsigned char* sig = output + i * 65;
+    int recid = 0;
+    int code =
+        fcrypto_secp256k1_ecdsa_sign(ctx, sig, &recid, input, input + 32);
+    sig[64] = (unsigned char)recid;
+    STATUS_SET(i, code);
+  }
+  return ret;
+}
+
+int fcrypto_secp256k1_ecdsa_verify_many(const secp256k1_context* ctx,
+                                        unsigned char* statuses,
+                                        const unsigned char* inputs,
+                                        size_t n,
+                                        size_t pubkeylen) {
+  int ret = 0;
+  size_t recordlen = 96 + pubkeylen;
+  for (size_t i = 0; i < n; ++i) {
+    const unsigned char* input = inputs + i * recordlen;
+    int code = fcrypto_secp256k1_ecdsa_verify(
+        ctx, input, input + 64, input + 96, pubkeylen);
+    STATUS_SET(i, code);
+  }
+  return ret;
+}
+
+int fcrypto_secp256k1_ecdsa_sign_message_many(const secp256k1_context* ctx,
+                                              unsigned char* output,
+                                              unsigned char* statuses,
+                                              const unsigned char* seckeys,
+                                              const unsigned char* msgs,
+                                              const uint32_t* offsets,
+                                              size_t n,
+                                              int hash) {
+  int ret = 0;
+  for (size_t i = 0; i < n; ++i) {
+    unsigned char* sig = output + i * 65;
+    int recid = 0;
+    int code = fcrypto_secp256k1_ecdsa_sign_message(ctx,
+                                                    sig,
+                                                    &recid,
+                                                    msgs + offsets[i],
+                                                    offsets[i + 1] - offsets[i],
+                                                    seckeys + i * 32,
+                                                    hash);
+    sig[64] = (unsigned char)recid;
+    STATUS_SET(i, code);
+  }
+  return ret;
+}
+
+int fcrypto_secp256k1_ecdsa_verify_message_many(const secp256k1_context* ctx,
+                                                unsigned char* statuses,
+                                                const unsigned char* inputs,
+                                                const unsigned char* msgs,
+                                                const uint32_t* offsets,
+                                                size_t n,
+                                                size_t pubkeylen,
+                                                int hash) {
+  int ret = 0;
+  size_t recordlen = 64 + pubkeylen;
+  for (size_t i = 0; i < n; ++i) {
+    const unsigned char* input = inputs + i * recordlen;
+    int code =
+        fcrypto_secp256k1_ecdsa_verify_message(ctx,
+                                               input,
+                                               msgs + offsets[i],
+                                               offsets[i + 1] - offsets[i],
+                                               input + 64,
+                                               pubkeylen,
+                                               hash);
+    STATUS_SET(i, code);
+  }
+  return ret;
+}
+
+int fcrypto_secp256k1_ecdsa_recover_many(const secp256k1_context* ctx,
+                                         unsigned char* output,
+                                         unsigned char* statuses,
+                                         const unsigned char* inputs,
+                                         size_t n,
+                                         size_t outputlen) {
+  int ret = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const unsigned char* input = inputs + i * 97;
+    // Records come from JS as is, libsecp256k1 require recid in [0, 3]
+    if (input[64] > 3) {
+      STATUS_SET(i, 1);
+      continue;
+    }
+
+    int code = fcrypto_secp256k1_ecdsa_recover(ctx,
+                                               output + i * outputlen,
+                                               input,
+                                               input[64],
+                                               input + 65,
+                                               outputlen);
+    STATUS_SET(i, code);
+  }
+  return ret;
+}
+
+int fcrypto_secp256k1_ecdsa_recover_address_many(const secp256k1_context* ctx,
+                                                 unsigned char* output,
+                                                 unsigned char* statuses,
+                                                 const unsigned char* inputs,
+                                                 size_t n,
+                                                 int type) {
+  int ret = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const unsigned char* input = inputs + i * 97;
+    if (input[64] > 3) {
+      STATUS_SET(i, 1);
+      continue;
+    }
+
+    int code = fcrypto_secp256k1_ecdsa_recover_address(
+        ctx, output + i * 20, input, input[64], input + 65, type);
+    STATUS_SET(i, code);
+  }
+  return ret;
+}
+
+int fcrypto_secp256k1_ecdh_many(const secp256k1_context* ctx,
+                                unsigned char* output,
+                                unsigned char* statuses,
+                                const unsigned char* inputs,
+                                size_t n,
+                                size_t pubkeylen) {
+  int ret = 0;
+  size_t recordlen = pubkeylen + 32;
+  for (size_t i = 0; i < n; ++i) {
+    const unsigned char* input = inputs + i * recordlen;
+    int code = fcrypto_secp256k1_ecdh(
+        ctx, output + i * 32, input, pubkeylen, input + pubkeylen);
+    STATUS_SET(i, code);
+  }
+  return ret;
+}
+
+// Public keys parsed in groups of same size as in secp256k1_ext_ecdh_batch
+#define ECDH_BATCH 64
+
+int fcrypto_secp256k1_ecdh_pubkeys_many(const secp256k1_context* ctx,
+                                        unsigned char* output,
+                                        unsigned char* statuses,
+                                        const unsigned char* seckey,
+                                        const unsigned char* inputs,
+                                        size_t n,
+                                        size_t pubkeylen,
+                                        int mode) {
+  secp256k1_pubkey pubkeys[ECDH_BATCH];
+  unsigned char valid[ECDH_BATCH];
+  secp256k1_ecdh_hash_function hashfp = ecdh_mode_hashfp(mode);
+  size_t outputlen = fcrypto_secp256k1_ecdh_outputlen(mode);
+  size_t i, j, len;
+  int ret = 0;
+
+  if (hashfp == NULL) {
+    return 3;
+  }
+
+  for (i = 0; i < n; i += len) {
+    len = n - i < ECDH_BATCH ? n - i : ECDH_BATCH;
+
+    for (j = 0; j < len; ++j) {
+      valid[j] = (unsigned char)pubkey_load(
+          ctx, &pubkeys[j], inputs + (i + j) * pubkeylen, pubkeylen);
+    }
+
+    RETURN_IF_ZERO(secp256k1_ext_ecdh_batch(ctx,
+                                            output + i * outputlen,
+                                            outputlen,
+                                            valid,
+                                            pubkeys,
+                                            seckey,
+                                            len,
+                                            hashfp,
+                                            NULL),
+                   2);
+
+    // Built-in hash functions do not fail, so only unparsed keys are invalid
+    for (j = 0; j < len; ++j) {
+      STATUS_SET(i + j, valid[j] ? 0 : 1);
+    }
+  }
+  return ret;
+}
@@ -5,11 +5,25 @@
 extern "C" {
 #endif
 
+#include <fcrypto/arena.h>
 #include <secp256k1/include/secp256k1.h>
+#include <secp256k1/include/secp256k1_ecdh.h>
+#include <stdint.h>
 
 size_t fcrypto_secp256k1_context_size();
+// Build profile, see binding.gyp
+int fcrypto_secp256k1_ecmult_gen_prec_bits();
+int fcrypto_secp256k1_ecmult_window_size();
+// Tables linked as read-only data, see `secp256k1_static_tables` in Makefile
+int fcrypto_secp256k1_static_tables();
 secp256k1_context* fcrypto_secp256k1_context_create();
 void fcrypto_secp256k1_context_destroy(secp256k1_context* ctx);
+// Cheap copy which shares precomputed tables with ctx, see
+// secp256k1_ext_context_shallow_clone
+size_t fcrypto_secp256k1_context_clone_size();
+secp256k1_context* fcrypto_secp256k1_context_clone(
+    const secp256k1_context* ctx);
+void fcrypto_secp256k1_context_clone_destroy(secp256k1_context* ctx);
 
 /** Updates the context randomization to protect against side-channel leakage.
  *  Returns: 0: randomization successfully updated or nothing to randomize
@@ -60,6 +74,18 @@ int fcrypto_secp256k1_pubkey_create(const secp256k1_context* ctx,
                                     const unsigned char* seckey,
                                     size_t outputlen);
 
+/** Parse public key to internal representation (64 bytes), which can be
+ *  passed instead of serialized key (with inputlen 64) to any function below.
+ *  Representation is not checked on loading, so it should come only from
+ *  this function.
+ *  Returns: 0: on success
+ *           1: the public key could not be parsed
+ */
+int fcrypto_secp256k1_pubkey_parse(const secp256k1_context* ctx,
+                                   unsigned char* output,
+                                   const unsigned char* input,
+                                   size_t inputlen);
+
 /** Reserialize public key to another format.
  *  Returns: 0: on success
  *           1: the public key could not be parsed
@@ -84,18 +110,45 @@ int fcrypto_secp256k1_pubkey_negate(const secp256k1_context* ctx,
                                     size_t outputlen);
 
 /** Add a number of public keys together.
+ *  Temporary data allocated from arena, caller should reset it.
  *  Returns: 0: the sum of the public keys is valid
  *           1: one of the public keys could not be parsed
  *           2: the sum of the public keys is not valid
  *           3: pubkey serialization error
+ *           4: memory allocation error
  */
 int fcrypto_secp256k1_pubkey_combine(const secp256k1_context* ctx,
+                                     fcrypto_arena* arena,
                                      unsigned char* output,
                                      const unsigned char* const* inputs,
                                      const size_t* inputslen,
                                      size_t n,
                                      size_t outputlen);
 
+/** Compute gscalar * G + sum(scalars_i * P_i) for n public keys with one
+ *  multi-scalar multiplication, see secp256k1_ext_pubkey_linear_combination.
+ *  Scalars packed as n * 32 bytes, gscalar can be NULL. Not constant time,
+ *  scalars should not be secret.
+ *  Temporary data and scratch space allocated from arena, caller should reset
+ *  it.
+ *  Returns: 0: the combination of the public keys is valid
+ *           1: one of the public keys could not be parsed
+ *           2: one of the scalars overflow, the combination is infinity, or
+ * there is not enough memory for multiplication
+ *           3: pubkey serialization error
+ *           4: memory allocation error
+ */
+int fcrypto_secp256k1_pubkey_linear_combination(
+    const secp256k1_context* ctx,
+    fcrypto_arena* arena,
+    unsigned char* output,
+    const unsigned char* const* inputs,
+    const size_t* inputslen,
+    const unsigned char* scalars,
+    const unsigned char* gscalar,
+    size_t n,
+    size_t outputlen);
+
 /** Tweak a public key by adding tweak times the generator to it.
  *  Returns: 0: on success
  *           1: the public key could not be parsed
@@ -172,6 +225,91 @@ int fcrypto_secp256k1_ecdsa_verify(const secp256k1_context* ctx,
                                    const unsigned char* input,
                                    size_t inputlen);
 
+// Hash functions of raw messages for sign / verify
+// SHA256D: sha256(sha256(msg)), Bitcoin
+// KECCAK256: Ethereum (original padding, not SHA3-256)
+#define FCRYPTO_HASH_SHA256 0
+#define FCRYPTO_HASH_SHA256D 1
+#define FCRYPTO_HASH_KECCAK256 2
+
+/** Create an ECDSA signature of raw message, digest computed with hash.
+ *  Returns: 0: signature created
+ *           1: the nonce generation function failed, or the private key was
+ * invalid
+ *           2: never should be returned
+ *           3: unknown hash
+ */
+int fcrypto_secp256k1_ecdsa_sign_message(const secp256k1_context* ctx,
+                                         unsigned char* output,
+                                         int* recid,
+                                         const unsigned char* msg,
+                                         size_t msglen,
+                                         const unsigned char* seckey,
+                                         int hash);
+
+/** Verify an ECDSA signature of raw message, digest computed with hash.
+ *  Returns: 0: correct signature
+ *           1: signature could not be parsed
+ *           2: the public key could not be parsed
+ *           3: incorrect or unparseable signature
+ *           4: unknown hash
+ */
+int fcrypto_secp256k1_ecdsa_verify_message(const secp256k1_context* ctx,
+                                           const unsigned char* sigraw,
+                                           const unsigned char* msg,
+                                           size_t msglen,
+                                           const unsigned char* input,
+                                           size_t inputlen,
+                                           int hash);
+
+/** Size of prepared verifier in bytes (memory allocated by caller).
+ */
+size_t fcrypto_secp256k1_verifier_size();
+
+/** Prepare verifier for a public key: precompute table of key multiples,
+ *  fcrypto_secp256k1_verifier_size() bytes.
+ *  Returns: 0: verifier prepared
+ *           1: the public key could not be parsed
+ *           2: memory allocation error
+ */
+int fcrypto_secp256k1_verifier_init(const secp256k1_context* ctx,
+                                    unsigned char* verifier,
+                                    const unsigned char* input,
+                                    size_t inputlen);
+
+/** Verify an ECDSA signature with prepared verifier.
+ *  Returns: 0: correct signature
+ *           1: signature could not be parsed
+ *           2: never should be returned
+ *           3: incorrect or unparseable signature
+ */
+int fcrypto_secp256k1_ecdsa_verify_prepared(const secp256k1_context* ctx,
+                                            const unsigned char* sigraw,
+                                            const unsigned char* msg32,
+                                            const unsigned char* verifier);
+
+/** Verify a batch of ECDSA signatures.
+ *  Signatures checked together with one multi-scalar multiplication, recovery
+ *  ids required for this. Only if batch check fails, every signature verified
+ *  separately for finding incorrect items.
+ *  Code for each item (same as in fcrypto_secp256k1_ecdsa_verify) stored in
+ *  results.
+ *  Temporary data and scratch space allocated from arena, caller should reset
+ *  it.
+ *  Returns: 0: all signatures are correct
+ *           1: at least one item is not correct (see results)
+ *           2: memory allocation error
+ */
+int fcrypto_secp256k1_ecdsa_verify_batch(const secp256k1_context* ctx,
+                                         fcrypto_arena* arena,
+                                         unsigned char* results,
+                                         const unsigned char* const* sigs,
+                                         const int* recids,
+                                         const unsigned char* const* msgs32,
+                                         const unsigned char* const* inputs,
+                                         const size_t* inputslen,
+                                         size_t n);
+
 /** Recover an ECDSA public key from a signature.
  *  Returns: 0: public key successfully recovered (which guarantees a correct
  * signature)
@@ -186,7 +324,105 @@ int fcrypto_secp256k1_ecdsa_recover(const secp256k1_context* ctx,
                                     const unsigned char* msg32,
                                     size_t outputlen);
 
-/** Compute an EC Diffie-Hellman secret in constant time.
+// Address types of fcrypto_secp256k1_ecdsa_recover_address
+// KECCAK256: last 20 bytes of keccak256(x || y), Ethereum
+// HASH160: ripemd160(sha256(compressed public key))
+// HASH160_UNCOMPRESSED: ripemd160(sha256(uncompressed public key))
+#define FCRYPTO_ADDRESS_KECCAK256 0
+#define FCRYPTO_ADDRESS_HASH160 1
+#define FCRYPTO_ADDRESS_HASH160_UNCOMPRESSED 2
+
+/** Recover an ECDSA public key from a signature and compute address (20
+ *  bytes) from it, serialized public key is not returned.
+ *  Returns: 0: address successfully computed
+ *           1: signature could not be parsed
+ *           2: public key could not be recover
+ *           3: unknown address type
+ */
+int fcrypto_secp256k1_ecdsa_recover_address(const secp256k1_context* ctx,
+                                            unsigned char* output,
+                                            const unsigned char* sig,
+                                            int recid,
+                                            const unsigned char* msg32,
+                                            int type);
+
+// Schnorr signatures (BIP340) with x-only public keys (32 bytes, x of point
+// with even y). Implemented in secp256k1_ext, because libsecp256k1 version
+// in src/secp256k1 does not have schnorrsig module.
+
+/** Compute the x-only public key for a secret key.
+ *  Returns: 0: public key created
+ *           1: secret key is invalid
+ */
+int fcrypto_secp256k1_xonly_pubkey_create(const secp256k1_context* ctx,
+                                          unsigned char* output,
+                                          const unsigned char* seckey);
+
+/** Convert a public key to x-only public key.
+ *  Returns: 0: public key converted
+ *           1: the public key could not be parsed
+ */
+int fcrypto_secp256k1_xonly_pubkey_convert(const secp256k1_context* ctx,
+                                           unsigned char* output,
+                                           const unsigned char* input,
+                                           size_t inputlen);
+
+/** Create a Schnorr signature (64 bytes). auxrand32 is auxiliary random data
+ *  for nonce, NULL is same as 32 zero bytes.
+ *  Returns: 0: signature created
+ *           1: the private key was invalid
+ */
+int fcrypto_secp256k1_schnorr_sign(const secp256k1_context* ctx,
+                                   unsigned char* output,
+                                   const unsigned char* msg32,
+                                   const unsigned char* seckey,
+                                   const unsigned char* auxrand32);
+
+/** Verify a Schnorr signature.
+ *  Returns: 0: correct signature
+ *           1: the public key could not be parsed
+ *           2: incorrect signature
+ */
+int fcrypto_secp256k1_schnorr_verify(const secp256k1_context* ctx,
+                                     const unsigned char* sig64,
+                                     const unsigned char* msg32,
+                                     const unsigned char* xonly32);
+
+/** Verify n Schnorr signatures in groups of batchsize items (0 for one
+ *  group), each group checked with one multi-scalar multiplication. Only if
+ *  group check fails, every signature of group verified separately.
+ *  Input records: signature64 || msg32 || xonly32 (128 bytes)
+ *  Code for each item (same as in fcrypto_secp256k1_schnorr_verify) stored in
+ *  results.
+ *  Temporary data and scratch space allocated from arena (reused by groups),
+ *  caller should reset it.
+ *  Returns: 0: all signatures are correct
+ *           1: at least one item is not correct (see results)
+ *           2: memory allocation error
+ */
+int fcrypto_secp256k1_schnorr_verify_batch(const secp256k1_context* ctx,
+                                           fcrypto_arena* arena,
+                                           unsigned char* results,
+                                           const unsigned char* inputs,
+                                           size_t n,
+                                           size_t batchsize);
+
+// ECDH output modes (shared point P)
+// SHA256: sha256(compressed P), 32 bytes, default of libsecp256k1
+// KECCAK256: keccak256(compressed P), 32 bytes
+// RAW_X: x of P, 32 bytes
+// RAW_COMPRESSED: 0x02 / 0x03 || x, 33 bytes
+// RAW_UNCOMPRESSED: 0x04 || x || y, 65 bytes
+#define FCRYPTO_ECDH_SHA256 0
+#define FCRYPTO_ECDH_KECCAK256 1
+#define FCRYPTO_ECDH_RAW_X 2
+#define FCRYPTO_ECDH_RAW_COMPRESSED 3
+#define FCRYPTO_ECDH_RAW_UNCOMPRESSED 4
+
+/** Output length of ECDH mode, 0 for unknown mode. */
+size_t fcrypto_secp256k1_ecdh_outputlen(int mode);
+
+/** Compute an EC Diffie-Hellman secret in constant time (FCRYPTO_ECDH_SHA256).
  *  Returns: 0: exponentiation was successful
  *           1: the public key could not be parsed
  *           2: scalar was invalid (zero or overflow)
@@ -197,6 +433,185 @@ int fcrypto_secp256k1_ecdh(const secp256k1_context* ctx,
                            size_t inputlen,
                            const unsigned char* seckey);
 
+/** Same as fcrypto_secp256k1_ecdh, output selected by mode.
+ *  Returns: 0-2: same as fcrypto_secp256k1_ecdh
+ *           3: unknown mode
+ */
+int fcrypto_secp256k1_ecdh_mode(const secp256k1_context* ctx,
+                                unsigned char* output,
+                                const unsigned char* input,
+                                size_t inputlen,
+                                const unsigned char* seckey,
+                                int mode);
+
+/** Same as fcrypto_secp256k1_ecdh with custom KDF for native code: hashfp
+ *  receives x and y of shared point and data, see secp256k1_ecdh.
+ *  Returns: 0: exponentiation was successful
+ *           1: the public key could not be parsed
+ *           2: scalar was invalid (zero or overflow), or hashfp failed
+ */
+int fcrypto_secp256k1_ecdh_custom(const secp256k1_context* ctx,
+                                  unsigned char* output,
+                                  const unsigned char* input,
+                                  size_t inputlen,
+                                  const unsigned char* seckey,
+                                  secp256k1_ecdh_hash_function hashfp,
+                                  void* data);
+
+// Bulk functions work with packed arrays of fixed-width records.
+// Code for each item (same as in single function) stored in statuses.
+
+/** Verify n ECDSA secret keys, each 32 bytes.
+ *  Returns: 0: all secret keys are valid
+ *           1: at least one secret key is invalid (see statuses)
+ */
+int fcrypto_secp256k1_seckey_verify_many(const secp256k1_context* ctx,
+                                         unsigned char* statuses,
+                                         const unsigned char* seckeys,
+                                         size_t n);
+
+/** Compute public keys for n secret keys, each 32 bytes.
+ *  Public keys stored in output, each outputlen bytes. One field inversion
+ *  for every 64 keys, see secp256k1_ext_pubkey_create_batch.
+ *  Returns: 0: all public keys successfully created
+ *           1: at least one public key was not created (see statuses)
+ */
+int fcrypto_secp256k1_pubkey_create_many(const secp256k1_context* ctx,
+                                         unsigned char* output,
+                                         unsigned char* statuses,
+                                         const unsigned char* seckeys,
+                                         size_t n,
+                                         size_t outputlen);
+
+/** Compute public keys for secret keys seckey, seckey + 1, ..., seckey + n - 1
+ *  (modulo group order), see secp256k1_ext_pubkey_create_range.
+ *  Public keys stored in output, each outputlen bytes.
+ *  Returns: 0: all public keys successfully created
+ *           1: at least one secret key is zero (see statuses)
+ *           2: seckey is invalid
+ */
+int fcrypto_secp256k1_pubkey_create_range(const secp256k1_context* ctx,
+                                          unsigned char* output,
+                                          unsigned char* statuses,
+                                          const unsigned char* seckey,
+                                          size_t n,
+                                          size_t outputlen);
+
+/** Create n ECDSA signatures.
+ *  Input records: msg32 || seckey32 (64 bytes)
+ *  Output records: signature64 || recid (65 bytes)
+ *  Returns: 0: all signatures created
+ *           1: at least one signature was not created (see statuses)
+ */
+int fcrypto_secp256k1_ecdsa_sign_many(const secp256k1_context* ctx,
+                                      unsigned char* output,
+                                      unsigned char* statuses,
+                                      const unsigned char* inputs,
+                                      size_t n);
+
+/** Verify n ECDSA signatures.
+ *  Input records: signature64 || msg32 || pubkey (96 + pubkeylen bytes)
+ *  Returns: 0: all signatures are correct
+ *           1: at least one signature is not correct (see statuses)
+ */
+int fcrypto_secp256k1_ecdsa_verify_many(const secp256k1_context* ctx,
+                                        unsigned char* statuses,
+                                        const unsigned char* inputs,
+                                        size_t n,
+                                        size_t pubkeylen);
+
+/** Create n ECDSA signatures of raw messages, see
+ *  fcrypto_secp256k1_ecdsa_sign_message.
+ *  Private keys: n * 32 bytes. Message i is msgs[offsets[i]..offsets[i + 1]),
+ *  offsets has n + 1 items.
+ *  Output records: signature64 || recid (65 bytes)
+ *  Returns: 0: all signatures created
+ *           1: at least one signature was not created (see statuses)
+ */
+int fcrypto_secp256k1_ecdsa_sign_message_many(const secp256k1_context* ctx,
+                                              unsigned char* output,
+                                              unsigned char* statuses,
+                                              const unsigned char* seckeys,
+                                              const unsigned char* msgs,
+                                              const uint32_t* offsets,
+                                              size_t n,
+                                              int hash);
+
+/** Verify n ECDSA signatures of raw messages, see
+ *  fcrypto_secp256k1_ecdsa_verify_message.
+ *  Input records: signature64 || pubkey (64 + pubkeylen bytes). Messages
+ *  same as in fcrypto_secp256k1_ecdsa_sign_message_many.
+ *  Returns: 0: all signatures are correct
+ *           1: at least one signature is not correct (see statuses)
+ */
+int fcrypto_secp256k1_ecdsa_verify_message_many(const secp256k1_context* ctx,
+                                                unsigned char* statuses,
+                                                const unsigned char* inputs,
+                                                const unsigned char* msgs,
+                                                const uint32_t* offsets,
+                                                size_t n,
+                                                size_t pubkeylen,
+                                                int hash);
+
+/** Recover n ECDSA public keys.
+ *  Input records: signature64 || recid || msg32 (97 bytes)
+ *  Public keys stored in output, each outputlen bytes.
+ *  Returns: 0: all public keys recovered
+ *           1: at least one public key was not recovered (see statuses)
+ */
+int fcrypto_secp256k1_ecdsa_recover_many(const secp256k1_context* ctx,
+                                         unsigned char* output,
+                                         unsigned char* statuses,
+                                         const unsigned char* inputs,
+                                         size_t n,
+                                         size_t outputlen);
+
+/** Recover n addresses, see fcrypto_secp256k1_ecdsa_recover_address.
+ *  Input records: signature64 || recid || msg32 (97 bytes)
+ *  Addresses stored in output, each 20 bytes.
+ *  Returns: 0: all addresses computed
+ *           1: at least one address was not computed (see statuses)
+ */
+int fcrypto_secp256k1_ecdsa_recover_address_many(const secp256k1_context* ctx,
+                                                 unsigned char* output,
+                                                 unsigned char* statuses,
+                                                 const unsigned char* inputs,
+                                                 size_t n,
+                                                 int type);
+
+/** Compute n ECDH shared secrets (sha256 of compressed point).
+ *  Input records: pubkey || seckey32 (pubkeylen + 32 bytes)
+ *  Secrets stored in output, each 32 bytes.
+ *  Returns: 0: all secrets computed
+ *           1: at least one secret was not computed (see statuses)
+ */
+int fcrypto_secp256k1_ecdh_many(const secp256k1_context* ctx,
+                                unsigned char* output,
+                                unsigned char* statuses,
+                                const unsigned char* inputs,
+                                size_t n,
+                                size_t pubkeylen);
+
+/** Compute n ECDH secrets of one secret key and n public keys, see
+ *  fcrypto_secp256k1_ecdh_mode. Shared points converted to affine together,
+ *  see secp256k1_ext_ecdh_batch.
+ *  Input records: pubkey (pubkeylen bytes)
+ *  Secrets stored in output, each fcrypto_secp256k1_ecdh_outputlen(mode)
+ *  bytes.
+ *  Returns: 0: all secrets computed
+ *           1: at least one public key could not be parsed (see statuses)
+ *           2: seckey is invalid
+ *           3: unknown mode
+ */
+int fcrypto_secp256k1_ecdh_pubkeys_many(const secp256k1_context* ctx,
+                                        unsigned char* output,
+                                        unsigned char* statuses,
+                                        const unsigned char* seckey,
+                                        const unsigned char* inputs,
+                                        size_t n,
+                                        size_t pubkeylen,
+                                        int mode);
+
 #ifdef __cplusplus
 }
 #endif
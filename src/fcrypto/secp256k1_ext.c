@@ -0,0 +1,1009 @@
+// libsecp256k1 keeps field, group and ecmult code as static functions in one
+// translation unit, so extensions are compiled together with the library.
+// This file replaces `src/secp256k1/src/secp256k1.c` in build, see binding.gyp
+#include <secp256k1/src/secp256k1.c>
+
+#include <fcrypto/secp256k1_ext.h>
+
+// Generated by gen_ecmult_static.c on build, see Makefile
+#ifdef FCRYPTO_ECMULT_STATIC_PRECOMPUTATION
+#ifndef USE_ECMULT_STATIC_PRECOMPUTATION
+#error "FCRYPTO_ECMULT_STATIC_PRECOMPUTATION requires static generator table"
+#endif
+#include <ecmult_static_pre_g.h>
+#endif
+
+// Build parameters
+int secp256k1_ext_ecmult_gen_prec_bits(void) { return ECMULT_GEN_PREC_BITS; }
+
+int secp256k1_ext_ecmult_window_size(void) { return ECMULT_WINDOW_SIZE; }
+
+int secp256k1_ext_static_tables(void) {
+#ifdef FCRYPTO_ECMULT_STATIC_PRECOMPUTATION
+  return 1;
+#else
+  return 0;
+#endif
+}
+
+// Context
+#ifdef FCRYPTO_ECMULT_STATIC_PRECOMPUTATION
+// Generator table already static in library, so context created only with
+// blinding and pointers to tables in read-only data. Tables are not freed
+// (and not cleared) on destroy, because ecmult context do not own memory.
+size_t secp256k1_ext_context_size(void) {
+  return secp256k1_context_preallocated_size(SECP256K1_CONTEXT_SIGN);
+}
+
+secp256k1_context* secp256k1_ext_context_create(void) {
+  secp256k1_context* ctx = secp256k1_context_create(SECP256K1_CONTEXT_SIGN);
+  if (ctx != NULL) {
+    ctx->ecmult_ctx.pre_g =
+        (secp256k1_ge_storage(*)[])secp256k1_ext_static_pre_g;
+#ifdef USE_ENDOMORPHISM
+    ctx->ecmult_ctx.pre_g_128 =
+        (secp256k1_ge_storage(*)[])secp256k1_ext_static_pre_g_128;
+#endif
+  }
+  return ctx;
+}
+#else
+size_t secp256k1_ext_context_size(void) {
+  return secp256k1_context_preallocated_size(SECP256K1_CONTEXT_SIGN |
+                                             SECP256K1_CONTEXT_VERIFY);
+}
+
+secp256k1_context* secp256k1_ext_context_create(void) {
+  return secp256k1_context_create(SECP256K1_CONTEXT_SIGN |
+                                  SECP256K1_CONTEXT_VERIFY);
+}
+#endif
+
+size_t secp256k1_ext_context_shallow_size(void) {
+  return sizeof(secp256k1_context);
+}
+
+secp256k1_context* secp256k1_ext_context_shallow_clone(
+    const secp256k1_context* ctx) {
+  secp256k1_context* ret;
+
+  VERIFY_CHECK(ctx != NULL);
+
+  ret = malloc(sizeof(secp256k1_context));
+  if (ret != NULL) {
+    memcpy(ret, ctx, sizeof(secp256k1_context));
+  }
+  return ret;
+}
+
+void secp256k1_ext_context_shallow_destroy(secp256k1_context* ctx) {
+  if (ctx == NULL) {
+    return;
+  }
+
+  // Tables belong to original context, clear only blinding
+  secp256k1_scalar_clear(&ctx->ecmult_gen_ctx.blind);
+  secp256k1_gej_clear(&ctx->ecmult_gen_ctx.initial);
+  free(ctx);
+}
+
+// Helpers
+typedef struct {
+  const secp256k1_scalar* scalars;
+  const secp256k1_ge* points;
+} secp256k1_ext_ecmult_multi_data;
+
+static int secp256k1_ext_ecmult_multi_callback(secp256k1_scalar* sc,
+                                               secp256k1_ge* pt,
+                                               size_t idx,
+                                               void* cbdata) {
+  const secp256k1_ext_ecmult_multi_data* data = cbdata;
+  *sc = data->scalars[idx];
+  *pt = data->points[idx];
+  return 1;
+}
+
+// Same sizes as in libsecp256k1 tests of ecmult_multi, plus alignment of
+// every object allocated from scratch
+size_t secp256k1_ext_scratch_size(size_t n) {
+  size_t size;
+  if (n < ECMULT_PIPPENGER_THRESHOLD) {
+    size = secp256k1_strauss_scratch_size(n) +
+           STRAUSS_SCRATCH_OBJECTS * ALIGNMENT;
+  } else {
+    int bucket_window = secp256k1_pippenger_bucket_window(n);
+    size = secp256k1_pippenger_scratch_size(n, bucket_window) +
+           PIPPENGER_SCRATCH_OBJECTS * ALIGNMENT;
+  }
+
+  return size < SECP256K1_EXT_SCRATCH_MAX ? size : SECP256K1_EXT_SCRATCH_MAX;
+}
+
+// Scratch space in arena memory with same layout as secp256k1_scratch_create
+// makes, so it is not destroyed, but released with arena
+static secp256k1_scratch* secp256k1_ext_scratch_alloc(fcrypto_arena* arena,
+                                                      size_t n) {
+  const size_t base_alloc =
+      (sizeof(secp256k1_scratch) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+  size_t size = secp256k1_ext_scratch_size(n);
+  secp256k1_scratch* scratch = fcrypto_arena_alloc(arena, base_alloc + size);
+  if (scratch == NULL) {
+    return NULL;
+  }
+
+  memset(scratch, 0, sizeof(*scratch));
+  memcpy(scratch->magic, "scratch", 8);
+  scratch->data = (unsigned char*)scratch + base_alloc;
+  scratch->max_size = size;
+  return scratch;
+}
+
+// Randomizer for batch item: sha256(seed32 || uint64be(idx))
+static void secp256k1_ext_batch_randomizer(secp256k1_scalar* r,
+                                           const unsigned char* seed32,
+                                           size_t idx) {
+  secp256k1_sha256 sha;
+  unsigned char buf[32];
+  uint64_t idx64 = idx;
+  int i;
+
+  for (i = 0; i < 8; ++i) buf[i] = (unsigned char)(idx64 >> (56 - 8 * i));
+
+  secp256k1_sha256_initialize(&sha);
+  secp256k1_sha256_write(&sha, seed32, 32);
+  secp256k1_sha256_write(&sha, buf, 8);
+  secp256k1_sha256_finalize(&sha, buf);
+  secp256k1_scalar_set_b32(r, buf, NULL);
+}
+
+// Public keys
+// Points converted to affine in groups, one field inversion per group
+#define SECP256K1_EXT_PUBKEY_BATCH 64
+
+// Montgomery batch inversion: z of every point multiplied into prefix
+// products, product inverted once, then each inverse restored with two
+// multiplications. Points depend from secret keys, so inversion is constant
+// time (not secp256k1_ge_set_all_gej_var). Points at infinity use z = 1.
+static void secp256k1_ext_ge_set_all_gej(secp256k1_ge* r,
+                                         const secp256k1_gej* a,
+                                         size_t len) {
+  secp256k1_fe prefix[SECP256K1_EXT_PUBKEY_BATCH];
+  secp256k1_fe one, inv, zi, z;
+  size_t i;
+
+  VERIFY_CHECK(len > 0 && len <= SECP256K1_EXT_PUBKEY_BATCH);
+
+  secp256k1_fe_set_int(&one, 1);
+  for (i = 0; i < len; ++i) {
+    z = a[i].z;
+    secp256k1_fe_cmov(&z, &one, a[i].infinity);
+    if (i == 0) {
+      prefix[0] = z;
+    } else {
+      secp256k1_fe_mul(&prefix[i], &prefix[i - 1], &z);
+    }
+  }
+
+  secp256k1_fe_inv(&inv, &prefix[len - 1]);
+  for (i = len - 1; i > 0; --i) {
+    z = a[i].z;
+    secp256k1_fe_cmov(&z, &one, a[i].infinity);
+    secp256k1_fe_mul(&zi, &inv, &prefix[i - 1]);
+    secp256k1_fe_mul(&inv, &inv, &z);
+    secp256k1_ge_set_gej_zinv(&r[i], &a[i], &zi);
+  }
+  secp256k1_ge_set_gej_zinv(&r[0], &a[0], &inv);
+}
+
+// Serialize group of points, point at infinity means invalid secret key or
+// tweak
+static void secp256k1_ext_pubkey_serialize_all(unsigned char* output,
+                                               size_t outputlen,
+                                               unsigned char* valid,
+                                               const secp256k1_gej* gej,
+                                               size_t len) {
+  secp256k1_ge ge[SECP256K1_EXT_PUBKEY_BATCH];
+  size_t i, size;
+
+  secp256k1_ext_ge_set_all_gej(ge, gej, len);
+  for (i = 0; i < len; ++i) {
+    size = outputlen;
+    valid[i] = !ge[i].infinity &&
+               secp256k1_eckey_pubkey_serialize(
+                   &ge[i], output + i * outputlen, &size, outputlen == 33);
+    if (!valid[i]) {
+      memset(output + i * outputlen, 0, outputlen);
+    }
+  }
+}
+
+int secp256k1_ext_pubkey_create_batch(const secp256k1_context* ctx,
+                                      unsigned char* output,
+                                      size_t outputlen,
+                                      unsigned char* valid,
+                                      const unsigned char* seckeys,
+                                      size_t n) {
+  secp256k1_gej gej[SECP256K1_EXT_PUBKEY_BATCH];
+  secp256k1_scalar sec;
+  size_t i, j, len;
+  int overflow;
+  int ret = 1;
+
+  VERIFY_CHECK(ctx != NULL);
+  ARG_CHECK(secp256k1_ecmult_gen_context_is_built(&ctx->ecmult_gen_ctx));
+  ARG_CHECK(output != NULL);
+  ARG_CHECK(outputlen == 33 || outputlen == 65);
+  ARG_CHECK(valid != NULL);
+  ARG_CHECK(seckeys != NULL);
+
+  for (i = 0; i < n; i += len) {
+    len = n - i < SECP256K1_EXT_PUBKEY_BATCH ? n - i
+                                             : SECP256K1_EXT_PUBKEY_BATCH;
+
+    // Same checks as in secp256k1_ec_pubkey_create
+    for (j = 0; j < len; ++j) {
+      secp256k1_scalar_set_b32(&sec, seckeys + (i + j) * 32, &overflow);
+      if (overflow || secp256k1_scalar_is_zero(&sec)) {
+        secp256k1_gej_set_infinity(&gej[j]);
+      } else {
+        secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &gej[j], &sec);
+      }
+    }
+    secp256k1_scalar_clear(&sec);
+
+    secp256k1_ext_pubkey_serialize_all(
+        output + i * outputlen, outputlen, valid + i, gej, len);
+    for (j = 0; j < len; ++j) {
+      ret &= valid[i + j];
+    }
+  }
+
+  memset(gej, 0, sizeof(gej));
+  return ret;
+}
+
+int secp256k1_ext_pubkey_create_range(const secp256k1_context* ctx,
+                                      unsigned char* output,
+                                      size_t outputlen,
+                                      unsigned char* valid,
+                                      const unsigned char* seckey,
+                                      size_t n) {
+  secp256k1_gej gej[SECP256K1_EXT_PUBKEY_BATCH];
+  secp256k1_gej cur;
+  secp256k1_scalar sec;
+  size_t i, j, len;
+  int overflow;
+
+  VERIFY_CHECK(ctx != NULL);
+  ARG_CHECK(secp256k1_ecmult_gen_context_is_built(&ctx->ecmult_gen_ctx));
+  ARG_CHECK(output != NULL);
+  ARG_CHECK(outputlen == 33 || outputlen == 65);
+  ARG_CHECK(valid != NULL);
+  ARG_CHECK(seckey != NULL);
+
+  secp256k1_scalar_set_b32(&sec, seckey, &overflow);
+  if (overflow || secp256k1_scalar_is_zero(&sec)) {
+    secp256k1_scalar_clear(&sec);
+    return 0;
+  }
+  secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &cur, &sec);
+  secp256k1_scalar_clear(&sec);
+
+  for (i = 0; i < n; i += len) {
+    len = n - i < SECP256K1_EXT_PUBKEY_BATCH ? n - i
+                                             : SECP256K1_EXT_PUBKEY_BATCH;
+
+    // Constant time addition, handles infinity (seckey + i = order)
+    for (j = 0; j < len; ++j) {
+      gej[j] = cur;
+      secp256k1_gej_add_ge(&cur, &cur, &secp256k1_ge_const_g);
+    }
+
+    secp256k1_ext_pubkey_serialize_all(
+        output + i * outputlen, outputlen, valid + i, gej, len);
+  }
+
+  secp256k1_gej_clear(&cur);
+  memset(gej, 0, sizeof(gej));
+  return 1;
+}
+
+int secp256k1_ext_pubkey_tweak_add_batch(const secp256k1_context* ctx,
+                                         unsigned char* output,
+                                         size_t outputlen,
+                                         unsigned char* valid,
+                                         const secp256k1_pubkey* pubkey,
+                                         const unsigned char* tweaks,
+                                         size_t n) {
+  secp256k1_gej gej[SECP256K1_EXT_PUBKEY_BATCH];
+  secp256k1_scalar term;
+  secp256k1_ge p;
+  size_t i, j, len;
+  int overflow;
+
+  VERIFY_CHECK(ctx != NULL);
+  ARG_CHECK(secp256k1_ecmult_gen_context_is_built(&ctx->ecmult_gen_ctx));
+  ARG_CHECK(output != NULL);
+  ARG_CHECK(outputlen == 33 || outputlen == 65);
+  ARG_CHECK(valid != NULL);
+  ARG_CHECK(pubkey != NULL);
+  ARG_CHECK(tweaks != NULL);
+
+  if (!secp256k1_pubkey_load(ctx, &p, pubkey)) {
+    return 0;
+  }
+
+  for (i = 0; i < n; i += len) {
+    len = n - i < SECP256K1_EXT_PUBKEY_BATCH ? n - i
+                                             : SECP256K1_EXT_PUBKEY_BATCH;
+
+    // tweak * G + P, overflowed tweak gives infinity (invalid). Tweaks can be
+    // derived from secret data (BIP32 chain code), so constant time.
+    for (j = 0; j < len; ++j) {
+      secp256k1_scalar_set_b32(&term, tweaks + (i + j) * 32, &overflow);
+      if (overflow) {
+        secp256k1_gej_set_infinity(&gej[j]);
+      } else {
+        secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &gej[j], &term);
+        secp256k1_gej_add_ge(&gej[j], &gej[j], &p);
+      }
+    }
+    secp256k1_scalar_clear(&term);
+
+    secp256k1_ext_pubkey_serialize_all(
+        output + i * outputlen, outputlen, valid + i, gej, len);
+  }
+
+  memset(gej, 0, sizeof(gej));
+  return 1;
+}
+
+int secp256k1_ext_pubkey_linear_combination(
+    const secp256k1_context* ctx,
+    fcrypto_arena* arena,
+    secp256k1_pubkey* output,
+    const secp256k1_pubkey* pubkeys,
+    const unsigned char* scalars32,
+    const unsigned char* gscalar32,
+    size_t n) {
+  secp256k1_ext_ecmult_multi_data data;
+  secp256k1_scratch* scratch;
+  secp256k1_scalar* scalars;
+  secp256k1_ge* points;
+  secp256k1_scalar gsc;
+  secp256k1_gej rj;
+  secp256k1_ge r;
+  size_t i;
+  int overflow;
+
+  VERIFY_CHECK(ctx != NULL);
+  ARG_CHECK(secp256k1_ecmult_context_is_built(&ctx->ecmult_ctx));
+  ARG_CHECK(arena != NULL);
+  ARG_CHECK(output != NULL);
+  memset(output, 0, sizeof(*output));
+  ARG_CHECK(n == 0 || pubkeys != NULL);
+  ARG_CHECK(n == 0 || scalars32 != NULL);
+
+  secp256k1_scalar_set_int(&gsc, 0);
+  if (gscalar32 != NULL) {
+    secp256k1_scalar_set_b32(&gsc, gscalar32, &overflow);
+    if (overflow) {
+      return 0;
+    }
+  }
+
+  // Arena without region returns NULL for zero size, so at least one item
+  // allocated
+  scalars =
+      fcrypto_arena_alloc(arena, (n > 0 ? n : 1) * sizeof(secp256k1_scalar));
+  points = fcrypto_arena_alloc(arena, (n > 0 ? n : 1) * sizeof(secp256k1_ge));
+  scratch = secp256k1_ext_scratch_alloc(arena, n);
+  if (scalars == NULL || points == NULL || scratch == NULL) {
+    return 0;
+  }
+
+  for (i = 0; i < n; ++i) {
+    secp256k1_scalar_set_b32(&scalars[i], scalars32 + i * 32, &overflow);
+    if (overflow || !secp256k1_pubkey_load(ctx, &points[i], &pubkeys[i])) {
+      return 0;
+    }
+  }
+
+  data.scalars = scalars;
+  data.points = points;
+  if (!secp256k1_ecmult_multi_var(&ctx->error_callback,
+                                  &ctx->ecmult_ctx,
+                                  scratch,
+                                  &rj,
+                                  &gsc,
+                                  secp256k1_ext_ecmult_multi_callback,
+                                  &data,
+                                  n)) {
+    return 0;
+  }
+
+  if (secp256k1_gej_is_infinity(&rj)) {
+    return 0;
+  }
+
+  secp256k1_ge_set_gej_var(&r, &rj);
+  secp256k1_pubkey_save(output, &r);
+  return 1;
+}
+
+// ECDSA
+int secp256k1_ext_ecdsa_verify_batch(
+    const secp256k1_context* ctx,
+    fcrypto_arena* arena,
+    const secp256k1_ecdsa_recoverable_signature* sigs,
+    const unsigned char* const* msgs32,
+    const secp256k1_pubkey* pubkeys,
+    size_t n) {
+  secp256k1_ext_ecmult_multi_data data;
+  secp256k1_scratch* scratch;
+  secp256k1_scalar* scalars;
+  secp256k1_ge* points;
+  secp256k1_scalar gsc;
+  secp256k1_gej rj;
+  secp256k1_sha256 sha;
+  unsigned char seed[32];
+  size_t i;
+
+  VERIFY_CHECK(ctx != NULL);
+  ARG_CHECK(secp256k1_ecmult_context_is_built(&ctx->ecmult_ctx));
+  ARG_CHECK(arena != NULL);
+  if (n == 0) {
+    return 1;
+  }
+  ARG_CHECK(sigs != NULL);
+  ARG_CHECK(msgs32 != NULL);
+  ARG_CHECK(pubkeys != NULL);
+
+  // Randomizers depend from all batch data, so signer can not choose them
+  secp256k1_sha256_initialize(&sha);
+  for (i = 0; i < n; ++i) {
+    secp256k1_sha256_write(&sha, sigs[i].data, sizeof(sigs[i].data));
+    secp256k1_sha256_write(&sha, msgs32[i], 32);
+    secp256k1_sha256_write(&sha, pubkeys[i].data, sizeof(pubkeys[i].data));
+  }
+  secp256k1_sha256_finalize(&sha, seed);
+
+  // Two points for each item: P_i with a_i * u2_i and R_i with -a_i
+  scalars = fcrypto_arena_alloc(arena, 2 * n * sizeof(secp256k1_scalar));
+  points = fcrypto_arena_alloc(arena, 2 * n * sizeof(secp256k1_ge));
+  scratch = secp256k1_ext_scratch_alloc(arena, 2 * n);
+  if (scalars == NULL || points == NULL || scratch == NULL) {
+    return 0;
+  }
+
+  secp256k1_scalar_set_int(&gsc, 0);
+  for (i = 0; i < n; ++i) {
+    secp256k1_scalar r, s, sn, m, u1, u2, a;
+    secp256k1_fe fx;
+    unsigned char brx[32];
+    int recid;
+
+    secp256k1_ecdsa_recoverable_signature_load(ctx, &r, &s, &recid, &sigs[i]);
+    // Same as secp256k1_ecdsa_verify: only lower-S form is accepted
+    if (secp256k1_scalar_is_zero(&r) || secp256k1_scalar_is_zero(&s) ||
+        secp256k1_scalar_is_high(&s)) {
+      return 0;
+    }
+
+    if (!secp256k1_pubkey_load(ctx, &points[2 * i], &pubkeys[i])) {
+      return 0;
+    }
+
+    // Restore R, same as in secp256k1_ecdsa_sig_recover
+    secp256k1_scalar_get_b32(brx, &r);
+    (void)secp256k1_fe_set_b32(&fx, brx);  // r < n < p, so always valid
+    if (recid & 2) {
+      if (secp256k1_fe_cmp_var(&fx, &secp256k1_ecdsa_const_p_minus_order) >=
+          0) {
+        return 0;
+      }
+      secp256k1_fe_add(&fx, &secp256k1_ecdsa_const_order_as_fe);
+    }
+    if (!secp256k1_ge_set_xo_var(&points[2 * i + 1], &fx, recid & 1)) {
+      return 0;
+    }
+
+    // u1 = m / s, u2 = r / s
+    secp256k1_scalar_set_b32(&m, msgs32[i], NULL);
+    secp256k1_scalar_inverse_var(&sn, &s);
+    secp256k1_scalar_mul(&u1, &m, &sn);
+    secp256k1_scalar_mul(&u2, &r, &sn);
+
+    secp256k1_ext_batch_randomizer(&a, seed, i);
+    secp256k1_scalar_mul(&u1, &u1, &a);
+    secp256k1_scalar_add(&gsc, &gsc, &u1);
+    secp256k1_scalar_mul(&scalars[2 * i], &u2, &a);
+    secp256k1_scalar_negate(&scalars[2 * i + 1], &a);
+  }
+
+  data.scalars = scalars;
+  data.points = points;
+  if (!secp256k1_ecmult_multi_var(&ctx->error_callback,
+                                  &ctx->ecmult_ctx,
+                                  scratch,
+                                  &rj,
+                                  &gsc,
+                                  secp256k1_ext_ecmult_multi_callback,
+                                  &data,
+                                  2 * n)) {
+    return 0;
+  }
+
+  return secp256k1_gej_is_infinity(&rj);
+}
+
+// Prepared verifier: for every 8-bit window j of scalar table with
+// i * 2^(8j) * P, i in [1, 255]. So u2 * P is at most 32 additions of affine
+// points without doublings (zero windows skipped).
+#define SECP256K1_EXT_VERIFIER_BITS 8
+#define SECP256K1_EXT_VERIFIER_N (256 / SECP256K1_EXT_VERIFIER_BITS)
+#define SECP256K1_EXT_VERIFIER_G ((1 << SECP256K1_EXT_VERIFIER_BITS) - 1)
+
+struct secp256k1_ext_verifier_struct {
+  secp256k1_ge_storage table[SECP256K1_EXT_VERIFIER_N]
+                            [SECP256K1_EXT_VERIFIER_G];
+};
+
+size_t secp256k1_ext_verifier_size(void) {
+  return sizeof(secp256k1_ext_verifier);
+}
+
+int secp256k1_ext_verifier_build(const secp256k1_context* ctx,
+                                 secp256k1_ext_verifier* verifier,
+                                 const secp256k1_pubkey* pubkey) {
+  secp256k1_gej* row = NULL;
+  secp256k1_ge* rowa = NULL;
+  secp256k1_gej base;
+  secp256k1_ge p;
+  size_t i, j;
+  int ret = 0;
+
+  VERIFY_CHECK(ctx != NULL);
+  ARG_CHECK(verifier != NULL);
+  ARG_CHECK(pubkey != NULL);
+
+  if (!secp256k1_pubkey_load(ctx, &p, pubkey)) {
+    return 0;
+  }
+
+  // One row at time, converted to affine with one inversion
+  row = malloc(SECP256K1_EXT_VERIFIER_G * sizeof(secp256k1_gej));
+  rowa = malloc(SECP256K1_EXT_VERIFIER_G * sizeof(secp256k1_ge));
+  if (row == NULL || rowa == NULL) {
+    goto cleanup;
+  }
+
+  // i * 2^(8j) < n, so there is no infinity in table
+  secp256k1_gej_set_ge(&base, &p);
+  for (j = 0; j < SECP256K1_EXT_VERIFIER_N; ++j) {
+    row[0] = base;
+    for (i = 1; i < SECP256K1_EXT_VERIFIER_G; ++i) {
+      secp256k1_gej_add_var(&row[i], &row[i - 1], &base, NULL);
+    }
+    // 2^8 * base for next window
+    secp256k1_gej_add_var(
+        &base, &base, &row[SECP256K1_EXT_VERIFIER_G - 1], NULL);
+
+    secp256k1_ge_set_all_gej_var(rowa, row, SECP256K1_EXT_VERIFIER_G);
+    for (i = 0; i < SECP256K1_EXT_VERIFIER_G; ++i) {
+      secp256k1_ge_to_storage(&verifier->table[j][i], &rowa[i]);
+    }
+  }
+
+  ret = 1;
+
+cleanup:
+  free(rowa);
+  free(row);
+
+  return ret;
+}
+
+int secp256k1_ext_ecdsa_verify_prepared(
+    const secp256k1_context* ctx,
+    const secp256k1_ext_verifier* verifier,
+    const secp256k1_ecdsa_signature* sig,
+    const unsigned char* msg32) {
+  secp256k1_scalar r, s, sn, m, u1, u2;
+  secp256k1_gej pr;
+  secp256k1_ge a;
+  secp256k1_fe xr;
+  unsigned char c[32];
+  unsigned int bits;
+  size_t j;
+
+  VERIFY_CHECK(ctx != NULL);
+  ARG_CHECK(secp256k1_ecmult_gen_context_is_built(&ctx->ecmult_gen_ctx));
+  ARG_CHECK(verifier != NULL);
+  ARG_CHECK(sig != NULL);
+  ARG_CHECK(msg32 != NULL);
+
+  // Same as secp256k1_ecdsa_verify: only lower-S form is accepted
+  secp256k1_scalar_set_b32(&m, msg32, NULL);
+  secp256k1_ecdsa_signature_load(ctx, &r, &s, sig);
+  if (secp256k1_scalar_is_zero(&r) || secp256k1_scalar_is_zero(&s) ||
+      secp256k1_scalar_is_high(&s)) {
+    return 0;
+  }
+
+  // u1 = m / s, u2 = r / s
+  secp256k1_scalar_inverse_var(&sn, &s);
+  secp256k1_scalar_mul(&u1, &sn, &m);
+  secp256k1_scalar_mul(&u2, &sn, &r);
+
+  // u1 * G from table of ecmult_gen context. Every window of this table
+  // contain additional point, sum of them is zero, so zero windows are not
+  // skipped. Data is public, so lookup is not constant time.
+  secp256k1_gej_set_infinity(&pr);
+  for (j = 0; j < ECMULT_GEN_PREC_N; ++j) {
+    bits = secp256k1_scalar_get_bits(
+        &u1, j * ECMULT_GEN_PREC_B, ECMULT_GEN_PREC_B);
+    secp256k1_ge_from_storage(&a, &(*ctx->ecmult_gen_ctx.prec)[j][bits]);
+    secp256k1_gej_add_ge_var(&pr, &pr, &a, NULL);
+  }
+
+  // u2 * P
+  for (j = 0; j < SECP256K1_EXT_VERIFIER_N; ++j) {
+    bits = secp256k1_scalar_get_bits(&u2,
+                                     j * SECP256K1_EXT_VERIFIER_BITS,
+                                     SECP256K1_EXT_VERIFIER_BITS);
+    if (bits == 0) {
+      continue;
+    }
+    secp256k1_ge_from_storage(&a, &verifier->table[j][bits - 1]);
+    secp256k1_gej_add_ge_var(&pr, &pr, &a, NULL);
+  }
+
+  // Compare x with r (and r + n), same as in secp256k1_ecdsa_sig_verify
+  if (secp256k1_gej_is_infinity(&pr)) {
+    return 0;
+  }
+  secp256k1_scalar_get_b32(c, &r);
+  secp256k1_fe_set_b32(&xr, c);
+  if (secp256k1_gej_eq_x_var(&xr, &pr)) {
+    return 1;
+  }
+  if (secp256k1_fe_cmp_var(&xr, &secp256k1_ecdsa_const_p_minus_order) >= 0) {
+    return 0;
+  }
+  secp256k1_fe_add(&xr, &secp256k1_ecdsa_const_order_as_fe);
+  return secp256k1_gej_eq_x_var(&xr, &pr);
+}
+
+// ECDH
+int secp256k1_ext_ecdh_batch(const secp256k1_context* ctx,
+                             unsigned char* output,
+                             size_t outputlen,
+                             unsigned char* valid,
+                             const secp256k1_pubkey* pubkeys,
+                             const unsigned char* seckey,
+                             size_t n,
+                             secp256k1_ecdh_hash_function hashfp,
+                             void* data) {
+  secp256k1_gej gej[SECP256K1_EXT_PUBKEY_BATCH];
+  secp256k1_ge ge[SECP256K1_EXT_PUBKEY_BATCH];
+  secp256k1_ge pt;
+  secp256k1_scalar s;
+  unsigned char x[32];
+  unsigned char y[32];
+  size_t i, j, len;
+  int overflow;
+
+  VERIFY_CHECK(ctx != NULL);
+  ARG_CHECK(output != NULL);
+  ARG_CHECK(valid != NULL);
+  ARG_CHECK(pubkeys != NULL);
+  ARG_CHECK(seckey != NULL);
+  ARG_CHECK(hashfp != NULL);
+
+  secp256k1_scalar_set_b32(&s, seckey, &overflow);
+  if (overflow || secp256k1_scalar_is_zero(&s)) {
+    secp256k1_scalar_clear(&s);
+    return 0;
+  }
+
+  for (i = 0; i < n; i += len) {
+    len = n - i < SECP256K1_EXT_PUBKEY_BATCH ? n - i
+                                             : SECP256K1_EXT_PUBKEY_BATCH;
+
+    // Same as secp256k1_ecdh, but shared points converted to affine together.
+    // Keys marked by caller as invalid are not loaded and give infinity.
+    for (j = 0; j < len; ++j) {
+      if (valid[i + j] && secp256k1_pubkey_load(ctx, &pt, &pubkeys[i + j])) {
+        secp256k1_ecmult_const(&gej[j], &pt, &s, 256);
+      } else {
+        secp256k1_gej_set_infinity(&gej[j]);
+      }
+    }
+    secp256k1_ext_ge_set_all_gej(ge, gej, len);
+
+    for (j = 0; j < len; ++j) {
+      unsigned char* record = output + (i + j) * outputlen;
+      valid[i + j] = 0;
+      if (!ge[j].infinity) {
+        secp256k1_fe_normalize(&ge[j].x);
+        secp256k1_fe_normalize(&ge[j].y);
+        secp256k1_fe_get_b32(x, &ge[j].x);
+        secp256k1_fe_get_b32(y, &ge[j].y);
+        valid[i + j] = hashfp(record, x, y, data) != 0;
+      }
+      if (!valid[i + j]) {
+        memset(record, 0, outputlen);
+      }
+    }
+  }
+
+  secp256k1_scalar_clear(&s);
+  memset(x, 0, sizeof(x));
+  memset(y, 0, sizeof(y));
+  memset(gej, 0, sizeof(gej));
+  memset(ge, 0, sizeof(ge));
+  return 1;
+}
+
+// Schnorr (BIP340)
+// Tagged hash: sha256(sha256(tag) || sha256(tag) || data), data written by
+// caller after initialization
+static void secp256k1_ext_sha256_tagged(secp256k1_sha256* sha,
+                                        const char* tag,
+                                        size_t taglen) {
+  unsigned char buf[32];
+  secp256k1_sha256_initialize(sha);
+  secp256k1_sha256_write(sha, (const unsigned char*)tag, taglen);
+  secp256k1_sha256_finalize(sha, buf);
+
+  secp256k1_sha256_initialize(sha);
+  secp256k1_sha256_write(sha, buf, 32);
+  secp256k1_sha256_write(sha, buf, 32);
+}
+
+// e = int(hash_BIP0340/challenge(r || x(P) || m)) mod n
+static void secp256k1_ext_schnorr_challenge(secp256k1_scalar* e,
+                                            const unsigned char* rx32,
+                                            const unsigned char* px32,
+                                            const unsigned char* msg32) {
+  secp256k1_sha256 sha;
+  unsigned char buf[32];
+  secp256k1_ext_sha256_tagged(&sha, "BIP0340/challenge", 17);
+  secp256k1_sha256_write(&sha, rx32, 32);
+  secp256k1_sha256_write(&sha, px32, 32);
+  secp256k1_sha256_write(&sha, msg32, 32);
+  secp256k1_sha256_finalize(&sha, buf);
+  secp256k1_scalar_set_b32(e, buf, NULL);
+}
+
+int secp256k1_ext_xonly_pubkey_parse(const secp256k1_context* ctx,
+                                     secp256k1_pubkey* pubkey,
+                                     const unsigned char* input32) {
+  secp256k1_fe x;
+  secp256k1_ge ge;
+
+  VERIFY_CHECK(ctx != NULL);
+  ARG_CHECK(pubkey != NULL);
+  memset(pubkey, 0, sizeof(*pubkey));
+  ARG_CHECK(input32 != NULL);
+
+  // lift_x: point with even y
+  if (!secp256k1_fe_set_b32(&x, input32) ||
+      !secp256k1_ge_set_xo_var(&ge, &x, 0)) {
+    return 0;
+  }
+
+  secp256k1_pubkey_save(pubkey, &ge);
+  return 1;
+}
+
+int secp256k1_ext_schnorr_sign(const secp256k1_context* ctx,
+                               unsigned char* sig64,
+                               const unsigned char* msg32,
+                               const unsigned char* seckey,
+                               const unsigned char* auxrand32) {
+  static const unsigned char zero[32] = {0};
+  secp256k1_sha256 sha;
+  secp256k1_scalar d, k, e;
+  secp256k1_gej rj;
+  secp256k1_ge p, r;
+  unsigned char px[32];
+  unsigned char t[32];
+  unsigned char buf[32];
+  int overflow;
+  int ret = 0;
+  int i;
+
+  VERIFY_CHECK(ctx != NULL);
+  ARG_CHECK(secp256k1_ecmult_gen_context_is_built(&ctx->ecmult_gen_ctx));
+  ARG_CHECK(sig64 != NULL);
+  ARG_CHECK(msg32 != NULL);
+  ARG_CHECK(seckey != NULL);
+
+  secp256k1_scalar_set_b32(&d, seckey, &overflow);
+  if (overflow || secp256k1_scalar_is_zero(&d)) {
+    secp256k1_scalar_clear(&d);
+    memset(sig64, 0, 64);
+    return 0;
+  }
+
+  // d = d' if has_even_y(d'G) else n - d'
+  secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &rj, &d);
+  secp256k1_ge_set_gej(&p, &rj);
+  secp256k1_fe_normalize(&p.x);
+  secp256k1_fe_normalize(&p.y);
+  secp256k1_scalar_cond_negate(&d, secp256k1_fe_is_odd(&p.y));
+  secp256k1_fe_get_b32(px, &p.x);
+
+  // t = bytes(d) xor hash_BIP0340/aux(a), zero aux if not provided
+  secp256k1_ext_sha256_tagged(&sha, "BIP0340/aux", 11);
+  secp256k1_sha256_write(&sha, auxrand32 != NULL ? auxrand32 : zero, 32);
+  secp256k1_sha256_finalize(&sha, t);
+  secp256k1_scalar_get_b32(buf, &d);
+  for (i = 0; i < 32; ++i) t[i] ^= buf[i];
+
+  // k' = int(hash_BIP0340/nonce(t || bytes(P) || m)) mod n
+  secp256k1_ext_sha256_tagged(&sha, "BIP0340/nonce", 13);
+  secp256k1_sha256_write(&sha, t, 32);
+  secp256k1_sha256_write(&sha, px, 32);
+  secp256k1_sha256_write(&sha, msg32, 32);
+  secp256k1_sha256_finalize(&sha, buf);
+  secp256k1_scalar_set_b32(&k, buf, NULL);
+  if (secp256k1_scalar_is_zero(&k)) {
+    memset(sig64, 0, 64);
+    goto cleanup;
+  }
+
+  secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &rj, &k);
+  secp256k1_ge_set_gej(&r, &rj);
+  secp256k1_fe_normalize(&r.x);
+  secp256k1_fe_normalize(&r.y);
+  secp256k1_scalar_cond_negate(&k, secp256k1_fe_is_odd(&r.y));
+  secp256k1_fe_get_b32(sig64, &r.x);
+
+  // s = k + e * d
+  secp256k1_ext_schnorr_challenge(&e, sig64, px, msg32);
+  secp256k1_scalar_mul(&e, &e, &d);
+  secp256k1_scalar_add(&e, &e, &k);
+  secp256k1_scalar_get_b32(sig64 + 32, &e);
+  ret = 1;
+
+cleanup:
+  secp256k1_scalar_clear(&d);
+  secp256k1_scalar_clear(&k);
+  secp256k1_gej_clear(&rj);
+  memset(&r, 0, sizeof(r));
+  memset(t, 0, sizeof(t));
+  memset(buf, 0, sizeof(buf));
+  memset(&sha, 0, sizeof(sha));
+  return ret;
+}
+
+int secp256k1_ext_schnorr_verify(const secp256k1_context* ctx,
+                                 const unsigned char* sig64,
+                                 const unsigned char* msg32,
+                                 const secp256k1_pubkey* pubkey) {
+  secp256k1_scalar s, e;
+  secp256k1_fe rx;
+  secp256k1_ge pk, r;
+  secp256k1_gej pkj, rj;
+  unsigned char px[32];
+  int overflow;
+
+  VERIFY_CHECK(ctx != NULL);
+  ARG_CHECK(secp256k1_ecmult_context_is_built(&ctx->ecmult_ctx));
+  ARG_CHECK(sig64 != NULL);
+  ARG_CHECK(msg32 != NULL);
+  ARG_CHECK(pubkey != NULL);
+
+  if (!secp256k1_fe_set_b32(&rx, sig64)) {
+    return 0;
+  }
+  secp256k1_scalar_set_b32(&s, sig64 + 32, &overflow);
+  if (overflow || !secp256k1_pubkey_load(ctx, &pk, pubkey)) {
+    return 0;
+  }
+
+  // R = s * G - e * P
+  secp256k1_fe_normalize_var(&pk.x);
+  secp256k1_fe_get_b32(px, &pk.x);
+  secp256k1_ext_schnorr_challenge(&e, sig64, px, msg32);
+  secp256k1_scalar_negate(&e, &e);
+  secp256k1_gej_set_ge(&pkj, &pk);
+  secp256k1_ecmult(&ctx->ecmult_ctx, &rj, &pkj, &e, &s);
+  if (secp256k1_gej_is_infinity(&rj)) {
+    return 0;
+  }
+
+  secp256k1_ge_set_gej_var(&r, &rj);
+  secp256k1_fe_normalize_var(&r.y);
+  return !secp256k1_fe_is_odd(&r.y) && secp256k1_fe_equal_var(&rx, &r.x);
+}
+
+int secp256k1_ext_schnorr_verify_batch(const secp256k1_context* ctx,
+                                       fcrypto_arena* arena,
+                                       const unsigned char* const* sigs64,
+                                       const unsigned char* const* msgs32,
+                                       const secp256k1_pubkey* pubkeys,
+                                       size_t n) {
+  secp256k1_ext_ecmult_multi_data data;
+  secp256k1_scratch* scratch;
+  secp256k1_scalar* scalars;
+  secp256k1_ge* points;
+  secp256k1_scalar gsc;
+  secp256k1_gej rj;
+  secp256k1_sha256 sha;
+  unsigned char seed[32];
+  size_t i;
+
+  VERIFY_CHECK(ctx != NULL);
+  ARG_CHECK(secp256k1_ecmult_context_is_built(&ctx->ecmult_ctx));
+  ARG_CHECK(arena != NULL);
+  if (n == 0) {
+    return 1;
+  }
+  ARG_CHECK(sigs64 != NULL);
+  ARG_CHECK(msgs32 != NULL);
+  ARG_CHECK(pubkeys != NULL);
+
+  // Randomizers depend from all batch data, same as in ECDSA batch
+  secp256k1_sha256_initialize(&sha);
+  for (i = 0; i < n; ++i) {
+    secp256k1_sha256_write(&sha, sigs64[i], 64);
+    secp256k1_sha256_write(&sha, msgs32[i], 32);
+    secp256k1_sha256_write(&sha, pubkeys[i].data, sizeof(pubkeys[i].data));
+  }
+  secp256k1_sha256_finalize(&sha, seed);
+
+  // Two points for each item: P_i with -a_i * e_i and R_i with -a_i
+  scalars = fcrypto_arena_alloc(arena, 2 * n * sizeof(secp256k1_scalar));
+  points = fcrypto_arena_alloc(arena, 2 * n * sizeof(secp256k1_ge));
+  scratch = secp256k1_ext_scratch_alloc(arena, 2 * n);
+  if (scalars == NULL || points == NULL || scratch == NULL) {
+    return 0;
+  }
+
+  secp256k1_scalar_set_int(&gsc, 0);
+  for (i = 0; i < n; ++i) {
+    secp256k1_scalar s, e, a;
+    secp256k1_fe rx;
+    unsigned char px[32];
+    int overflow;
+
+    if (!secp256k1_fe_set_b32(&rx, sigs64[i]) ||
+        !secp256k1_ge_set_xo_var(&points[2 * i + 1], &rx, 0)) {
+      return 0;
+    }
+    secp256k1_scalar_set_b32(&s, sigs64[i] + 32, &overflow);
+    if (overflow || !secp256k1_pubkey_load(ctx, &points[2 * i], &pubkeys[i])) {
+      return 0;
+    }
+
+    secp256k1_fe_normalize_var(&points[2 * i].x);
+    secp256k1_fe_get_b32(px, &points[2 * i].x);
+    secp256k1_ext_schnorr_challenge(&e, sigs64[i], px, msgs32[i]);
+
+    secp256k1_ext_batch_randomizer(&a, seed, i);
+    secp256k1_scalar_mul(&s, &s, &a);
+    secp256k1_scalar_add(&gsc, &gsc, &s);
+    secp256k1_scalar_mul(&e, &e, &a);
+    secp256k1_scalar_negate(&scalars[2 * i], &e);
+    secp256k1_scalar_negate(&scalars[2 * i + 1], &a);
+  }
+
+  data.scalars = scalars;
+  data.points = points;
+  if (!secp256k1_ecmult_multi_var(&ctx->error_callback,
+                                  &ctx->ecmult_ctx,
+                                  scratch,
+                                  &rj,
+                                  &gsc,
+                                  secp256k1_ext_ecmult_multi_callback,
+                                  &data,
+                                  2 * n)) {
+    return 0;
+  }
+
+  return secp256k1_gej_is_infinity(&rj);
+}
@@ -0,0 +1,232 @@
+#ifndef FCRYPTO_SECP256K1_EXT
+#define FCRYPTO_SECP256K1_EXT
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <fcrypto/arena.h>
+#include <secp256k1/include/secp256k1.h>
+#include <secp256k1/include/secp256k1_ecdh.h>
+#include <secp256k1/include/secp256k1_recovery.h>
+
+// Extensions which require libsecp256k1 internals (field, group, ecmult).
+// Functions follow libsecp256k1 conventions: 1 on success, 0 on failure.
+
+/** Parameters of precomputed tables which library was compiled with: bits
+ *  per window of generator table (ecmult_gen) and window size of generator
+ *  table for verification (ecmult).
+ */
+int secp256k1_ext_ecmult_gen_prec_bits(void);
+int secp256k1_ext_ecmult_window_size(void);
+
+/** Returns 1 if precomputed tables are generated on build and linked as
+ *  read-only data (FCRYPTO_ECMULT_STATIC_PRECOMPUTATION), otherwise 0.
+ */
+int secp256k1_ext_static_tables(void);
+
+/** Create context for signing and verification. With static tables only
+ *  blinding is allocated, so size is small and creation is fast.
+ *  Returns: context, or NULL if there is not enough memory
+ */
+size_t secp256k1_ext_context_size(void);
+secp256k1_context* secp256k1_ext_context_create(void);
+
+/** Copy context without precomputed tables: clone has own blinding for
+ *  randomization, but points to tables of original context, so original
+ *  should not be destroyed before all clones.
+ *  Returns: clone, or NULL if there is not enough memory
+ */
+size_t secp256k1_ext_context_shallow_size(void);
+secp256k1_context* secp256k1_ext_context_shallow_clone(
+    const secp256k1_context* ctx);
+void secp256k1_ext_context_shallow_destroy(secp256k1_context* ctx);
+
+/** Compute serialized public keys (outputlen 33 or 65) for n secret keys,
+ *  each 32 bytes. All generator multiplications of group are done first,
+ *  then points converted to affine with one field inversion per group of 64.
+ *  valid[i] is 1 if secret key is valid, otherwise 0 (and output zeroed).
+ *  Returns: 1: all secret keys are valid
+ *           0: at least one secret key is invalid
+ */
+int secp256k1_ext_pubkey_create_batch(const secp256k1_context* ctx,
+                                      unsigned char* output,
+                                      size_t outputlen,
+                                      unsigned char* valid,
+                                      const unsigned char* seckeys,
+                                      size_t n);
+
+/** Compute serialized public keys for secret keys seckey, seckey + 1, ...,
+ *  seckey + n - 1 (modulo group order) with one generator multiplication and
+ *  addition of G for every next key. Affine conversion same as in
+ *  secp256k1_ext_pubkey_create_batch. valid[i] is 0 only if seckey + i is
+ *  zero modulo order.
+ *  Returns: 1: seckey is valid
+ *           0: seckey is invalid, nothing computed
+ */
+int secp256k1_ext_pubkey_create_range(const secp256k1_context* ctx,
+                                      unsigned char* output,
+                                      size_t outputlen,
+                                      unsigned char* valid,
+                                      const unsigned char* seckey,
+                                      size_t n);
+
+/** Compute serialized public keys pubkey + tweak_i * G for n tweaks, each
+ *  32 bytes, with same affine conversion as in
+ *  secp256k1_ext_pubkey_create_batch. valid[i] is 0 if tweak is out of range
+ *  or result is infinity.
+ *  Returns: 1: public key is valid
+ *           0: public key is invalid, nothing computed
+ */
+int secp256k1_ext_pubkey_tweak_add_batch(const secp256k1_context* ctx,
+                                         unsigned char* output,
+                                         size_t outputlen,
+                                         unsigned char* valid,
+                                         const secp256k1_pubkey* pubkey,
+                                         const unsigned char* tweaks,
+                                         size_t n);
+
+/** Size of scratch space for multi-scalar multiplication of n points in one
+ *  batch: Strauss below ECMULT_PIPPENGER_THRESHOLD points, Pippenger above.
+ *  Limited by SECP256K1_EXT_SCRATCH_MAX, bigger multiplications are split to
+ *  batches by ecmult_multi.
+ */
+#define SECP256K1_EXT_SCRATCH_MAX (1024 * 1024)
+size_t secp256k1_ext_scratch_size(size_t n);
+
+/** Compute gscalar * G + sum(scalars_i * P_i) with one multi-scalar
+ *  multiplication (Strauss or Pippenger, selected by libsecp256k1 from n and
+ *  size of scratch space). Scalars are 32-byte big-endian, gscalar is
+ *  optional (NULL is zero). Computation is not constant time, scalars should
+ *  not be secret.
+ *  Points, scalars and scratch space are allocated from arena, memory is
+ *  released by caller with fcrypto_arena_reset.
+ *  Returns: 1: result is valid public key
+ *           0: one of scalars overflow, one of public keys is invalid, result
+ * is infinity, or there is not enough memory
+ */
+int secp256k1_ext_pubkey_linear_combination(
+    const secp256k1_context* ctx,
+    fcrypto_arena* arena,
+    secp256k1_pubkey* output,
+    const secp256k1_pubkey* pubkeys,
+    const unsigned char* scalars32,
+    const unsigned char* gscalar32,
+    size_t n);
+
+/** Verify a batch of recoverable ECDSA signatures with one multi-scalar
+ *  multiplication.
+ *  Recovery id is required for restoring nonce point R from r, after that
+ *  all items checked with one random linear combination:
+ *  sum(a_i * (u1_i * G + u2_i * P_i - R_i)) == infinity
+ *  Points, scalars and scratch space are allocated from arena, memory is
+ *  released by caller with fcrypto_arena_reset.
+ *  Returns: 1: all signatures are correct
+ *           0: at least one signature is incorrect, one of recovery ids is
+ * wrong, or there is not enough memory (check items one by one)
+ */
+int secp256k1_ext_ecdsa_verify_batch(
+    const secp256k1_context* ctx,
+    fcrypto_arena* arena,
+    const secp256k1_ecdsa_recoverable_signature* sigs,
+    const unsigned char* const* msgs32,
+    const secp256k1_pubkey* pubkeys,
+    size_t n);
+
+/** Opaque data structure with precomputed multiples of a public key. */
+typedef struct secp256k1_ext_verifier_struct secp256k1_ext_verifier;
+
+/** Size of secp256k1_ext_verifier in bytes, memory allocated by caller. */
+size_t secp256k1_ext_verifier_size(void);
+
+/** Precompute table of multiples for public key.
+ *  Returns: 1: table computed
+ *           0: public key is invalid, or there is not enough memory for
+ * temporary data
+ */
+int secp256k1_ext_verifier_build(const secp256k1_context* ctx,
+                                 secp256k1_ext_verifier* verifier,
+                                 const secp256k1_pubkey* pubkey);
+
+/** Verify an ECDSA signature with prepared verifier.
+ *  u1 * G taken from ecmult_gen context table, u2 * P from verifier table,
+ *  so no doublings required. Result is same as in secp256k1_ecdsa_verify.
+ *  Returns: 1: correct signature
+ *           0: incorrect or unparseable signature
+ */
+int secp256k1_ext_ecdsa_verify_prepared(
+    const secp256k1_context* ctx,
+    const secp256k1_ext_verifier* verifier,
+    const secp256k1_ecdsa_signature* sig,
+    const unsigned char* msg32);
+
+/** Compute ECDH for one secret key and n public keys, hashfp called for each
+ *  shared point as in secp256k1_ecdh and writes outputlen bytes. Points
+ *  converted to affine in groups with one constant time field inversion,
+ *  see secp256k1_ext_pubkey_create_batch.
+ *  valid[i] on input: 0 if pubkeys[i] should be skipped (could not be
+ *  parsed). On output: 1 if secret computed, otherwise record zeroed.
+ *  Returns: 1: secret key is valid
+ *           0: secret key is invalid (zero or overflow), nothing computed
+ */
+int secp256k1_ext_ecdh_batch(const secp256k1_context* ctx,
+                             unsigned char* output,
+                             size_t outputlen,
+                             unsigned char* valid,
+                             const secp256k1_pubkey* pubkeys,
+                             const unsigned char* seckey,
+                             size_t n,
+                             secp256k1_ecdh_hash_function hashfp,
+                             void* data);
+
+/** Parse x-only public key (BIP340): point with given x and even y.
+ *  Returns: 1: public key parsed
+ *           0: x is not in field or not on curve
+ */
+int secp256k1_ext_xonly_pubkey_parse(const secp256k1_context* ctx,
+                                     secp256k1_pubkey* pubkey,
+                                     const unsigned char* input32);
+
+/** Create a BIP340 Schnorr signature. Nonce derived as in BIP340 from
+ *  secret key, message and auxiliary random data (NULL is 32 zero bytes).
+ *  Returns: 1: signature created
+ *           0: secret key is invalid (or nonce is zero), signature zeroed
+ */
+int secp256k1_ext_schnorr_sign(const secp256k1_context* ctx,
+                               unsigned char* sig64,
+                               const unsigned char* msg32,
+                               const unsigned char* seckey,
+                               const unsigned char* auxrand32);
+
+/** Verify a BIP340 Schnorr signature, public key is x-only (see
+ *  secp256k1_ext_xonly_pubkey_parse).
+ *  Returns: 1: correct signature
+ *           0: incorrect signature
+ */
+int secp256k1_ext_schnorr_verify(const secp256k1_context* ctx,
+                                 const unsigned char* sig64,
+                                 const unsigned char* msg32,
+                                 const secp256k1_pubkey* pubkey);
+
+/** Verify a batch of BIP340 Schnorr signatures with one multi-scalar
+ *  multiplication, R_i restored from x directly (even y), so unlike ECDSA
+ *  nothing except signature is required:
+ *  sum(a_i * s_i) * G - sum(a_i * R_i) - sum(a_i * e_i * P_i) == infinity
+ *  Points, scalars and scratch space are allocated from arena, memory is
+ *  released by caller with fcrypto_arena_reset.
+ *  Returns: 1: all signatures are correct
+ *           0: at least one signature is incorrect, or there is not enough
+ * memory (check items one by one)
+ */
+int secp256k1_ext_schnorr_verify_batch(const secp256k1_context* ctx,
+                                       fcrypto_arena* arena,
+                                       const unsigned char* const* sigs64,
+                                       const unsigned char* const* msgs32,
+                                       const secp256k1_pubkey* pubkeys,
+                                       size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // FCRYPTO_SECP256K1_EXT
@@ -1,7 +1,8 @@
 const test = require('tape')
-const { randomBytes } = require('crypto')
+const { createHash, randomBytes } = require('crypto')
 const fcrypto = require('../')
 const { getAvailableTypes } = require('./util')
+const { ECDSAVerifyStream } = require('../lib/verify-stream')
 
 function createTests (type) {
   const prefix = `${type}.secp256k1`
@@ -29,6 +30,38 @@ function createTests (type) {
       t.end()
     })
 
+    t.test(`${prefix}.init with shared context`, async (t) => {
+      const instances = []
+      for (let i = 0; i < 4; ++i) {
+        const other = (await fcrypto.load(type)).secp256k1
+        other.init()
+        other.contextRandomize(randomBytes(32))
+        instances.push(other)
+      }
+
+      const seckey = Buffer.alloc(32, 0x01)
+      const msg32 = Buffer.alloc(32, 0x02)
+      const expected = secp256k1.ecdsaSign(msg32, seckey)
+      for (const other of instances) {
+        t.same(other.ecdsaSign(msg32, seckey), expected)
+        t.same(other.publicKeyCreate(seckey), secp256k1.publicKeyCreate(seckey))
+      }
+
+      t.end()
+    })
+
+    // buildInfo
+    t.test(`${prefix}.buildInfo`, (t) => {
+      const info = secp256k1.buildInfo()
+      t.true([2, 4, 8].includes(info.ecmultGenPrecBits))
+      t.true(info.ecmultWindowSize >= 2 && info.ecmultWindowSize <= 24)
+      t.true(info.contextSize > 0)
+      t.equal(typeof info.staticTables, 'boolean')
+      t.equal(typeof info.variant, 'string')
+
+      t.end()
+    })
+
     // contextRandomize
     t.test(`${prefix}.contextRandomize with invalid seed`, (t) => {
       t.throws(() => {
@@ -540,6 +573,120 @@ function createTests (type) {
       t.end()
     })
 
+    // publicKeyLinearCombination
+    t.test(`${prefix}.publicKeyLinearCombination with invalid args`, (t) => {
+      const pubkey = Buffer.alloc(33, 0x02)
+      const scalar = Buffer.alloc(32, 0x01)
+
+      t.throws(() => {
+        secp256k1.publicKeyLinearCombination(null, [])
+      }, /^Error: Expected public keys to be an Array$/)
+
+      t.throws(() => {
+        secp256k1.publicKeyLinearCombination([pubkey], null)
+      }, /^Error: Expected scalars to be an Array$/)
+
+      t.throws(() => {
+        secp256k1.publicKeyLinearCombination([pubkey], [])
+      }, /^Error: Expected same number of public keys and scalars$/)
+
+      t.throws(() => {
+        secp256k1.publicKeyLinearCombination([pubkey], [new Uint8Array(42)])
+      }, /^Error: Expected scalar to be Uint8Array with length 32$/)
+
+      t.throws(() => {
+        secp256k1.publicKeyLinearCombination([pubkey], [scalar], null, true, {})
+      }, /^Error: Expected output to be Uint8Array$/)
+
+      t.throws(() => {
+        secp256k1.publicKeyLinearCombination([pubkey], [scalar], scalar)
+      }, /^Error: Public Key could not be parsed$/)
+
+      t.end()
+    })
+
+    t.test(`${prefix}.publicKeyLinearCombination fixtures`, (t) => {
+      const g = Buffer.from(
+        '0279be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798',
+        'hex'
+      )
+      const scalar = (x) => Buffer.from(x.toString(16).padStart(64, '0'), 'hex')
+      const p5 =
+        '022f8bde4d1a07209355b4a7250a5c5128e88b84bddc619ab7cba8d569b240efe4'
+
+      // 2 * G + 3 * G, with and without generator scalar
+      let r = secp256k1.publicKeyLinearCombination(
+        [g],
+        [scalar(2)],
+        scalar(3),
+        true,
+        Buffer.alloc
+      )
+      t.same(r.toString('hex'), p5)
+      r = secp256k1.publicKeyLinearCombination(
+        [g, g],
+        [scalar(2), scalar(3)],
+        null,
+        true,
+        Buffer.alloc
+      )
+      t.same(r.toString('hex'), p5)
+      r = secp256k1.publicKeyLinearCombination([], [], scalar(5))
+      t.same(Buffer.from(r).toString('hex'), p5)
+
+      // (n - 1) * G + G is infinity
+      const nm1 = Buffer.from(
+        'fffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364140',
+        'hex'
+      )
+      t.throws(() => {
+        secp256k1.publicKeyLinearCombination([g], [nm1], scalar(1))
+      }, /^Error: One of the scalars was out of range or the combination is not valid$/)
+      t.throws(() => {
+        secp256k1.publicKeyLinearCombination([g], [Buffer.alloc(32, 0xff)])
+      }, /^Error: One of the scalars was out of range or the combination is not valid$/)
+
+      t.end()
+    })
+
+    t.test(`${prefix}.publicKeyLinearCombination vs naive`, (t) => {
+      for (const n of [1, 2, 16, 100]) {
+        const pubkeys = []
+        const scalars = []
+        while (pubkeys.length < n) {
+          const seckey = randomBytes(32)
+          const tweak = randomBytes(32)
+          if (!secp256k1.privateKeyVerify(seckey)) continue
+          if (!secp256k1.privateKeyVerify(tweak)) continue
+
+          pubkeys.push(secp256k1.publicKeyCreate(seckey, false, Buffer.alloc))
+          scalars.push(tweak)
+        }
+        const gScalar = randomBytes(32)
+        if (!secp256k1.privateKeyVerify(gScalar)) continue
+
+        const terms = pubkeys.map((pubkey, i) => {
+          return secp256k1.publicKeyTweakMul(pubkey, scalars[i])
+        })
+        terms.push(secp256k1.publicKeyCreate(gScalar))
+        const expected = secp256k1.publicKeyCombine(terms, false, Buffer.alloc)
+
+        const parsed = pubkeys.map((pubkey) => secp256k1.publicKeyParse(pubkey))
+        for (const keys of [pubkeys, parsed]) {
+          const r = secp256k1.publicKeyLinearCombination(
+            keys,
+            scalars,
+            gScalar,
+            false,
+            Buffer.alloc
+          )
+          t.same(r.toString('hex'), expected.toString('hex'))
+        }
+      }
+
+      t.end()
+    })
+
     // publicKeyTweakAdd
     t.test(`${prefix}.publicKeyTweakAdd with invalid public key`, (t) => {
       t.throws(() => {
@@ -701,9 +848,9 @@ function createTests (type) {
           tweak:
             '0000000000000000000000000000000000000000000000000000000000000042',
           pubkey33:
-            '02290798c2b6476830da12fe02287e9e777aa3fba1c355b17a722d362f84614fba',
+            '02124c5c798edff99abd3f3a5182745060baa045e73dab0980889c71e4fb8e3f52',
           pubkey65:
-            '04290798c2b6476830da12fe02287e9e777aa3fba1c355b17a722d362f84614fbae38da76dcd440621988d00bcf79af25d5b29c094db2a23146d003afd41943e7a',
+            '04124c5c798edff99abd3f3a5182745060baa045e73dab0980889c71e4fb8e3f5220b4ed416a1e7b44196f7a095efe39a4a4ef96c02053dda571c1ba44202261c4',
         },
       ]
 
@@ -720,6 +867,28 @@ function createTests (type) {
       t.end()
     })
 
+    // Regression: publicKeyTweakMul was calling tweakAdd of instance
+    t.test(`${prefix}.publicKeyTweakMul same as privateKeyTweakMul`, (t) => {
+      const { alloc } = Buffer
+      for (let i = 0; i < 10; ++i) {
+        const seckey = randomBytes(32)
+        const tweak = randomBytes(32)
+        if (!secp256k1.privateKeyVerify(seckey)) continue
+        if (!secp256k1.privateKeyVerify(tweak)) continue
+
+        const pubkey = secp256k1.publicKeyCreate(seckey, true, alloc)
+        const product = secp256k1.privateKeyTweakMul(alloc(32, seckey), tweak)
+        const expected = secp256k1.publicKeyCreate(product, true, alloc)
+
+        const r33 = secp256k1.publicKeyTweakMul(pubkey, tweak, true, alloc)
+        t.same(r33, expected)
+        const sum = secp256k1.publicKeyTweakAdd(pubkey, tweak, true, alloc)
+        t.notSame(sum, expected)
+      }
+
+      t.end()
+    })
+
     // signatureNormalize
     t.test(`${prefix}.signatureNormalize with invalid signature`, (t) => {
       t.throws(() => {
@@ -1031,6 +1200,55 @@ function createTests (type) {
       t.end()
     })
 
+    // ecdsaVerifyBatch
+    t.test(`${prefix}.ecdsaVerifyBatch with invalid arguments`, (t) => {
+      t.throws(() => {
+        secp256k1.ecdsaVerifyBatch(null, [], [])
+      }, /^Error: Expected signatures to be an Array$/)
+
+      t.throws(() => {
+        secp256k1.ecdsaVerifyBatch([], [], [new Uint8Array(33)])
+      }, /^Error: Expected signatures, messages and public keys with same length$/)
+
+      t.throws(() => {
+        const sig = { signature: new Uint8Array(64), recid: 5 }
+        const pubkey = new Uint8Array(33)
+        secp256k1.ecdsaVerifyBatch([sig], [new Uint8Array(32)], [pubkey])
+      }, /^Error: Expected recovery id to be a Number within interval \[0, 3]$/)
+
+      t.end()
+    })
+
+    t.test(`${prefix}.ecdsaVerifyBatch with fixtures`, (t) => {
+      const items = []
+      for (let i = 1; i <= 32; ++i) {
+        const seckey = Buffer.alloc(32, i)
+        const msg32 = Buffer.alloc(32, 255 - i)
+        items.push({
+          sig: secp256k1.ecdsaSign(msg32, seckey, Buffer.alloc),
+          msg32,
+          pubkey: secp256k1.publicKeyCreate(seckey, i % 2 === 0, Buffer.alloc),
+        })
+      }
+
+      const sigs = items.map((item) => item.sig)
+      const msgs = items.map((item) => item.msg32)
+      const pubkeys = items.map((item) => item.pubkey)
+      const expected = items.map(() => true)
+      t.same(secp256k1.ecdsaVerifyBatch([], [], []), [])
+      t.same(secp256k1.ecdsaVerifyBatch(sigs, msgs, pubkeys), expected)
+
+      // wrong recovery id should not affect result
+      sigs[3] = { signature: sigs[3].signature, recid: sigs[3].recid ^ 1 }
+      t.same(secp256k1.ecdsaVerifyBatch(sigs, msgs, pubkeys), expected)
+
+      msgs[7] = Buffer.alloc(32, 0)
+      expected[7] = false
+      t.same(secp256k1.ecdsaVerifyBatch(sigs, msgs, pubkeys), expected)
+
+      t.end()
+    })
+
     // ecdsaRecover
     t.test(`${prefix}.ecdsaRecover with invalid signature`, (t) => {
       t.throws(() => {
@@ -1141,6 +1359,191 @@ function createTests (type) {
       t.end()
     })
 
+    // Schnorr (BIP340)
+    const bip340Vectors = [
+      {
+        seckey:
+          '0000000000000000000000000000000000000000000000000000000000000003',
+        pubkey:
+          'f9308a019258c31049344f85f89d5229b531c845836f99b08601f113bce036f9',
+        auxRand:
+          '0000000000000000000000000000000000000000000000000000000000000000',
+        msg32:
+          '0000000000000000000000000000000000000000000000000000000000000000',
+        sig:
+          'e907831f80848d1069a5371b402410364bdf1c5f8307b0084c55f1ce2dca821525f66a4a85ea8b71e482a74f382d2ce5ebeee8fdb2172f477df4900d310536c0',
+      },
+      {
+        seckey:
+          'b7e151628aed2a6abf7158809cf4f3c762e7160f38b4da56a784d9045190cfef',
+        pubkey:
+          'dff1d77f2a671c5f36183726db2341be58feae1da2deced843240f7b502ba659',
+        auxRand:
+          '0000000000000000000000000000000000000000000000000000000000000001',
+        msg32:
+          '243f6a8885a308d313198a2e03707344a4093822299f31d0082efa98ec4e6c89',
+        sig:
+          '6896bd60eeae296db48a229ff71dfe071bde413e6d43f917dc8dcf8c78de33418906d11ac976abccb20b091292bff4ea897efcb639ea871cfa95f6de339e4b0a',
+      },
+    ].map((vector) => {
+      const obj = {}
+      for (const key of Object.keys(vector)) {
+        obj[key] = Buffer.from(vector[key], 'hex')
+      }
+      return obj
+    })
+
+    t.test(`${prefix}.xOnlyPublicKeyCreate`, (t) => {
+      t.throws(() => {
+        secp256k1.xOnlyPublicKeyCreate(new Uint8Array(42))
+      }, /^Error: Expected private key to be Uint8Array with length 32$/)
+
+      t.throws(() => {
+        secp256k1.xOnlyPublicKeyCreate(new Uint8Array(32))
+      }, /^Error: Private Key is invalid$/)
+
+      for (const { seckey, pubkey } of bip340Vectors) {
+        const r = secp256k1.xOnlyPublicKeyCreate(seckey, Buffer.alloc)
+        t.same(r.toString('hex'), pubkey.toString('hex'))
+
+        const full = secp256k1.publicKeyCreate(seckey, false)
+        const parsed = secp256k1.publicKeyParse(full)
+        for (const key of [full, parsed]) {
+          const x = secp256k1.xOnlyPublicKeyConvert(key, Buffer.alloc)
+          t.same(x.toString('hex'), pubkey.toString('hex'))
+        }
+      }
+
+      t.end()
+    })
+
+    t.test(`${prefix}.schnorrSign with invalid arguments`, (t) => {
+      t.throws(() => {
+        secp256k1.schnorrSign(new Uint8Array(42))
+      }, /^Error: Expected message to be Uint8Array with length 32$/)
+
+      t.throws(() => {
+        secp256k1.schnorrSign(new Uint8Array(32), new Uint8Array(42))
+      }, /^Error: Expected private key to be Uint8Array with length 32$/)
+
+      t.throws(() => {
+        const msg32 = new Uint8Array(32)
+        secp256k1.schnorrSign(msg32, msg32, new Uint8Array(42))
+      }, /^Error: Expected auxRand to be Uint8Array with length 32$/)
+
+      t.throws(() => {
+        const msg32 = new Uint8Array(32)
+        secp256k1.schnorrSign(msg32, new Uint8Array(32).fill(0xff))
+      }, /^Error: Private Key is invalid$/)
+
+      t.end()
+    })
+
+    t.test(`${prefix}.schnorrSign / schnorrVerify BIP340 vectors`, (t) => {
+      for (const { seckey, pubkey, auxRand, msg32, sig } of bip340Vectors) {
+        const r = secp256k1.schnorrSign(msg32, seckey, auxRand, Buffer.alloc)
+        t.same(r.toString('hex'), sig.toString('hex'))
+        t.true(secp256k1.schnorrVerify(sig, msg32, pubkey))
+
+        // Zero auxiliary data is same as null
+        if (auxRand.every((x) => x === 0)) {
+          const r2 = secp256k1.schnorrSign(msg32, seckey, null, Buffer.alloc)
+          t.same(r2.toString('hex'), sig.toString('hex'))
+        }
+
+        const bad = Buffer.from(sig)
+        bad[63] ^= 0x01
+        t.false(secp256k1.schnorrVerify(bad, msg32, pubkey))
+        t.false(secp256k1.schnorrVerify(sig, Buffer.alloc(32, 0x01), pubkey))
+
+        // s >= n, r >= p
+        const high = Buffer.concat([sig.slice(0, 32), Buffer.alloc(32, 0xff)])
+        t.false(secp256k1.schnorrVerify(high, msg32, pubkey))
+        const rhigh = Buffer.concat([Buffer.alloc(32, 0xff), sig.slice(32)])
+        t.false(secp256k1.schnorrVerify(rhigh, msg32, pubkey))
+      }
+
+      // Public key not on the curve
+      const pubkey = Buffer.from(
+        'eefdea4cdb677750a420fee807eacf21eb9898ae79b9768766e4faa04a2d4a34',
+        'hex'
+      )
+      t.throws(() => {
+        const { sig, msg32 } = bip340Vectors[1]
+        secp256k1.schnorrVerify(sig, msg32, pubkey)
+      }, /^Error: Public Key could not be parsed$/)
+
+      t.end()
+    })
+
+    t.test(`${prefix}.schnorrSign / schnorrVerify random`, (t) => {
+      for (let i = 0; i < 16; ++i) {
+        const seckey = randomBytes(32)
+        if (!secp256k1.privateKeyVerify(seckey)) continue
+
+        const msg32 = randomBytes(32)
+        const sig = secp256k1.schnorrSign(msg32, seckey, randomBytes(32))
+        const pubkey = secp256k1.xOnlyPublicKeyCreate(seckey)
+        t.true(secp256k1.schnorrVerify(sig, msg32, pubkey))
+      }
+
+      t.end()
+    })
+
+    t.test(`${prefix}.schnorrVerifyBatch with invalid arguments`, (t) => {
+      t.throws(() => {
+        secp256k1.schnorrVerifyBatch(null, [], [])
+      }, /^Error: Expected signatures to be an Array$/)
+
+      t.throws(() => {
+        secp256k1.schnorrVerifyBatch([], [], [new Uint8Array(32)])
+      }, /^Error: Expected signatures, messages and public keys with same length$/)
+
+      t.throws(() => {
+        secp256k1.schnorrVerifyBatch([], [], [], -1)
+      }, /^Error: Expected batch size to be a non-negative integer$/)
+
+      t.throws(() => {
+        const sig = new Uint8Array(64)
+        const msg32 = new Uint8Array(32)
+        secp256k1.schnorrVerifyBatch([sig], [msg32], [new Uint8Array(33)])
+      }, /^Error: Expected public key to be Uint8Array with length 32$/)
+
+      t.end()
+    })
+
+    t.test(`${prefix}.schnorrVerifyBatch with fixtures`, (t) => {
+      const sigs = []
+      const msgs = []
+      const pubkeys = []
+      for (let i = 1; i <= 40; ++i) {
+        const seckey = Buffer.alloc(32, i)
+        const msg32 = Buffer.alloc(32, 255 - i)
+        sigs.push(secp256k1.schnorrSign(msg32, seckey, null, Buffer.alloc))
+        msgs.push(msg32)
+        pubkeys.push(secp256k1.xOnlyPublicKeyCreate(seckey, Buffer.alloc))
+      }
+
+      const expected = sigs.map(() => true)
+      t.same(secp256k1.schnorrVerifyBatch([], [], []), [])
+      for (const batchSize of [0, 1, 7, 64]) {
+        const r = secp256k1.schnorrVerifyBatch(sigs, msgs, pubkeys, batchSize)
+        t.same(r, expected)
+      }
+
+      msgs[7] = Buffer.alloc(32, 0)
+      expected[7] = false
+      sigs[30] = Buffer.from(sigs[30])
+      sigs[30][40] ^= 0x80
+      expected[30] = false
+      for (const batchSize of [0, 1, 7, 64]) {
+        const r = secp256k1.schnorrVerifyBatch(sigs, msgs, pubkeys, batchSize)
+        t.same(r, expected)
+      }
+
+      t.end()
+    })
+
     // ecdh
     t.test(`${prefix}.ecdh with invalid public key`, (t) => {
       t.throws(() => {
@@ -1229,6 +1632,1033 @@ function createTests (type) {
       t.end()
     })
 
+    t.test(`${prefix}.ecdh with output modes`, (t) => {
+      t.throws(() => {
+        const pubkey = secp256k1.publicKeyCreate(Buffer.alloc(32, 0x01))
+        secp256k1.ecdh(pubkey, Buffer.alloc(32, 0x02), undefined, 'md5')
+      }, /^Error: Expected ECDH mode to be one of: sha256,keccak256,x,compressed,uncompressed$/)
+
+      // shared point of private key 0x00..01 and generator is generator
+      const g = Buffer.from(
+        '0479be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798' +
+          '483ada7726a3c4655da4fbfc0e1108a8fd17b448a68554199c47d08ffb10d4b8',
+        'hex'
+      )
+      const seckey = Buffer.alloc(32)
+      seckey[31] = 0x01
+      const expected = {
+        sha256:
+          '0f715baf5d4c2ed329785cef29e562f73488c8a2bb9dbc5700b361d54b9b0554',
+        keccak256:
+          'aa61b794ba668ff67c7b8d037034adcca06964c0dffdb3eae70e8666faa5a63d',
+        x: g.slice(1, 33).toString('hex'),
+        compressed: '02' + g.slice(1, 33).toString('hex'),
+        uncompressed: g.toString('hex'),
+      }
+      for (const [mode, secret] of Object.entries(expected)) {
+        const output = secp256k1.ecdh(g, seckey, Buffer.alloc, mode)
+        t.same(output.toString('hex'), secret)
+      }
+
+      // custom KDF in JS receives x and y of shared point
+      const other = Buffer.alloc(32, 0x42)
+      const pubkey = secp256k1.publicKeyCreate(Buffer.alloc(32, 0x24), false)
+      const point = secp256k1.ecdh(pubkey, other, undefined, 'uncompressed')
+      const kdf = (x, y) => {
+        return createHash('sha512').update(x).update(y).digest()
+      }
+      const output = secp256k1.ecdh(pubkey, other, undefined, kdf)
+      t.same(output, new Uint8Array(kdf(point.slice(1, 33), point.slice(33))))
+      t.same(
+        secp256k1.ecdh(pubkey, other, undefined, 'sha256'),
+        secp256k1.ecdh(pubkey, other)
+      )
+
+      t.end()
+    })
+
+    t.test(`${prefix}.ecdhPublicKeysMany`, (t) => {
+      const count = 100
+      const seckey = Buffer.alloc(32, 0x5a)
+      const pubkeys = []
+      for (let i = 0; i < count; ++i) {
+        const pubkey = secp256k1.publicKeyCreate(Buffer.alloc(32, i + 1))
+        // every tenth public key is not on curve
+        if (i % 10 === 3) pubkey.fill(0x02, 0, 1).fill(0xff, 1)
+        pubkeys.push(pubkey)
+      }
+      const inputs = Buffer.concat(pubkeys)
+
+      t.throws(() => {
+        secp256k1.ecdhPublicKeysMany(Buffer.alloc(32), inputs, count)
+      }, /^Error: Scalar was invalid \(zero or overflow\)$/)
+
+      for (const mode of ['sha256', 'x', 'uncompressed']) {
+        const single = secp256k1.ecdhPublicKeysMany(
+          seckey,
+          inputs,
+          count,
+          true,
+          mode,
+          Buffer.alloc
+        )
+        const outputlen = single.output.length / count
+        for (let i = 0; i < count; ++i) {
+          const output = single.output.slice(i * outputlen, (i + 1) * outputlen)
+          if (i % 10 === 3) {
+            t.same(single.statuses[i], 1)
+            t.same(output, Buffer.alloc(outputlen))
+          } else {
+            t.same(single.statuses[i], 0)
+            t.same(output, secp256k1.ecdh(pubkeys[i], seckey, Buffer.alloc, mode))
+          }
+        }
+
+        const multi = secp256k1.ecdhPublicKeysMany(
+          seckey,
+          inputs,
+          count,
+          true,
+          mode,
+          Buffer.alloc,
+          4
+        )
+        t.same(multi.statuses, single.statuses)
+        t.same(multi.output, single.output)
+      }
+
+      t.end()
+    })
+
+    // bulk
+    t.test(`${prefix}.privateKeyVerifyMany / publicKeyCreateMany`, (t) => {
+      t.throws(() => {
+        secp256k1.privateKeyVerifyMany(new Uint8Array(64), -1)
+      }, /^Error: Expected count to be a non-negative integer$/)
+
+      t.throws(() => {
+        secp256k1.publicKeyCreateMany(new Uint8Array(42), 2)
+      }, /^Error: Expected private keys to be Uint8Array with length 64$/)
+
+      const seckeys = Buffer.concat([
+        Buffer.alloc(32, 0x01),
+        Buffer.alloc(32, 0x00),
+        Buffer.alloc(32, 0x02),
+      ])
+      t.same(secp256k1.privateKeyVerifyMany(seckeys, 3), new Uint8Array([0, 1, 0]))
+
+      const { output, statuses } = secp256k1.publicKeyCreateMany(seckeys, 3)
+      t.same(statuses, new Uint8Array([0, 1, 0]))
+      for (const i of [0, 2]) {
+        const seckey = seckeys.slice(i * 32, (i + 1) * 32)
+        const pubkey = secp256k1.publicKeyCreate(seckey, true)
+        t.same(output.slice(i * 33, (i + 1) * 33), pubkey)
+      }
+
+      t.end()
+    })
+
+    t.test(`${prefix}.publicKeyCreateMany with few groups`, (t) => {
+      // 64 points per inversion, so 150 keys is 3 groups
+      const seckeys = Buffer.alloc(150 * 32)
+      for (let i = 0; i < 150; ++i) seckeys[i * 32 + 31] = i
+      const { output, statuses } = secp256k1.publicKeyCreateMany(
+        seckeys,
+        150,
+        false
+      )
+
+      t.equal(statuses[0], 1)
+      for (let i = 1; i < 150; ++i) {
+        const seckey = seckeys.slice(i * 32, (i + 1) * 32)
+        const pubkey = secp256k1.publicKeyCreate(seckey, false)
+        t.equal(statuses[i], 0)
+        t.same(output.slice(i * 65, (i + 1) * 65), pubkey)
+      }
+
+      t.end()
+    })
+
+    t.test(`${prefix}.publicKeyCreateRange`, (t) => {
+      t.throws(() => {
+        secp256k1.publicKeyCreateRange(new Uint8Array(42), 2)
+      }, /^Error: Expected private key to be Uint8Array with length 32$/)
+
+      t.throws(() => {
+        secp256k1.publicKeyCreateRange(new Uint8Array(32), 2)
+      }, /^Error: Private Key is invalid$/)
+
+      const toSeckey = (x) => {
+        return Buffer.from(x.toString(16).padStart(64, '0'), 'hex')
+      }
+
+      const start = 0xfffffff0
+      const range = secp256k1.publicKeyCreateRange(toSeckey(start), 100)
+      t.same(range.statuses, new Uint8Array(100))
+      for (let i = 0; i < 100; ++i) {
+        const pubkey = secp256k1.publicKeyCreate(toSeckey(start + i))
+        t.same(range.output.slice(i * 33, (i + 1) * 33), pubkey)
+      }
+
+      // n - 2, n - 1, 0 (invalid), 1
+      const seckey = Buffer.from(
+        'fffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd036413f',
+        'hex'
+      )
+      const wrap = secp256k1.publicKeyCreateRange(seckey, 4)
+      t.same(wrap.statuses, new Uint8Array([0, 0, 1, 0]))
+      t.same(wrap.output.slice(66, 99), new Uint8Array(33))
+      t.same(wrap.output.slice(99, 132), secp256k1.publicKeyCreate(toSeckey(1)))
+
+      t.end()
+    })
+
+    t.test(`${prefix}.ecdsaSignMany / ecdsaRecoverMany`, (t) => {
+      const items = [0x01, 0x00, 0x03].map((x, i) => ({
+        msg32: Buffer.alloc(32, 0x10 + i),
+        seckey: Buffer.alloc(32, x),
+      }))
+      const inputs = Buffer.concat(
+        [].concat(...items.map((x) => [x.msg32, x.seckey]))
+      )
+
+      const signed = secp256k1.ecdsaSignMany(inputs, 3, Buffer.alloc)
+      t.same(signed.statuses, new Uint8Array([0, 1, 0]))
+
+      const records = []
+      for (const [i, { msg32, seckey }] of items.entries()) {
+        const record = signed.output.slice(i * 65, (i + 1) * 65)
+        records.push(record, msg32)
+        if (i === 1) continue
+
+        const { signature, recid } = secp256k1.ecdsaSign(msg32, seckey)
+        t.same(new Uint8Array(record.slice(0, 64)), signature)
+        t.same(record[64], recid)
+      }
+
+      const recovered = secp256k1.ecdsaRecoverMany(Buffer.concat(records), 3)
+      t.same(recovered.statuses[0], 0)
+      t.notSame(recovered.statuses[1], 0)
+      t.same(recovered.statuses[2], 0)
+      const pubkey = secp256k1.publicKeyCreate(items[2].seckey)
+      t.same(recovered.output.slice(66, 99), pubkey)
+
+      t.end()
+    })
+
+    t.test(`${prefix}.ecdsaSignMessage / ecdsaVerifyMessage`, (t) => {
+      t.throws(() => {
+        const seckey = Buffer.alloc(32, 0x01)
+        secp256k1.ecdsaSignMessage(Buffer.from('abc'), seckey, 'sha1')
+      }, /^Error: Expected hash to be one of: sha256,sha256d,keccak256$/)
+
+      const sha256 = (data) => createHash('sha256').update(data).digest()
+      const msg = Buffer.from('abc')
+      const digests = {
+        sha256: sha256(msg),
+        sha256d: sha256(sha256(msg)),
+        keccak256: Buffer.from(
+          '4e03657aea45a94fc7d47ba826c8d667c0d1e6e33a64a036ec44f58fa12d6c45',
+          'hex'
+        ),
+      }
+
+      const seckey = Buffer.alloc(32, 0x02)
+      const pubkey = secp256k1.publicKeyCreate(seckey)
+      for (const [hash, digest] of Object.entries(digests)) {
+        const sig = secp256k1.ecdsaSignMessage(msg, seckey, hash)
+        t.same(sig, secp256k1.ecdsaSign(digest, seckey))
+        t.same(secp256k1.ecdsaVerifyMessage(sig.signature, msg, pubkey, hash), true)
+        const other = Buffer.from('abd')
+        t.same(secp256k1.ecdsaVerifyMessage(sig.signature, other, pubkey, hash), false)
+      }
+
+      const sig = secp256k1.ecdsaSignMessage(new Uint8Array(0), seckey)
+      t.same(sig, secp256k1.ecdsaSign(sha256(Buffer.alloc(0)), seckey))
+
+      t.end()
+    })
+
+    t.test(`${prefix}.ecdsaSignMessageMany / ecdsaVerifyMessageMany`, (t) => {
+      t.throws(() => {
+        secp256k1.ecdsaSignMessageMany(null, new Uint8Array(0))
+      }, /^Error: Expected messages to be an Array of Uint8Array$/)
+
+      const count = 32
+      const messages = []
+      const seckeys = []
+      for (let i = 0; i < count; ++i) {
+        messages.push(Buffer.alloc(i * 7, i))
+        seckeys.push(Buffer.alloc(32, i % 8 === 0 ? 0 : i))
+      }
+
+      const signed = secp256k1.ecdsaSignMessageMany(
+        messages,
+        Buffer.concat(seckeys),
+        'sha256d',
+        Buffer.alloc
+      )
+      const statuses = new Uint8Array(count).map((_, i) => (i % 8 === 0 ? 1 : 0))
+      t.same(signed.statuses, statuses)
+
+      const records = []
+      for (let i = 0; i < count; ++i) {
+        const record = signed.output.slice(i * 65, (i + 1) * 65)
+        if (i % 8 === 0) {
+          // zero signature is parsed, but not valid
+          records.push(Buffer.alloc(64), secp256k1.publicKeyCreate(seckeys[1]))
+          continue
+        }
+
+        const { signature, recid } = secp256k1.ecdsaSignMessage(
+          messages[i],
+          seckeys[i],
+          'sha256d'
+        )
+        t.same(new Uint8Array(record.slice(0, 64)), signature)
+        t.same(record[64], recid)
+        records.push(signature, secp256k1.publicKeyCreate(seckeys[i]))
+      }
+
+      const inputs = Buffer.concat(records)
+      const expected = statuses.map((status) => status * 3)
+      for (const threads of [1, 4]) {
+        t.same(
+          secp256k1.ecdsaVerifyMessageMany(messages, inputs, true, 'sha256d', threads),
+          expected
+        )
+      }
+
+      t.end()
+    })
+
+    t.test(`${prefix}.ecdsaRecoverAddress / ecdsaRecoverAddressMany`, (t) => {
+      t.throws(() => {
+        const sig = new Uint8Array(64)
+        secp256k1.ecdsaRecoverAddress(sig, 0, new Uint8Array(32), 'sha1')
+      }, /^Error: Expected address type to be one of: keccak256,hash160,hash160Uncompressed$/)
+
+      // Addresses of private key 0x00..01
+      const seckey = Buffer.alloc(32)
+      seckey[31] = 0x01
+      const expected = {
+        keccak256: '7e5f4552091a69125d5dfcb7b8c2659029395bdf',
+        hash160: '751e76e8199196d454941c45d1b3a323f1433bd6',
+        hash160Uncompressed: '91b24bf9f5288532960ac687abb035127b1d28a5',
+      }
+
+      const msg32 = Buffer.alloc(32, 0x42)
+      const { signature, recid } = secp256k1.ecdsaSign(msg32, seckey)
+      for (const [type, address] of Object.entries(expected)) {
+        const output = secp256k1.ecdsaRecoverAddress(
+          signature,
+          recid,
+          msg32,
+          type,
+          Buffer.alloc
+        )
+        t.same(output.toString('hex'), address)
+      }
+      const output = secp256k1.ecdsaRecoverAddress(signature, recid, msg32)
+      t.same(Buffer.from(output).toString('hex'), expected.keccak256)
+
+      t.throws(() => {
+        const sig = Buffer.alloc(64, 0xff)
+        secp256k1.ecdsaRecoverAddress(sig, 0, msg32)
+      }, /^Error: signature could not be parsed$/)
+
+      const count = 32
+      const records = []
+      for (let i = 0; i < count; ++i) {
+        const { signature, recid } = secp256k1.ecdsaSign(msg32, seckey)
+        // every fourth record has invalid recovery id
+        records.push(signature, Buffer.from([i % 4 === 0 ? 4 : recid]), msg32)
+      }
+      const inputs = Buffer.concat(records)
+      const statuses = new Uint8Array(count).map((_, i) => (i % 4 === 0 ? 1 : 0))
+      for (const threads of [1, 4]) {
+        const result = secp256k1.ecdsaRecoverAddressMany(
+          inputs,
+          count,
+          'hash160',
+          Buffer.alloc,
+          threads
+        )
+        t.same(result.statuses, statuses)
+        t.same(result.output.slice(20, 40).toString('hex'), expected.hash160)
+      }
+
+      t.end()
+    })
+
+    t.test(`${prefix}.ecdsaVerifyMany / ecdsaRecoverMany / ecdhMany with threads`, (t) => {
+      t.throws(() => {
+        secp256k1.ecdsaVerifyMany(new Uint8Array(129), 1, true, 0)
+      }, /^Error: Expected threads to be a positive integer$/)
+
+      const count = 64
+      const seckeys = []
+      const records = []
+      for (let i = 0; i < count; ++i) {
+        const seckey = Buffer.alloc(32, i + 1)
+        const msg32 = Buffer.alloc(32, 0x80 + i)
+        const { signature } = secp256k1.ecdsaSign(msg32, seckey)
+        // every fifth signature is broken
+        if (i % 5 === 0) signature[10] ^= 0xff
+        seckeys.push(seckey)
+        records.push(signature, msg32, secp256k1.publicKeyCreate(seckey))
+      }
+
+      const expected = new Uint8Array(count).map((_, i) => (i % 5 === 0 ? 3 : 0))
+      const inputs = Buffer.concat(records)
+      for (const threads of [1, 4]) {
+        t.same(secp256k1.ecdsaVerifyMany(inputs, count, true, threads), expected)
+      }
+
+      const recoverInputs = Buffer.concat(
+        [].concat(
+          ...seckeys.map((seckey, i) => {
+            const msg32 = records[i * 3 + 1]
+            const { signature, recid } = secp256k1.ecdsaSign(msg32, seckey)
+            return [signature, Buffer.from([recid]), msg32]
+          })
+        )
+      )
+      const recovered = secp256k1.ecdsaRecoverMany(recoverInputs, count)
+      t.same(recovered.statuses, new Uint8Array(count))
+      t.same(recovered.output.slice(0, 33), records[2])
+      for (const threads of [2, 4]) {
+        const result = secp256k1.ecdsaRecoverMany(
+          recoverInputs,
+          count,
+          true,
+          undefined,
+          threads
+        )
+        t.same(result.statuses, recovered.statuses)
+        t.same(result.output, recovered.output)
+      }
+
+      const pubkey = secp256k1.publicKeyCreate(Buffer.alloc(32, 0xaa))
+      const ecdhInputs = Buffer.concat(
+        [].concat(...seckeys.map((seckey) => [pubkey, seckey]))
+      )
+      const single = secp256k1.ecdhMany(ecdhInputs, count, true, Buffer.alloc)
+      const multi = secp256k1.ecdhMany(ecdhInputs, count, true, Buffer.alloc, 4)
+      t.same(single.statuses, new Uint8Array(count))
+      t.same(multi.statuses, single.statuses)
+      t.same(multi.output, single.output)
+      t.same(single.output.slice(32, 64), secp256k1.ecdh(pubkey, seckeys[1]))
+
+      t.end()
+    })
+
+    // async
+    // BIP32 test vector 1
+    const bip32Seed = Buffer.from('000102030405060708090a0b0c0d0e0f', 'hex')
+    const bip32Vector = [
+      {
+        path: 'm',
+        chain: '873dff81c02f525623fd1fe5167eac3a55a049de3d314bb42ee227ffed37d508',
+        seckey:
+          'e8f32e723decf4051aefac8e2c93c9c5b214313817cdb01a1494b917c8436b35',
+        pubkey:
+          '0339a36013301597daef41fbe593a02cc513d0b55527ec2df1050e2e8ff49c85c2',
+      },
+      {
+        path: "m/0'",
+        chain: '47fdacbd0f1097043b78c63c20c34ef4ed9a111d980047ad16282c7ae6236141',
+        pubkey:
+          '035a784662a4a20a65bf6aab9ae98a6c068a81c52e4b032c0fb5400c706cfccc56',
+      },
+      {
+        path: "m/0'/1",
+        chain: '2a7857631386ba23dacac34180dd1983734e444fdbf774041578e9b6adb37c19',
+        pubkey:
+          '03501e454bf00751f24b1b489aa925215d66af2234e3891c3b21a52bedb3cd711c',
+      },
+      {
+        path: 'm/0h/1/2h/2/1000000000',
+        chain: 'c783e67b921d2beb8f6b389cc646d7263b4145701dadd2161548a8b078e65e9e',
+        seckey:
+          '471b76e389e528d6de6d816857e012c5455051cad6660850e58372a6c3e6e7c8',
+        pubkey:
+          '022a471424da5e657499d1ff51cb43c47481a03b1e77f951fe64cec9f5a48f7011',
+      },
+    ]
+
+    t.test(`${prefix}.bip32FromSeed / bip32Derive`, (t) => {
+      t.throws(() => {
+        secp256k1.bip32FromSeed(new Uint8Array(15))
+      }, /^Error: Expected seed length to be within interval \[16, 64\]$/)
+
+      const master = secp256k1.bip32FromSeed(bip32Seed)
+      for (const { path, chain, seckey, pubkey } of bip32Vector) {
+        const xpub = secp256k1.bip32Derive(master, path, true)
+        t.equal(Buffer.from(xpub).toString('hex'), chain + pubkey, path)
+        if (seckey === undefined) continue
+
+        const xprv = secp256k1.bip32Derive(master, path)
+        t.equal(Buffer.from(xprv).toString('hex'), chain + seckey, path)
+      }
+
+      // Public parent: m/0' -> m/0'/1
+      const xpub = secp256k1.bip32Derive(master, [0x80000000], true)
+      const child = secp256k1.bip32Derive(xpub, 'm/1')
+      t.equal(
+        Buffer.from(child).toString('hex'),
+        bip32Vector[2].chain + bip32Vector[2].pubkey
+      )
+
+      t.throws(() => {
+        secp256k1.bip32Derive(xpub, "m/1'")
+      }, /^Error: Private extended key required for hardened index or private output$/)
+      t.throws(() => {
+        secp256k1.bip32Derive(xpub, 'm/1', false)
+      }, /^Error: Private extended key required for hardened index or private output$/)
+      t.throws(() => {
+        secp256k1.bip32Derive(new Uint8Array(65), 'm/1')
+      }, /^Error: Extended key is invalid$/)
+      t.throws(() => {
+        secp256k1.bip32Derive(master, 'm/1/x')
+      }, /^Error: Expected path index, got "x"$/)
+
+      t.end()
+    })
+
+    t.test(`${prefix}.bip32DeriveRange`, (t) => {
+      const master = secp256k1.bip32FromSeed(bip32Seed)
+      const xpub = secp256k1.bip32Derive(master, "m/0'", true)
+
+      // 150 children is 3 groups, with and without threads
+      for (const [xkey, publicOutput] of [
+        [master, false],
+        [master, true],
+        [xpub, true],
+      ]) {
+        const len = publicOutput ? 65 : 64
+        const { output, statuses } = secp256k1.bip32DeriveRange(
+          xkey,
+          1000,
+          150,
+          publicOutput
+        )
+        t.same(statuses, new Uint8Array(150))
+        for (let i = 0; i < 150; i += 7) {
+          const child = secp256k1.bip32Derive(xkey, [1000 + i], publicOutput)
+          t.same(output.slice(i * len, (i + 1) * len), child)
+        }
+
+        const threaded = secp256k1.bip32DeriveRange(
+          xkey,
+          1000,
+          150,
+          publicOutput,
+          undefined,
+          3
+        )
+        t.same(threaded.output, output)
+      }
+
+      // Hardened indices are not available for public parent
+      const start = 0x7ffffffe
+      const cross = secp256k1.bip32DeriveRange(xpub, start, 4)
+      t.same(cross.statuses, new Uint8Array([0, 0, 2, 2]))
+      t.same(
+        cross.output.slice(65, 130),
+        secp256k1.bip32Derive(xpub, [start + 1])
+      )
+      t.same(cross.output.slice(130), new Uint8Array(130))
+
+      const hardened = secp256k1.bip32DeriveRange(master, start, 4)
+      t.same(hardened.statuses, new Uint8Array(4))
+      t.same(
+        hardened.output.slice(192),
+        secp256k1.bip32Derive(master, [start + 3])
+      )
+
+      // Only hardened children, parent public key is not required
+      const onlyHardened = 0x80000000
+      const pubs = secp256k1.bip32DeriveRange(master, onlyHardened, 2, true)
+      t.same(pubs.statuses, new Uint8Array(2))
+      t.same(
+        pubs.output.slice(65),
+        secp256k1.bip32Derive(master, [onlyHardened + 1], true)
+      )
+
+      t.throws(() => {
+        secp256k1.bip32DeriveRange(new Uint8Array(65), 0, 2)
+      }, /^Error: Extended key is invalid$/)
+      t.throws(() => {
+        secp256k1.bip32DeriveRange(master, 0xffffffff, 2)
+      }, /^Error: Expected index \+ count to be not greater than 2\^32$/)
+
+      t.end()
+    })
+
+    t.test(`${prefix}.ecdsaSignAsync / ecdsaVerifyAsync fixtures`, async (t) => {
+      const seckey = Buffer.alloc(32, 0x01)
+      const msg32 = Buffer.alloc(32, 0x02)
+      const pubkey = secp256k1.publicKeyCreate(seckey, true, Buffer.alloc)
+
+      const expected = secp256k1.ecdsaSign(msg32, seckey, Buffer.alloc)
+      const obj = await secp256k1.ecdsaSignAsync(msg32, seckey, Buffer.alloc)
+      t.same(obj.signature.toString('hex'), expected.signature.toString('hex'))
+      t.same(obj.recid, expected.recid)
+
+      t.same(await secp256k1.ecdsaVerifyAsync(obj.signature, msg32, pubkey), true)
+      const other = Buffer.alloc(32, 0x03)
+      t.same(await secp256k1.ecdsaVerifyAsync(obj.signature, other, pubkey), false)
+
+      try {
+        await secp256k1.ecdsaVerifyAsync(null, msg32, pubkey)
+        t.fail('should throw')
+      } catch (err) {
+        t.same(err.message, 'Expected signature to be Uint8Array')
+      }
+
+      t.end()
+    })
+
+    t.test(`${prefix}.ecdsaRecoverAsync / ecdhAsync fixtures`, async (t) => {
+      const seckey = Buffer.alloc(32, 0x01)
+      const msg32 = Buffer.alloc(32, 0x02)
+      const pubkey = secp256k1.publicKeyCreate(seckey, false, Buffer.alloc)
+      const { signature, recid } = secp256k1.ecdsaSign(msg32, seckey)
+
+      const recovered = await Promise.all([
+        secp256k1.ecdsaRecoverAsync(signature, recid, msg32, false),
+        secp256k1.ecdsaRecoverAsync(signature, recid, msg32, false),
+      ])
+      for (const result of recovered) t.same(result, new Uint8Array(pubkey))
+
+      const secret = await secp256k1.ecdhAsync(pubkey, seckey, Buffer.alloc)
+      t.same(secret, secp256k1.ecdh(pubkey, seckey, Buffer.alloc))
+
+      t.end()
+    })
+
+    // streaming verification
+    const createStreamRecords = (count) => {
+      const records = []
+      for (let i = 0; i < count; ++i) {
+        const seckey = Buffer.alloc(32, (i % 250) + 1)
+        const msg32 = Buffer.alloc(32, i % 256)
+        const { signature } = secp256k1.ecdsaSign(msg32, seckey, Buffer.alloc)
+        // every seventh signature is broken
+        if (i % 7 === 0) signature[10] ^= 0xff
+        const pubkey = secp256k1.publicKeyCreate(seckey, i % 3 !== 0)
+        records.push({ signature, msg32, pubkey })
+      }
+      return records
+    }
+
+    t.test(`${prefix}.ecdsaVerifyManyAsync`, async (t) => {
+      const records = createStreamRecords(32).filter((record) => {
+        return record.pubkey.length === 33
+      })
+      const inputs = Buffer.concat(
+        [].concat(...records.map((r) => [r.signature, r.msg32, r.pubkey]))
+      )
+      const expected = secp256k1.ecdsaVerifyMany(inputs, records.length)
+      const statuses = await secp256k1.ecdsaVerifyManyAsync(
+        inputs,
+        records.length
+      )
+      t.same(statuses, expected)
+      t.same(await secp256k1.ecdsaVerifyManyAsync(new Uint8Array(0), 0), [])
+
+      t.end()
+    })
+
+    t.test(`${prefix}.ecdsaVerifyManyAsync with threads`, async (t) => {
+      const records = createStreamRecords(300).filter((record) => {
+        return record.pubkey.length === 33
+      })
+      const inputs = Buffer.concat(
+        [].concat(...records.map((r) => [r.signature, r.msg32, r.pubkey]))
+      )
+      const expected = secp256k1.ecdsaVerifyMany(inputs, records.length)
+      for (const threads of [2, 4]) {
+        const statuses = await secp256k1.ecdsaVerifyManyAsync(
+          inputs,
+          records.length,
+          true,
+          threads
+        )
+        t.same(statuses, expected)
+      }
+
+      t.end()
+    })
+
+    // Pool busy with one batch: other batches computed on own thread instead
+    // of waiting (sync call would block event loop)
+    t.test(`${prefix}.ecdsaVerifyMany with threads at same time`, async (t) => {
+      const records = createStreamRecords(300).filter((record) => {
+        return record.pubkey.length === 33
+      })
+      const inputs = Buffer.concat(
+        [].concat(...records.map((r) => [r.signature, r.msg32, r.pubkey]))
+      )
+      const count = records.length
+      const expected = secp256k1.ecdsaVerifyMany(inputs, count)
+
+      const pending = [
+        secp256k1.ecdsaVerifyManyAsync(inputs, count, true, 4),
+        secp256k1.ecdsaVerifyManyAsync(inputs, count, true, 4),
+      ]
+      const sync = secp256k1.ecdsaVerifyMany(inputs, count, true, 4)
+      t.same(sync, expected)
+      for (const statuses of await Promise.all(pending)) {
+        t.same(statuses, expected)
+      }
+
+      t.end()
+    })
+
+    t.test(`${prefix}.ecdsaVerifyStream`, async (t) => {
+      t.throws(() => {
+        secp256k1.ecdsaVerifyStream({ batchSize: 0 })
+      }, /^Error: Expected batchSize to be a positive integer$/)
+
+      const records = createStreamRecords(300)
+      for (const options of [
+        { batchSize: 1 },
+        { batchSize: 64, deadline: 0 },
+        { batchSize: 1000, deadline: 5, concurrency: 4 },
+      ]) {
+        const stream = secp256k1.ecdsaVerifyStream(options)
+        const results = []
+        stream.on('data', (result) => results.push(result))
+        const finished = new Promise((resolve, reject) => {
+          stream.on('end', resolve)
+          stream.on('error', reject)
+        })
+        for (const record of records) stream.write(record)
+        stream.end()
+        await finished
+
+        t.same(results.length, records.length)
+        t.true(results.every(({ record }, i) => record === records[i]))
+        t.true(results.every(({ valid }, i) => valid === (i % 7 !== 0)))
+      }
+
+      const stream = secp256k1.ecdsaVerifyStream()
+      const error = new Promise((resolve) => stream.on('error', resolve))
+      stream.write({ signature: null })
+      t.same((await error).message, 'Expected signature to be Uint8Array')
+
+      t.end()
+    })
+
+    // Deadline which fires while the oldest batch is in flight does not
+    // dispatch over concurrency, records wait for the oldest batch
+    t.test(`${prefix}.ecdsaVerifyStream concurrency on deadline`, async (t) => {
+      let outstanding = 0
+      let maxOutstanding = 0
+      const counted = Object.create(secp256k1)
+      counted.ecdsaVerifyManyAsync = async (...args) => {
+        outstanding += 1
+        maxOutstanding = Math.max(maxOutstanding, outstanding)
+        try {
+          await new Promise((resolve) => setTimeout(resolve, 2))
+          return await secp256k1.ecdsaVerifyManyAsync(...args)
+        } finally {
+          outstanding -= 1
+        }
+      }
+
+      const records = createStreamRecords(100)
+      const options = { batchSize: 8, deadline: 1, concurrency: 1 }
+      const stream = new ECDSAVerifyStream(counted, options)
+      const results = []
+      stream.on('data', (result) => results.push(result))
+      const finished = new Promise((resolve, reject) => {
+        stream.on('end', resolve)
+        stream.on('error', reject)
+      })
+      for (let i = 0; i < records.length; ++i) {
+        if (i % 3 === 0) await new Promise((resolve) => setTimeout(resolve, 1))
+        stream.write(records[i])
+      }
+      stream.end()
+      await finished
+
+      t.same(maxOutstanding, 1)
+      t.same(results.length, records.length)
+      t.true(results.every(({ record }, i) => record === records[i]))
+      t.true(results.every(({ valid }, i) => valid === (i % 7 !== 0)))
+
+      t.end()
+    })
+
+    t.test(`${prefix}.ecdsaVerifyIterable`, async (t) => {
+      const records = createStreamRecords(200)
+      async function * source () {
+        for (let i = 0; i < records.length; ++i) {
+          if (i % 50 === 0) await new Promise((r) => setImmediate(r))
+          yield records[i]
+        }
+      }
+
+      let i = 0
+      const options = { batchSize: 16, deadline: 1 }
+      const results = secp256k1.ecdsaVerifyIterable(source(), options)
+      for await (const result of results) {
+        t.true(result.record === records[i])
+        t.same(result.valid, i % 7 !== 0)
+        i += 1
+      }
+      t.same(i, records.length)
+
+      t.end()
+    })
+
+    // parsed public keys
+    t.test(`${prefix}.publicKeyParse`, (t) => {
+      t.throws(() => {
+        secp256k1.publicKeyParse(new Uint8Array(42))
+      }, /^Error: Expected public key to be Uint8Array with length \[33, 65]$/)
+
+      t.throws(() => {
+        secp256k1.publicKeyParse(new Uint8Array(33))
+      }, /^Error: Public Key could not be parsed$/)
+
+      const seckey = Buffer.alloc(32, 0x01)
+      const msg32 = Buffer.alloc(32, 0x02)
+      const pubkey = secp256k1.publicKeyCreate(seckey, false, Buffer.alloc)
+      const { signature } = secp256k1.ecdsaSign(msg32, seckey)
+
+      const parsed = secp256k1.publicKeyParse(pubkey)
+      t.true(parsed instanceof secp256k1.PublicKey)
+      t.same(secp256k1.publicKeyConvert(parsed, false), new Uint8Array(pubkey))
+      t.same(secp256k1.ecdsaVerify(signature, msg32, parsed), true)
+      t.same(secp256k1.ecdh(parsed, seckey), secp256k1.ecdh(pubkey, seckey))
+
+      t.end()
+    })
+
+    // handles created before and after addon loaded (and unloaded) by other
+    // env should be accepted
+    t.test(`${prefix}.handles with Worker`, async (t) => {
+      let Worker
+      try {
+        Worker = require('worker_threads').Worker
+      } catch (err) {
+        t.skip('worker_threads are not available')
+        return t.end()
+      }
+
+      const seckey = Buffer.alloc(32, 0x01)
+      const msg32 = Buffer.alloc(32, 0x02)
+      const pubkey = secp256k1.publicKeyCreate(seckey)
+      const { signature } = secp256k1.ecdsaSign(msg32, seckey)
+      const parsed = secp256k1.publicKeyParse(pubkey)
+      const verifier = secp256k1.ecdsaVerifierCreate(pubkey)
+
+      const code = `
+        const { parentPort } = require('worker_threads')
+        const fcrypto = require(${JSON.stringify(require.resolve('../'))})
+        fcrypto.load('${type}', { secp256k1: true }).then(({ secp256k1 }) => {
+          const pubkey = secp256k1.publicKeyCreate(Buffer.alloc(32, 1))
+          secp256k1.ecdsaVerifierCreate(secp256k1.publicKeyParse(pubkey))
+          parentPort.postMessage('loaded')
+        })
+      `
+      const worker = new Worker(code, { eval: true })
+      const message = await new Promise((resolve, reject) => {
+        worker.once('message', resolve)
+        worker.once('error', reject)
+      })
+      t.same(message, 'loaded')
+      t.same(secp256k1.ecdsaVerify(signature, msg32, parsed), true)
+      t.same(secp256k1.ecdsaVerify(signature, msg32, verifier), true)
+
+      await new Promise((resolve) => {
+        worker.once('exit', resolve)
+        worker.terminate()
+      })
+      const parsedAfter = secp256k1.publicKeyParse(pubkey)
+      const verifierAfter = secp256k1.ecdsaVerifierCreate(pubkey)
+      for (const key of [parsed, parsedAfter, verifier, verifierAfter]) {
+        t.same(secp256k1.ecdsaVerify(signature, msg32, key), true)
+      }
+      secp256k1.ecdsaVerifierDestroy(verifier)
+      secp256k1.ecdsaVerifierDestroy(verifierAfter)
+
+      t.end()
+    })
+
+    t.test(`${prefix}.publicKeyCacheStats`, async (t) => {
+      t.same(secp256k1.publicKeyCacheStats(), null)
+
+      const options = { secp256k1: { publicKeyCacheSize: 2 } }
+      const cached = (await fcrypto.load(type, options)).secp256k1
+
+      const msg32 = Buffer.alloc(32, 0x02)
+      const items = [0x01, 0x02, 0x03].map((x) => {
+        const seckey = Buffer.alloc(32, x)
+        const pubkey = cached.publicKeyCreate(seckey)
+        const { signature } = cached.ecdsaSign(msg32, seckey)
+        return { pubkey, signature }
+      })
+
+      for (const i of [0, 0, 1, 0, 2, 1]) {
+        const { pubkey, signature } = items[i]
+        t.same(cached.ecdsaVerify(signature, msg32, pubkey), true)
+      }
+      // key 1 evicted by key 2, so last verify is a miss
+      t.same(cached.publicKeyCacheStats(), {
+        size: 2,
+        capacity: 2,
+        hits: 2,
+        misses: 4,
+      })
+
+      t.end()
+    })
+
+    // stats
+    t.test(`${prefix}.statsEnable / statsSnapshot / statsReset`, async (t) => {
+      t.throws(() => {
+        secp256k1.statsEnable(1)
+      }, /^Error: Expected enabled to be a boolean$/)
+
+      const options = { secp256k1: { stats: true } }
+      const other = (await fcrypto.load(type, options)).secp256k1
+      t.same(other.statsSnapshot(), {})
+
+      const seckey = Buffer.alloc(32, 0x01)
+      const msg32 = Buffer.alloc(32, 0x02)
+      const pubkey = other.publicKeyCreate(seckey)
+      const { signature } = other.ecdsaSign(msg32, seckey)
+      t.same(other.ecdsaVerify(signature, msg32, pubkey), true)
+      t.same(other.ecdsaVerify(signature, Buffer.alloc(32), pubkey), false)
+      t.throws(() => {
+        other.ecdsaVerify(signature, msg32, Buffer.alloc(33))
+      }, /^Error: Public Key could not be parsed$/)
+      t.same(await other.ecdsaVerifyAsync(signature, msg32, pubkey), true)
+
+      // async method counted once, even if it calls sync one
+      const snapshot = other.statsSnapshot()
+      t.same(Object.keys(snapshot).sort(), [
+        'ecdsaSign',
+        'ecdsaVerify',
+        'ecdsaVerifyAsync',
+        'publicKeyCreate',
+      ])
+      t.same(snapshot.ecdsaVerifyAsync.codes, { 0: 1 })
+
+      const { calls, codes, latency } = snapshot.ecdsaVerify
+      t.same(calls, 3)
+      t.same(codes, { 0: 1, 2: 1, 3: 1 })
+      t.same(latency.buckets.length, 40)
+      t.same(latency.buckets.reduce((a, b) => a + b), 3)
+      t.true(latency.sum > 0)
+
+      other.statsEnable(false)
+      other.ecdsaVerify(signature, msg32, pubkey)
+      t.same(other.statsSnapshot().ecdsaVerify.calls, 3)
+
+      other.statsReset()
+      t.same(other.statsSnapshot(), {})
+
+      t.end()
+    })
+
+    // staging
+    t.test(`${prefix}.stagingCreate / *Staged`, (t) => {
+      t.throws(() => {
+        secp256k1.stagingCreate(0)
+      }, /^Error: Expected size to be a positive integer$/)
+
+      // seckey 32 | msg32 32 | sig 64 | pubkey 65 | recovered 65 | secret 32
+      const staging = secp256k1.stagingCreate(290)
+      t.true(staging instanceof secp256k1.Staging)
+      t.same(staging.length, 290)
+
+      const seckey = Buffer.alloc(32, 0x01)
+      const msg32 = Buffer.alloc(32, 0x02)
+      staging.subarray(0, 32).set(seckey)
+      staging.subarray(32, 32).set(msg32)
+
+      secp256k1.publicKeyCreateStaged(staging, 128, 0, false)
+      const pubkey = secp256k1.publicKeyCreate(seckey, false)
+      t.same(new Uint8Array(staging.subarray(128, 65)), pubkey)
+
+      const recid = secp256k1.ecdsaSignStaged(staging, 64, 32, 0)
+      const expected = secp256k1.ecdsaSign(msg32, seckey)
+      t.same(recid, expected.recid)
+      t.same(new Uint8Array(staging.subarray(64, 64)), expected.signature)
+
+      t.same(secp256k1.ecdsaVerifyStaged(staging, 64, 32, 128, 65), true)
+      staging.subarray(32, 1)[0] ^= 0x01
+      t.same(secp256k1.ecdsaVerifyStaged(staging, 64, 32, 128, 65), false)
+      staging.subarray(32, 1)[0] ^= 0x01
+
+      secp256k1.ecdsaRecoverStaged(staging, 193, 64, recid, 32, false)
+      t.same(new Uint8Array(staging.subarray(193, 65)), pubkey)
+
+      secp256k1.ecdhStaged(staging, 258, 128, 0, 65)
+      const secret = secp256k1.ecdh(pubkey, seckey)
+      t.same(new Uint8Array(staging.subarray(258, 32)), secret)
+
+      t.throws(() => {
+        secp256k1.ecdhStaged(staging, 259, 128, 0, 65)
+      }, /^Error: Expected output offset to be in staging bounds$/)
+
+      staging.wipe(0, 64)
+      t.same(new Uint8Array(staging.subarray(0, 64)), new Uint8Array(64))
+
+      staging.free()
+      t.throws(() => {
+        secp256k1.ecdsaSignStaged(staging, 64, 32, 0)
+      }, /^Error: Staging already freed$/)
+
+      t.end()
+    })
+
+    // prepared verifier
+    t.test(`${prefix}.ecdsaVerifierCreate / ecdsaVerifierDestroy`, (t) => {
+      t.throws(() => {
+        secp256k1.ecdsaVerifierCreate(new Uint8Array(33))
+      }, /^Error: Public Key could not be parsed$/)
+
+      t.throws(() => {
+        secp256k1.ecdsaVerifierDestroy(null)
+      }, /^Error: Expected verifier to be ECDSAVerifier$/)
+
+      const msg32 = Buffer.alloc(32, 0x02)
+      for (const compressed of [true, false]) {
+        const seckey = randomBytes(32)
+        const pubkey = secp256k1.publicKeyCreate(seckey, compressed)
+        const verifier = secp256k1.ecdsaVerifierCreate(pubkey)
+        t.true(verifier instanceof secp256k1.ECDSAVerifier)
+
+        for (let i = 0; i < 8; ++i) {
+          const msg32 = randomBytes(32)
+          const { signature } = secp256k1.ecdsaSign(msg32, seckey)
+          t.same(secp256k1.ecdsaVerify(signature, msg32, verifier), true)
+
+          signature[i] ^= 0x01
+          const expected = secp256k1.ecdsaVerify(signature, msg32, pubkey)
+          t.same(secp256k1.ecdsaVerify(signature, msg32, verifier), expected)
+        }
+
+        const { signature } = secp256k1.ecdsaSign(msg32, seckey)
+        const other = Buffer.alloc(32, 0x03)
+        t.same(secp256k1.ecdsaVerify(signature, other, verifier), false)
+
+        secp256k1.ecdsaVerifierDestroy(verifier)
+        t.throws(() => {
+          secp256k1.ecdsaVerify(signature, msg32, verifier)
+        }, /^Error: Verifier already destroyed$/)
+      }
+
+      t.end()
+    })
+
     t.end()
   })
 }
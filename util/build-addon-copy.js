@@ -7,8 +7,14 @@
 const fs = require('fs')
 const path = require('path')
 
-const src = path.join(__dirname, '..', 'build', 'Release', 'addon.node')
-const addonName = `fcrypto-${process.platform}-${process.arch}.node`
-const dest = path.join(__dirname, '..', addonName)
-fs.copyFileSync(src, dest)
-console.log(`Copied to ${addonName}`)
+// Variants for CPU features, see `addon_variant` in binding.gyp
+for (const suffix of ['', '-bmi2', '-avx2']) {
+  const name = `addon${suffix}.node`
+  const src = path.join(__dirname, '..', 'build', 'Release', name)
+  if (suffix !== '' && !fs.existsSync(src)) continue
+
+  const addonName = `fcrypto-${process.platform}-${process.arch}${suffix}.node`
+  const dest = path.join(__dirname, '..', addonName)
+  fs.copyFileSync(src, dest)
+  console.log(`Copied to ${addonName}`)
+}
@@ -31,7 +31,22 @@ function getContent (buffer) {
 const text =
   '${buffer.toString('base64')}'
 
-module.exports = new Promise((resolve) => resolve(base64.toByteArray(text)))
+// Only base variant bundled for browsers
+function readCode (name = 'fcrypto') {
+  if (name !== 'fcrypto') {
+    return Promise.reject(new Error(\`WebAssembly file \${name} not bundled\`))
+  }
+
+  return new Promise((resolve) => resolve(base64.toByteArray(text)))
+}
+
+// Compiled module cached by loader, so text decoded only once
+async function compile (name = 'fcrypto') {
+  return WebAssembly.compile(await readCode(name))
+}
+
+module.exports = readCode
+module.exports.compile = compile
 `
 }
 